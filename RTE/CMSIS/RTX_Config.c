@@ -25,8 +25,6 @@
  * -----------------------------------------------------------------------------
  */
 
-#include <stdio.h>
-
 #include "cmsis_compiler.h"
 #include "rtx_os.h"
  
@@ -34,17 +32,7 @@
 __WEAK __NO_RETURN void osRtxIdleThread (void *argument) {
   (void)argument;
 
-  for (;;)
-    {
-        osDelay(1000);
-        printf("\r\\");
-        osDelay(1000);
-        printf("\r|");
-        osDelay(1000);
-        printf("\r/");
-        osDelay(1000);
-        printf("\r-");
-    }
+  for (;;) {}
 }
  
 // OS Error Callback function
@@ -0,0 +1,32 @@
+#include "../rtt/SEGGER_RTT.h"
+
+#include "dlog.h"
+
+#ifndef DLOG_BUFFER_SIZE
+    #define DLOG_BUFFER_SIZE 1024 ///< Size of the binary log up-buffer in bytes
+#endif
+
+namespace dlog
+{
+
+static char buf[DLOG_BUFFER_SIZE];
+
+std::atomic<uint32_t> dropped;
+
+void init(void)
+{
+    SEGGER_RTT_ConfigUpBuffer(channel, "dlog", buf, sizeof(buf), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    write(id_sync, os::kernel::get_sys_timer_freq());
+}
+
+void flush_dropped(void)
+{
+    // Claimed at once so concurrent flushes do not report it twice, given back if the write fails
+    const uint32_t cnt = dropped.exchange(0U, std::memory_order_relaxed);
+    if (cnt != 0U && !write(id_dropped, cnt))
+    {
+        dropped.fetch_add(cnt, std::memory_order_relaxed);
+    }
+}
+
+} // namespace dlog
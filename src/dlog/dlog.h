@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+#include "../os/os.h"
+#include "../rtt/RTT_reserve.h"
+
+/// Deferred binary logging.
+/// A record holds only the address of the format string, a system timer timestamp and the raw
+/// arguments; the text is rebuilt on the host by tools/dlog/dlog_decode from the ELF image.
+/// Record layout (little endian, 32-bit words):
+///   id (format string address) | timestamp (os::kernel::get_sys_timer_count) | arguments
+/// Integers up to 32 bits, pointers and enums take one word; 64-bit integers and floating point
+/// values (stored as double) take two words, exactly as the decoder derives from the format string.
+/// `%s` arguments must point to constant strings of the image.
+namespace dlog
+{
+
+/// RTT up-buffer used for binary records.
+constexpr uint32_t channel = 1U;
+
+/// Record identifiers reserved by the logger (format strings never live at these addresses).
+enum id_t : uint32_t
+{
+    id_dropped      = 0U,   ///< Argument: number of records lost because the buffer was full.
+    id_sync         = 1U,   ///< Argument: system timer frequency in hertz.
+};
+
+/// Number of records lost since the last dropped record was emitted.
+extern std::atomic<uint32_t> dropped;
+
+/// Configure the RTT up-buffer and emit the sync record.
+void init(void);
+
+/// Emit the dropped record. The count is kept for the next attempt if the buffer is full.
+void flush_dropped(void);
+
+template <typename T>
+constexpr uint32_t arg_size(void)
+{
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>, "Unsupported log argument type.");
+    return (std::is_floating_point_v<T> || sizeof(T) > sizeof(uint32_t)) ? 8U : 4U;
+}
+
+template <typename T>
+inline void put(rtt::reservation_t &_res, uint32_t &_off, const T _arg)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        const double val = static_cast<double>(_arg);
+        _res.write(_off, &val, sizeof(val));
+    }
+    else if constexpr (std::is_pointer_v<T>)
+    {
+        const uint32_t val = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_arg));
+        _res.write(_off, &val, sizeof(val));
+    }
+    else if constexpr (arg_size<T>() == 8U)
+    {
+        const uint64_t val = static_cast<uint64_t>(_arg);
+        _res.write(_off, &val, sizeof(val));
+    }
+    else
+    {
+        const uint32_t val = static_cast<uint32_t>(_arg);
+        _res.write(_off, &val, sizeof(val));
+    }
+    _off += arg_size<T>();
+}
+
+/// Write one record. The record is dropped (and counted) when the buffer is full.
+/// \param[in]     id            format string address or @ref id_t.
+/// \param[in]     args          raw arguments.
+/// \return true if the record was written.
+template <typename... T>
+inline bool write(const uint32_t _id, const T... _args)
+{
+    constexpr uint32_t size = 2U * sizeof(uint32_t) + (arg_size<T>() + ... + 0U);
+
+    if (dropped.load(std::memory_order_relaxed) != 0U && _id != id_dropped)
+    {
+        flush_dropped();
+    }
+
+    rtt::reservation_t res;
+    if (rtt::reserve(res, channel, size) == 0U)
+    {
+        // A failed dropped record is not a lost record, its count is given back by flush_dropped
+        if (_id != id_dropped)
+        {
+            dropped.fetch_add(1U, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    uint32_t off = 0U;
+    put(res, off, _id);
+    put(res, off, os::kernel::get_sys_timer_count());
+    (put(res, off, _args), ...);
+
+    rtt::commit(res);
+    return true;
+}
+
+} // namespace dlog
+
+/// printf-like deferred log. The format is checked by the compiler but never formatted on the target.
+#define dlog_printf(_s, ...)                                                                        \
+    do                                                                                              \
+    {                                                                                               \
+        static const char dlog_fmt_[] __attribute__((section("dlog.fmt"))) = _s;                   \
+        if (false)                                                                                  \
+        {                                                                                           \
+            printf(_s __VA_OPT__(,) __VA_ARGS__);                                                   \
+        }                                                                                           \
+        dlog::write(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(dlog_fmt_)) __VA_OPT__(,) __VA_ARGS__); \
+    }                                                                                               \
+    while (0)
@@ -23,6 +23,16 @@
 #include <stdio.h>
 
 #include "os/os.h"
+#include "os/chrono.h"
+#include "os/config.h"
+#include "os/thread.h"
+#include "os/idle.h"
+#include "os/isr.h"
+#include "os/load.h"
+#include "os/stack.h"
+#include "os/crash.h"
+#include "os/timestamp.h"
+#include "dlog/dlog.h"
 
 struct arr
 {
@@ -40,7 +50,7 @@ public:
     void runer()
     {
         for (auto &i : arr_.arr) i = 0x55;
-        printf("this addr: %#010x arr addr: %#010x\n", reinterpret_cast<uint32_t>(this), reinterpret_cast<uint32_t>(&arr_));
+        dlog_printf("this addr: %#010x arr addr: %#010x\n", reinterpret_cast<uint32_t>(this), reinterpret_cast<uint32_t>(&arr_));
     }
 };
 
@@ -60,20 +70,47 @@ static arr_exploiter exploiter0 = array;
 static arr_exploiter exploiter2 = arr_exploiter_wrapper<exploiter2>();
 static arr_exploiter exploiter3 = arr_exploiter_wrapper<exploiter3>();
 
+class hello: public os::thread<hello, 512, os::priority::normal>
+{
+public:
+    void run()
+    {
+        for (;;)
+        {
+            dlog_printf("thread '%s' stack space: %u, idle sleep: %u permille\n", get_name(), get_stack_space(), os::idle::get_stats().sleep_permille());
+            os::delay(std::chrono::seconds(1));
+            os::load::dump();
+        }
+    }
+};
+
+static hello hello_thread;
+
+static_assert(os::config::check<os::config::usage_of<hello>() + os::isr::usage + os::stack::usage>::ok);
+
 int main()
 {
     NVIC_SetPriorityGrouping(3);
     SystemCoreClockUpdate();
 
-    printf("\033[31mC\033[32mO\033[33mL\033[34mO\033[35mR\033[42m \033[0m \033[36mT\033[37mE\033[30m\033[47mS\033[0mT\n"); // Color test
+    os::crash::report();
+    os::timestamp::init();
+
+    // dlog timestamps need the kernel
+    os::kernel::initialize();
+    dlog::init();
+
+    dlog_printf("\033[31mC\033[32mO\033[33mL\033[34mO\033[35mR\033[42m \033[0m \033[36mT\033[37mE\033[30m\033[47mS\033[0mT\n"); // Color test
 
     exploiter0.runer();
     exploiter2.runer();
     exploiter3.runer();
 
-    os::kernel::initialize();
-    // create some threads
+    os::isr::start();
+    os::load::init();
+    os::stack::start();
+    hello_thread.start("hello");
     os::kernel::start();
     
-    printf("Error: kernel not started.\n");
+    dlog_printf("Error: kernel not started.\n");
 }
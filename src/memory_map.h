@@ -0,0 +1,21 @@
+/**
+ * @file memory_map.h
+ * @brief Memory sizes of the supported devices.
+ * Shared by the scatter file (crtp.sct) and the code (OS_CONFIG_STACK_BUDGET in os/config.h), so
+ * only preprocessor directives may appear here.
+ */
+
+#pragma once
+
+#if (0)
+#elif defined(STM32F413xx)
+  #define ROM_SIZE 0x00100000
+  #define RAM_SIZE 0x00050000
+  #define CCM_SIZE 0x00010000
+#elif defined(STM32F411xE)
+  #define ROM_SIZE 0x00040000
+  #define RAM_SIZE 0x00020000
+  #define CCM_SIZE 0
+#else
+  #error Device not supported
+#endif
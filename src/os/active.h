@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+
+#include "os.h"
+#include "chrono.h"
+#include "thread.h"
+#include "queue.h"
+
+namespace os
+{
+
+/// Active object statistics.
+struct active_stats_t
+{
+    uint32_t posted;        ///< Events posted.
+    uint32_t dropped;       ///< Events lost because the queue was full (post timed out).
+    uint32_t dispatched;    ///< Events handled.
+    uint32_t depth_max;     ///< Highest queue depth seen by post right after putting an event.
+    uint32_t time_max;      ///< Longest on_event call in system timer counts.
+    uint32_t time_sum;      ///< Sum of on_event calls in system timer counts (wraps around, use differences).
+};
+
+/// Active object: a thread that owns an event queue and handles one event at a time.
+/// The derived class implements `void on_event(const E &)` (and optionally `void on_start()`,
+/// called once in the thread before the first event); both are called statically, without
+/// virtual functions. Events run to completion: the next event is taken only when on_event
+/// returns, so the state of the object needs no locking as long as only on_event touches it.
+/// `class blinky: public os::active_object<blinky, led_event, 8> { public: void on_event(const led_event &); };`
+/// The thread, its stack and the queue are static (see @ref thread and @ref queue): define the
+/// object at namespace scope, create it with @ref start and send events with @ref post.
+/// \tparam _derived     derived class.
+/// \tparam E            event type (trivially copyable, copied into the queue).
+/// \tparam N            queue depth in events.
+/// \tparam _thread_prio thread priority.
+/// \tparam _stack_size  thread stack size in bytes.
+template <class _derived, class E, uint32_t N, priority _thread_prio = priority::normal, uint32_t _stack_size = OS_STACK_SIZE>
+class active_object: public thread<_derived, _stack_size, _thread_prio>
+{
+private:
+    queue<E, N> queue_;
+
+    std::atomic<uint32_t> posted_;
+    std::atomic<uint32_t> dropped_;
+    std::atomic<uint32_t> dispatched_;
+    std::atomic<uint32_t> depth_max_;
+    std::atomic<uint32_t> time_max_;
+    std::atomic<uint32_t> time_sum_;
+
+    /// Raise a maximum (lock-free, safe against a concurrent reset).
+    static void raise(std::atomic<uint32_t> &_max, const uint32_t _value)
+    {
+        uint32_t max = _max.load(std::memory_order_relaxed);
+        while (_value > max && !_max.compare_exchange_weak(max, _value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+public:
+    using event_t = E;
+    static constexpr uint32_t depth = N;
+
+    constexpr active_object():
+        queue_(), posted_(0U), dropped_(0U), dispatched_(0U), depth_max_(0U), time_max_(0U), time_sum_(0U)
+    {
+    }
+
+    /// Create the queue and start the thread (the kernel must be initialized).
+    /// \param[in]     name          name of the thread and the queue (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t start(const char *_name = nullptr)
+    {
+        if (queue_.create(_name) != sts_t::OK)
+        {
+            return sts_t::err;
+        }
+        return thread<_derived, _stack_size, _thread_prio>::start(_name);
+    }
+
+    /// Post an event (callable from interrupts with timeout 0).
+    /// \param[in]     event         event.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     prio          event priority (higher priority events are handled first).
+    /// \return status code (the event is dropped and counted if it is not OK).
+    sts_t post(const E &_event, const uint32_t _timeout = 0U, const uint8_t _prio = 0U)
+    {
+        const sts_t sts = queue_.put(_event, _timeout, _prio);
+        if (sts != sts_t::OK)
+        {
+            dropped_.fetch_add(1U, std::memory_order_relaxed);
+            return sts;
+        }
+        posted_.fetch_add(1U, std::memory_order_relaxed);
+        raise(depth_max_, queue_.get_count());
+        return sts;
+    }
+
+    /// Post an event.
+    /// \param[in]     event         event.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \param[in]     prio          event priority (higher priority events are handled first).
+    /// \return status code (the event is dropped and counted if it is not OK).
+    template <class _rep, class _period>
+    sts_t post(const E &_event, const std::chrono::duration<_rep, _period> &_timeout, const uint8_t _prio = 0U)
+    {
+        return post(_event, to_ticks(_timeout).count(), _prio);
+    }
+
+    /// \return number of queued events.
+    uint32_t get_count(void)
+    {
+        return queue_.get_count();
+    }
+
+    /// Get the statistics. Every field is read atomically, the set as a whole may be skewed by an
+    /// event dispatched meanwhile.
+    active_stats_t get_stats(void) const
+    {
+        return
+        {
+            .posted     = posted_.load(std::memory_order_relaxed),
+            .dropped    = dropped_.load(std::memory_order_relaxed),
+            .dispatched = dispatched_.load(std::memory_order_relaxed),
+            .depth_max  = depth_max_.load(std::memory_order_relaxed),
+            .time_max   = time_max_.load(std::memory_order_relaxed),
+            .time_sum   = time_sum_.load(std::memory_order_relaxed),
+        };
+    }
+
+    /// Restart the statistics (callable from any thread). The counters only change by atomic
+    /// read-modify-write, so a reset is never overwritten; an event posted or dispatched meanwhile
+    /// is counted before or after it.
+    void reset_stats(void)
+    {
+        posted_.store(0U, std::memory_order_relaxed);
+        dropped_.store(0U, std::memory_order_relaxed);
+        dispatched_.store(0U, std::memory_order_relaxed);
+        depth_max_.store(0U, std::memory_order_relaxed);
+        time_max_.store(0U, std::memory_order_relaxed);
+        time_sum_.store(0U, std::memory_order_relaxed);
+    }
+
+    /// Thread function: the event loop.
+    void run(void)
+    {
+        _derived &self = static_cast<_derived &>(*this);
+        if constexpr (requires { self.on_start(); })
+        {
+            self.on_start();
+        }
+
+        for (;;)
+        {
+            E event;
+            if (queue_.get(event) != sts_t::OK)
+            {
+                continue;
+            }
+
+            const uint32_t start = kernel::get_sys_timer_count();
+            self.on_event(static_cast<const E &>(event));
+            const uint32_t time = kernel::get_sys_timer_count() - start;
+
+            dispatched_.fetch_add(1U, std::memory_order_relaxed);
+            time_sum_.fetch_add(time, std::memory_order_relaxed);
+            raise(time_max_, time);
+        }
+    }
+};
+
+} // namespace os
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <ratio>
+
+#include "RTX_Config.h"
+#include "os.h"
+
+/// Kernel tick time in std::chrono terms.
+/// RTX timeouts are counted in ticks of OS_TICK_FREQ. Durations are converted to ticks at compile
+/// time when they are constants, so `os::delay(20ms)` stays correct when the tick rate changes.
+namespace os
+{
+
+/// Kernel tick period.
+using tick_period = std::ratio<1, OS_TICK_FREQ>;
+
+/// Duration in kernel ticks.
+using ticks = std::chrono::duration<uint32_t, tick_period>;
+
+/// Kernel tick clock (meets the std::chrono Clock requirements).
+/// The tick counter wraps after 2^32 ticks (49.7 days at 1 kHz), so compare time points by their
+/// difference, as RTX does.
+struct clock
+{
+    using rep = ticks::rep;
+    using period = ticks::period;
+    using duration = ticks;
+    using time_point = std::chrono::time_point<clock, duration>;
+
+    static constexpr bool is_steady = true;
+
+    /// \return current kernel tick count.
+    static time_point now(void) noexcept
+    {
+        return time_point(duration(kernel::get_tick_count()));
+    }
+};
+
+/// Convert a duration to a number of ticks of the given frequency.
+/// Rounds up to whole ticks; negative durations give 0. RTX counts a timeout in tick interrupts
+/// and the first one comes anywhere within the current tick, so a wait of n ticks may end up to
+/// one tick early: add a tick where the duration is a minimum. A duration is always finite:
+/// beyond the 32-bit range it is clamped to `forever - 1`, as @ref forever itself would turn it
+/// into an endless wait. Pass @ref forever as tick count to wait without a timeout.
+/// \tparam _freq        tick frequency in hertz.
+template <intmax_t _freq, class _rep, class _period>
+constexpr uint32_t ticks_of(const std::chrono::duration<_rep, _period> &_d)
+{
+    using wide = std::chrono::duration<int64_t, std::ratio<1, _freq>>;
+
+    const int64_t cnt = std::chrono::ceil<wide>(_d).count();
+    if (cnt <= 0)
+    {
+        return 0U;
+    }
+    return (cnt >= static_cast<int64_t>(forever)) ? forever - 1U : static_cast<uint32_t>(cnt);
+}
+
+/// Convert a duration to kernel ticks (see @ref ticks_of).
+template <class _rep, class _period>
+constexpr ticks to_ticks(const std::chrono::duration<_rep, _period> &_d)
+{
+    return ticks(ticks_of<OS_TICK_FREQ>(_d));
+}
+
+/// Wait for Timeout (Time Delay).
+/// \param[in]     d             delay duration, rounded up to whole ticks (may end up to one tick
+///                              early, see @ref ticks_of).
+/// \return status code that indicates the execution status of the function.
+template <class _rep, class _period>
+inline sts_t delay(const std::chrono::duration<_rep, _period> &_d)
+{
+    return delay(to_ticks(_d).count());
+}
+
+/// Wait until specified time.
+/// \param[in]     t             absolute time of @ref clock.
+/// \return status code that indicates the execution status of the function.
+inline sts_t delay_until(const clock::time_point &_t)
+{
+    return delay_until(_t.time_since_epoch().count());
+}
+
+// Exact rates, rounding up and clamping
+static_assert(ticks_of<1000>(std::chrono::seconds(1)) == 1000U);
+static_assert(ticks_of<100>(std::chrono::milliseconds(15)) == 2U);
+static_assert(ticks_of<1000>(std::chrono::microseconds(1500)) == 2U);
+static_assert(ticks_of<1000>(std::chrono::duration<double>(0.0015)) == 2U);
+static_assert(ticks_of<1000>(std::chrono::milliseconds(-5)) == 0U);
+static_assert(ticks_of<1000>(std::chrono::milliseconds(0xFFFFFFFEU)) == 0xFFFFFFFEU);
+static_assert(ticks_of<1000>(std::chrono::milliseconds(0xFFFFFFFFU)) == forever - 1U);
+static_assert(ticks_of<1000>(std::chrono::hours(24 * 50)) == forever - 1U);
+static_assert(ticks_of<32768>(std::chrono::milliseconds(1000)) == 32768U);
+
+// Round trip: ticks -> finer unit (truncated) -> ticks is exact, also for non-decimal rates
+static_assert(ticks_of<1024>(std::chrono::floor<std::chrono::microseconds>(std::chrono::duration<uint32_t, std::ratio<1, 1024>>(1))) == 1U);
+static_assert(ticks_of<1024>(std::chrono::floor<std::chrono::nanoseconds>(std::chrono::duration<uint32_t, std::ratio<1, 1024>>(1000))) == 1000U);
+static_assert(ticks_of<300>(std::chrono::floor<std::chrono::microseconds>(std::chrono::duration<uint32_t, std::ratio<1, 300>>(7))) == 7U);
+static_assert(to_ticks(std::chrono::floor<std::chrono::nanoseconds>(ticks(12345))) == ticks(12345));
+
+// The tick count covers the requested duration
+static_assert(to_ticks(std::chrono::microseconds(1)) >= std::chrono::microseconds(1));
+static_assert(to_ticks(std::chrono::milliseconds(333)) >= std::chrono::milliseconds(333));
+
+} // namespace os
@@ -0,0 +1,40 @@
+#include "os.h"
+#include "config.h"
+#include "misc.h"
+
+namespace os::config
+{
+
+/// Objects started so far, guarded by the kernel lock.
+static usage_t total;
+
+bool add(const usage_t &_usage, const char *_name)
+{
+    const sts_t lock = kernel::lock();
+    const usage_t sum = total + _usage;
+    const bool ok = fits(sum);
+    if (ok)
+    {
+        total = sum;
+    }
+    kernel::restore_lock(lock);
+
+    if (!ok)
+    {
+        printerr("'%s' exceeds the kernel configuration: %u threads (OS_THREAD_LIBSPACE_NUM %u), "
+                 "%u stack bytes (OS_CONFIG_STACK_BUDGET %u), %u ISR FIFO entries (OS_ISR_FIFO_QUEUE %u).\n",
+                 (_name != nullptr) ? _name : "-", sum.threads, OS_THREAD_LIBSPACE_NUM, sum.stack,
+                 OS_CONFIG_STACK_BUDGET, sum.isr_fifo, OS_ISR_FIFO_QUEUE);
+    }
+    return ok;
+}
+
+usage_t get_usage(void)
+{
+    const sts_t lock = kernel::lock();
+    const usage_t usage = total;
+    kernel::restore_lock(lock);
+    return usage;
+}
+
+} // namespace os::config
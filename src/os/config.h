@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "RTX_Config.h"
+
+#ifndef OS_CONFIG_EXACT_FIT
+    #define OS_CONFIG_EXACT_FIT 0   ///< 1 - also fail when RTX_Config.h reserves more than used
+#endif
+
+// Static thread stacks in bytes (0 - unlimited). By default all of the main RAM of the device as
+// laid out by the scatter file (the linker still checks the rest); other targets must define it.
+#ifndef OS_CONFIG_STACK_BUDGET
+    #if defined(STM32F413xx) || defined(STM32F411xE)
+        #include "../memory_map.h"
+        #define OS_CONFIG_STACK_BUDGET RAM_SIZE
+    #else
+        #error OS_CONFIG_STACK_BUDGET is not defined for this target.
+    #endif
+#endif
+
+/// Check of RTX_Config.h against the objects of the application.
+/// Static objects of the wrapper (os::thread, os::mutex) carry their own control blocks and
+/// stacks, so they never draw from the RTX object pools (OS_xxx_NUM) and need no pool entries.
+/// What they do share are kernel resources sized in RTX_Config.h: C library libspace slots (one
+/// per thread calling the library) and the ISR post-processing FIFO, plus the RAM of the static
+/// stacks, limited by OS_CONFIG_STACK_BUDGET. Every static template and every module with internal
+/// objects publishes its @ref usage_t.
+/// The application checks its objects at compile time with @ref check:
+/// `static_assert(os::config::check<os::config::usage_of<app_thread>() + os::isr::usage>::ok);`
+/// As a backstop at run time each thread class adds its usage when it starts for the first time,
+/// and modules add what is not a thread (@ref add): a start that would exceed the configuration
+/// fails and prints the limit, which catches objects missing from the compile-time sum.
+namespace os::config
+{
+
+/// Kernel resources used by a set of objects.
+struct usage_t
+{
+    uint32_t threads;       ///< Static threads (each may take a libspace slot).
+    uint32_t stack;         ///< Static stack memory in bytes.
+    uint32_t isr_fifo;      ///< ISR FIFO entries the objects can have pending at the same time.
+
+    constexpr usage_t operator+(const usage_t &_other) const
+    {
+        return {threads + _other.threads, stack + _other.stack, isr_fifo + _other.isr_fifo};
+    }
+
+    constexpr bool operator==(const usage_t &) const = default;
+};
+
+/// \return true if the usage fits into RTX_Config.h and the stack budget.
+constexpr bool fits(const usage_t &_usage)
+{
+    return _usage.threads <= OS_THREAD_LIBSPACE_NUM && _usage.isr_fifo <= OS_ISR_FIFO_QUEUE &&
+           (OS_CONFIG_STACK_BUDGET == 0U || _usage.stack <= OS_CONFIG_STACK_BUDGET);
+}
+
+/// Add the usage of an object to the total of the application (thread-safe).
+/// \param[in]     usage         usage of the object.
+/// \param[in]     name          name of the object for the error message.
+/// \return false if the total would not fit (@ref fits); the usage is not added then.
+bool add(const usage_t &_usage, const char *_name);
+
+/// \return total usage of the objects started so far.
+usage_t get_usage(void);
+
+/// \return usage of a static object type (`_obj::usage`).
+template <class _obj>
+constexpr usage_t usage_of(void)
+{
+    return _obj::usage;
+}
+
+/// Configuration check. Fails compilation with a message naming the RTX_Config.h entry.
+/// \tparam _usage       total usage of the application.
+template <usage_t _usage>
+struct check
+{
+    static_assert(_usage.threads <= OS_THREAD_LIBSPACE_NUM,
+                  "More static threads than C library libspace slots: increase OS_THREAD_LIBSPACE_NUM.");
+    static_assert(_usage.isr_fifo <= OS_ISR_FIFO_QUEUE,
+                  "ISR FIFO is smaller than the pending ISR calls of the objects: increase OS_ISR_FIFO_QUEUE.");
+    static_assert(OS_CONFIG_STACK_BUDGET == 0U || _usage.stack <= OS_CONFIG_STACK_BUDGET,
+                  "Static thread stacks exceed the budget: increase OS_CONFIG_STACK_BUDGET or shrink the stacks.");
+#if (OS_CONFIG_EXACT_FIT != 0) && (OS_THREAD_OBJ_MEM == 0)
+    static_assert(_usage.threads == OS_THREAD_LIBSPACE_NUM,
+                  "Unused libspace slots: set OS_THREAD_LIBSPACE_NUM to the number of static threads.");
+#endif
+
+    static constexpr bool ok = true;
+};
+
+} // namespace os::config
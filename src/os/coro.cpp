@@ -0,0 +1,177 @@
+#include <atomic>
+#include <tuple>
+
+#include "rtx_os.h"
+
+#include "thread.h"
+#include "mutex.h"
+#include "pool.h"
+#include "coro.h"
+
+namespace os::coro
+{
+
+static_assert(OS_CORO_WORKERS >= 1, "At least one coroutine worker is required.");
+
+/// Frame block.
+struct alignas(8) frame_t
+{
+    uint8_t data[OS_CORO_FRAME_SIZE];
+};
+
+static pool<frame_t, OS_CORO_FRAME_NUM> frames;
+
+/// Ready coroutines, and null when awaited objects have changed (see @ref kick). Each coroutine
+/// is queued at most once and there is at most one null queued, so a post never finds it full.
+static queue<void *, OS_CORO_FRAME_NUM + 1U> ready __attribute__((section(".bss.os.msgqueue.cb")));
+
+/// Serializes the waiters of awaited objects and their timeouts.
+static mutex<> waiters_mtx __attribute__((section(".bss.os.mutex.cb")));
+
+static std::atomic<uint32_t> spawned;
+static std::atomic<uint32_t> done;
+static std::atomic<uint32_t> resumed;
+static std::atomic<uint32_t> frames_used;
+static std::atomic<uint32_t> frames_max;
+static std::atomic<uint32_t> frames_failed;
+
+/// Worker thread (one class per index, since a thread class owns its stack).
+template <uint32_t _idx>
+class worker: public thread<worker<_idx>, OS_CORO_STACK_SIZE, priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            void *addr;
+            if (ready.get(addr) != sts_t::OK)
+            {
+                continue;
+            }
+            if (addr == nullptr)
+            {
+                lock();
+                waiters::sweep_all();
+                unlock();
+                continue;
+            }
+            resumed.fetch_add(1U, std::memory_order_relaxed);
+            std::coroutine_handle<>::from_address(addr).resume();
+        }
+    }
+};
+
+static_assert(config::usage_of<worker<0>>().stack * OS_CORO_WORKERS == usage.stack
+              && config::usage_of<worker<0>>().threads * OS_CORO_WORKERS == usage.threads,
+              "os::coro::usage does not match the worker threads.");
+
+template <class>
+struct worker_set;
+
+template <uint32_t... _idx>
+struct worker_set<std::integer_sequence<uint32_t, _idx...>>
+{
+    std::tuple<worker<_idx>...> threads;
+
+    sts_t start(void)
+    {
+        sts_t sts = sts_t::OK;
+        ((sts = (sts == sts_t::OK) ? std::get<_idx>(threads).start("coro") : sts), ...);
+        return sts;
+    }
+};
+
+static worker_set<std::make_integer_sequence<uint32_t, OS_CORO_WORKERS>> workers;
+
+/// Kick handler of the waiters hook: a worker sweeps the kicked lists (callable from interrupts).
+static void kick(void)
+{
+    ready.put(nullptr, 0U);
+}
+
+sts_t start(void)
+{
+    const sts_t sts = timers::start();
+    if (sts != sts_t::OK)
+    {
+        return sts;
+    }
+    if (ready.create("coro") != sts_t::OK || waiters_mtx.create("coro") != sts_t::OK)
+    {
+        return sts_t::err;
+    }
+    waiters::kick = kick;
+    return workers.start();
+}
+
+void lock(void)
+{
+    waiters_mtx.acquire();
+}
+
+void unlock(void)
+{
+    waiters_mtx.release();
+}
+
+sts_t spawn(task<void> &&_task)
+{
+    if (!_task.handle_)
+    {
+        return sts_t::err_nomem;
+    }
+    const auto handle = std::exchange(_task.handle_, nullptr);
+    handle.promise().detached_ = true;
+    spawned.fetch_add(1U, std::memory_order_relaxed);
+    post(handle);
+    return sts_t::OK;
+}
+
+void post(const std::coroutine_handle<> _handle)
+{
+    ready.put(_handle.address(), 0U);
+}
+
+stats_t get_stats(void)
+{
+    return
+    {
+        .spawned       = spawned.load(std::memory_order_relaxed),
+        .finished      = done.load(std::memory_order_relaxed),
+        .resumed       = resumed.load(std::memory_order_relaxed),
+        .frames_used   = frames_used.load(std::memory_order_relaxed),
+        .frames_max    = frames_max.load(std::memory_order_relaxed),
+        .frames_failed = frames_failed.load(std::memory_order_relaxed),
+    };
+}
+
+void *frame_alloc(const size_t _size) noexcept
+{
+    void *frame = (_size <= sizeof(frame_t)) ? frames.alloc() : nullptr;
+    if (frame == nullptr)
+    {
+        frames_failed.fetch_add(1U, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    const uint32_t used = frames_used.fetch_add(1U, std::memory_order_relaxed) + 1U;
+    uint32_t max = frames_max.load(std::memory_order_relaxed);
+    while (used > max && !frames_max.compare_exchange_weak(max, used, std::memory_order_relaxed))
+    {
+    }
+    return frame;
+}
+
+void frame_free(void *_frame) noexcept
+{
+    frames.free(_frame);
+    frames_used.fetch_sub(1U, std::memory_order_relaxed);
+}
+
+void finished(void) noexcept
+{
+    done.fetch_add(1U, std::memory_order_relaxed);
+}
+
+} // namespace os::coro
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "os.h"
+#include "chrono.h"
+#include "config.h"
+#include "timer_wheel.h"
+#include "queue.h"
+#include "event_flags.h"
+#include "sem.h"
+
+#ifndef OS_CORO_WORKERS
+    #define OS_CORO_WORKERS 2               ///< Number of worker threads that run coroutines
+#endif
+
+#ifndef OS_CORO_STACK_SIZE
+    #define OS_CORO_STACK_SIZE 1024         ///< Stack size of a worker thread in bytes
+#endif
+
+#ifndef OS_CORO_FRAME_SIZE
+    #define OS_CORO_FRAME_SIZE (64U * sizeof(void *)) ///< Size of a coroutine frame block in bytes
+#endif
+
+#ifndef OS_CORO_FRAME_NUM
+    #define OS_CORO_FRAME_NUM 32            ///< Number of coroutine frame blocks
+#endif
+
+/// Coroutines on RTX worker threads.
+/// A coroutine (@ref task) keeps its state in a frame instead of a stack, so many logical tasks
+/// share the stacks of a few worker threads of @ref priority::normal. Frames are blocks of a static
+/// @ref pool (OS_CORO_FRAME_NUM blocks of OS_CORO_FRAME_SIZE bytes); a coroutine whose frame does
+/// not fit returns an empty task. A ready coroutine is posted to a queue that the workers take
+/// from, so a coroutine may continue on any worker.
+/// Awaiting suspends the coroutine and frees the worker:
+/// - @ref delay / @ref yield wait on the timer service (started by @ref start);
+/// - @ref get, @ref wait_any, @ref wait_all and @ref acquire wait for queues, event flags and
+///   semaphores. The coroutine waits on the @ref waiters hook of the object and is tried again
+///   when the object notifies a change, from a worker; a timeout is a timer of the timer service.
+///   Nothing runs while nothing changes, so tickless idle is not disturbed. A thread blocked on
+///   the same object takes precedence.
+/// A coroutine must not call blocking RTX functions itself, that would block its worker.
+namespace os
+{
+
+template <class T = void>
+class task;
+
+namespace coro
+{
+
+/// Kernel resources of the coroutine workers (see @ref config::check).
+constexpr config::usage_t usage = {.threads = OS_CORO_WORKERS, .stack = OS_CORO_WORKERS * OS_CORO_STACK_SIZE, .isr_fifo = 0U};
+
+/// Coroutine statistics.
+struct stats_t
+{
+    uint32_t spawned;       ///< Tasks started by @ref spawn.
+    uint32_t finished;      ///< Spawned tasks completed.
+    uint32_t resumed;       ///< Resumptions by the workers.
+    uint32_t frames_used;   ///< Frames in use.
+    uint32_t frames_max;    ///< Highest number of frames in use.
+    uint32_t frames_failed; ///< Frame allocations that failed (pool exhausted or frame too large).
+};
+
+/// Start the timer service (see os::timers::start) and the worker threads (the kernel must be
+/// initialized).
+/// \return status code that indicates the execution status of the function.
+sts_t start(void);
+
+/// Make a suspended coroutine ready (callable from threads, timer callbacks and interrupts: it
+/// only puts the handle into the ready queue without waiting). The awaitables that suspend a
+/// coroutine run on its worker thread and use os::timers, which is not interrupt safe.
+void post(const std::coroutine_handle<> _handle);
+
+/// Get coroutine statistics.
+stats_t get_stats(void);
+
+/// Frame allocation of @ref task (static pool).
+/// \return frame or nullptr if the pool is exhausted or the frame is larger than a block.
+void *frame_alloc(const size_t _size) noexcept;
+
+/// Return a frame taken by @ref frame_alloc.
+void frame_free(void *_frame) noexcept;
+
+/// Count a completed spawned task.
+void finished(void) noexcept;
+
+/// Run a task detached on the workers; its frame is freed when it completes.
+/// \param[in]     task          task (empty after the call).
+/// \return status code (@ref sts_t::err_nomem - the task is empty).
+sts_t spawn(task<void> &&_task);
+
+/// Promise part common to all result types.
+class promise_base
+{
+private:
+    std::coroutine_handle<> continuation_;
+    bool detached_ = false;
+
+    template <class>
+    friend class os::task;
+
+    friend sts_t spawn(task<void> &&_task);
+
+public:
+    static void *operator new(const size_t _size) noexcept
+    {
+        return frame_alloc(_size);
+    }
+
+    static void operator delete(void *_frame) noexcept
+    {
+        frame_free(_frame);
+    }
+
+    /// Resumes the awaiting coroutine, or frees the frame of a spawned task.
+    struct final_awaiter
+    {
+        bool await_ready(void) noexcept
+        {
+            return false;
+        }
+
+        template <class _promise>
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<_promise> _handle) noexcept
+        {
+            promise_base &promise = _handle.promise();
+            if (promise.continuation_)
+            {
+                return promise.continuation_;
+            }
+            if (promise.detached_)
+            {
+                _handle.destroy();
+                finished();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume(void) noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend(void) noexcept
+    {
+        return {};
+    }
+
+    final_awaiter final_suspend(void) noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception(void) noexcept
+    {
+        std::terminate();
+    }
+};
+
+/// Result storage of a promise.
+template <class T>
+class promise_result: public promise_base
+{
+protected:
+    std::optional<T> value_;
+
+public:
+    void return_value(T _value)
+    {
+        value_.emplace(std::move(_value));
+    }
+
+    T take(void)
+    {
+        return std::move(*value_);
+    }
+};
+
+template <>
+class promise_result<void>: public promise_base
+{
+public:
+    void return_void(void) noexcept
+    {
+    }
+
+    void take(void) noexcept
+    {
+    }
+};
+
+} // namespace coro
+
+/// Coroutine returning T.
+/// A task starts suspended: it runs when it is awaited by another coroutine (`co_await child()`,
+/// which continues the awaiting coroutine when the child completes) or when it is passed to
+/// @ref coro::spawn. An empty task (`!t`) means the frame could not be allocated.
+template <class T>
+class task
+{
+public:
+    struct promise_type: public coro::promise_result<T>
+    {
+        task get_return_object(void) noexcept
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        static task get_return_object_on_allocation_failure(void) noexcept
+        {
+            return task();
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit task(const std::coroutine_handle<promise_type> _handle): handle_(_handle) {}
+
+    friend sts_t coro::spawn(task<void> &&_task);
+
+public:
+    constexpr task(): handle_(nullptr) {}
+
+    task(task &&_other): handle_(std::exchange(_other.handle_, nullptr)) {}
+
+    task &operator=(task &&_other)
+    {
+        if (this != &_other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(_other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    /// \return true if the coroutine frame was allocated.
+    explicit operator bool(void) const
+    {
+        return static_cast<bool>(handle_);
+    }
+
+    /// Awaiting a task runs it on the current worker and continues when it completes.
+    /// The task must not be empty.
+    auto operator co_await(void) && noexcept
+    {
+        struct awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready(void) noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(const std::coroutine_handle<> _caller) noexcept
+            {
+                handle.promise().continuation_ = _caller;
+                return handle;
+            }
+
+            T await_resume(void)
+            {
+                return handle.promise().take();
+            }
+        };
+        return awaiter{handle_};
+    }
+};
+
+namespace coro
+{
+
+/// Awaitable delay on the timer service.
+class delay_awaiter
+{
+private:
+    wheel_timer_t           timer_;
+    uint32_t                ticks_;
+    sts_t                   sts_;
+    std::coroutine_handle<> handle_;
+
+    static void expired(void *_arg)
+    {
+        post(static_cast<delay_awaiter *>(_arg)->handle_);
+    }
+
+public:
+    explicit delay_awaiter(const uint32_t _ticks): timer_(expired, this), ticks_(_ticks), sts_(sts_t::OK), handle_(nullptr) {}
+
+    delay_awaiter(const delay_awaiter &) = delete;
+    delay_awaiter &operator=(const delay_awaiter &) = delete;
+
+    bool await_ready(void) noexcept
+    {
+        return false;
+    }
+
+    /// \return false to continue at once if the timer could not be started.
+    bool await_suspend(const std::coroutine_handle<> _handle) noexcept
+    {
+        handle_ = _handle;
+        if (ticks_ == 0U)
+        {
+            post(_handle);
+            return true;
+        }
+        // Once the timer runs the coroutine may be resumed and this awaiter destroyed at any time
+        const sts_t sts = timers::start(timer_, ticks_);
+        if (sts != sts_t::OK)
+        {
+            sts_ = sts;
+            return false;
+        }
+        return true;
+    }
+
+    sts_t await_resume(void) noexcept
+    {
+        return sts_;
+    }
+};
+
+/// Suspend the coroutine for a number of ticks (`co_await os::coro::delay(10)`).
+/// \return awaitable of the status code (an error of timers::start, the delay did not happen).
+inline delay_awaiter delay(const uint32_t _ticks)
+{
+    return delay_awaiter(_ticks);
+}
+
+/// Suspend the coroutine for a duration, rounded up to whole ticks.
+template <class _rep, class _period>
+inline delay_awaiter delay(const std::chrono::duration<_rep, _period> &_time)
+{
+    return delay_awaiter(to_ticks(_time).count());
+}
+
+/// Let other ready coroutines run (`co_await os::coro::yield()`).
+inline delay_awaiter yield(void)
+{
+    return delay_awaiter(0U);
+}
+
+/// Serialize the waiters of all awaited objects and their timeouts (see @ref wait_awaiter).
+void lock(void);
+void unlock(void);
+
+/// Awaitable that waits on the @ref waiters hook of a kernel object until an attempt succeeds or
+/// the timeout expires. The coroutine is tried again only when the object notifies a change.
+/// Its timeout is a timer of the timer service; whichever of the wake-up and the timeout comes
+/// second finds the other one done. A wake-up that finds the timer already expired leaves the
+/// resumption to the timer callback, so the awaiter is never touched after it is resumed.
+/// \tparam R            result type.
+/// \tparam F            `bool(R &)`: try once without blocking, store the result, true if done.
+template <class R, class F>
+class wait_awaiter: private waiter_t
+{
+private:
+    F                       try_;
+    R                       result_;
+    const R                 timeout_result_;
+    uint32_t                timeout_;
+    bool                    done_;
+    wheel_timer_t           timer_;
+    std::coroutine_handle<> handle_;
+
+    /// Called by waiters::sweep under the lock.
+    static void wake(waiter_t &_waiter)
+    {
+        wait_awaiter &self = static_cast<wait_awaiter &>(_waiter);
+        if (!self.try_(self.result_))
+        {
+            return;
+        }
+        self.list->remove(self);
+        if (self.timeout_ == forever || timers::stop(self.timer_) == sts_t::OK)
+        {
+            post(self.handle_);
+            return;
+        }
+        // The timer has expired, its callback is waiting for the lock and resumes the coroutine
+        self.done_ = true;
+    }
+
+    /// Timer service callback.
+    static void expired(void *_arg)
+    {
+        wait_awaiter &self = *static_cast<wait_awaiter *>(_arg);
+        lock();
+        if (!self.done_)
+        {
+            self.list->remove(self);
+            self.result_ = self.timeout_result_;
+        }
+        unlock();
+        post(self.handle_);
+    }
+
+public:
+    wait_awaiter(waiters &_waiters, F _try, const R _timeout_result, const uint32_t _timeout):
+        waiter_t{nullptr, nullptr, &_waiters, wake},
+        try_(std::move(_try)), result_(_timeout_result), timeout_result_(_timeout_result), timeout_(_timeout),
+        done_(false), timer_(expired, this), handle_(nullptr)
+    {
+    }
+
+    wait_awaiter(const wait_awaiter &) = delete;
+    wait_awaiter &operator=(const wait_awaiter &) = delete;
+
+    bool await_ready(void)
+    {
+        return try_(result_) || timeout_ == 0U;
+    }
+
+    /// \return false to continue at once (done meanwhile, or the timeout could not be started).
+    bool await_suspend(const std::coroutine_handle<> _handle)
+    {
+        handle_ = _handle;
+        lock();
+        list->add(*this);
+        bool wait = !try_(result_);
+        if (wait && timeout_ != forever && timers::start(timer_, timeout_) != sts_t::OK)
+        {
+            wait = false;
+        }
+        if (!wait)
+        {
+            list->remove(*this);
+        }
+        unlock();
+        return wait;
+    }
+
+    R await_resume(void)
+    {
+        return result_;
+    }
+};
+
+/// Get a message from a queue (`sts_t sts = co_await os::coro::get(q, msg)`).
+/// \param[in]     queue         queue.
+/// \param[out]    msg           message.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return awaitable of the status code.
+template <class T, uint32_t N>
+inline auto get(queue<T, N> &_queue, T &_msg, const uint32_t _timeout = forever)
+{
+    auto attempt = [&_queue, &_msg](sts_t &_sts)
+    {
+        _sts = _queue.get(_msg, 0U);
+        return _sts != sts_t::err_resource;
+    };
+    return wait_awaiter<sts_t, decltype(attempt)>(_queue.get_waiters(), attempt, (_timeout == 0U) ? sts_t::err_resource : sts_t::err_timeout, _timeout);
+}
+
+/// Get a message from a queue, timeout as a duration rounded up to whole ticks.
+template <class T, uint32_t N, class _rep, class _period>
+inline auto get(queue<T, N> &_queue, T &_msg, const std::chrono::duration<_rep, _period> &_timeout)
+{
+    return get(_queue, _msg, to_ticks(_timeout).count());
+}
+
+/// Wait for any of the event flags (`auto f = co_await os::coro::wait_any(events, ev::rx)`).
+/// \param[in]     events        event flags.
+/// \param[in]     flags         flags to wait for (cleared on return).
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return awaitable of the flags before clearing or an error.
+template <flag_enum E>
+inline auto wait_any(event_flags<E> &_events, const typename event_flags<E>::flags_t _flags, const uint32_t _timeout = forever)
+{
+    auto attempt = [&_events, _flags](flags<E> &_result)
+    {
+        _result = _events.wait_any(_flags, 0U);
+        return _result.status() != sts_t::err_resource;
+    };
+    return wait_awaiter<flags<E>, decltype(attempt)>(
+        _events.get_waiters(), attempt, flags<E>::from_raw((_timeout == 0U) ? osFlagsErrorResource : osFlagsErrorTimeout), _timeout);
+}
+
+/// Wait for any of the event flags, timeout as a duration rounded up to whole ticks.
+template <flag_enum E, class _rep, class _period>
+inline auto wait_any(event_flags<E> &_events, const typename event_flags<E>::flags_t _flags, const std::chrono::duration<_rep, _period> &_timeout)
+{
+    return wait_any(_events, _flags, to_ticks(_timeout).count());
+}
+
+/// Wait for all of the event flags (`auto f = co_await os::coro::wait_all(events, mask)`).
+/// \param[in]     events        event flags.
+/// \param[in]     flags         flags to wait for (cleared on return).
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return awaitable of the flags before clearing or an error.
+template <flag_enum E>
+inline auto wait_all(event_flags<E> &_events, const typename event_flags<E>::flags_t _flags, const uint32_t _timeout = forever)
+{
+    auto attempt = [&_events, _flags](flags<E> &_result)
+    {
+        _result = _events.wait_all(_flags, 0U);
+        return _result.status() != sts_t::err_resource;
+    };
+    return wait_awaiter<flags<E>, decltype(attempt)>(
+        _events.get_waiters(), attempt, flags<E>::from_raw((_timeout == 0U) ? osFlagsErrorResource : osFlagsErrorTimeout), _timeout);
+}
+
+/// Wait for all of the event flags, timeout as a duration rounded up to whole ticks.
+template <flag_enum E, class _rep, class _period>
+inline auto wait_all(event_flags<E> &_events, const typename event_flags<E>::flags_t _flags, const std::chrono::duration<_rep, _period> &_timeout)
+{
+    return wait_all(_events, _flags, to_ticks(_timeout).count());
+}
+
+/// Acquire a semaphore token (`sts_t sts = co_await os::coro::acquire(sem)`).
+/// \param[in]     sem           semaphore.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return awaitable of the status code.
+template <uint32_t _max, uint32_t _initial>
+inline auto acquire(semaphore<_max, _initial> &_sem, const uint32_t _timeout = forever)
+{
+    auto attempt = [&_sem](sts_t &_sts)
+    {
+        _sts = _sem.acquire(0U);
+        return _sts != sts_t::err_resource;
+    };
+    return wait_awaiter<sts_t, decltype(attempt)>(_sem.get_waiters(), attempt, (_timeout == 0U) ? sts_t::err_resource : sts_t::err_timeout, _timeout);
+}
+
+/// Acquire a semaphore token, timeout as a duration rounded up to whole ticks.
+template <uint32_t _max, uint32_t _initial, class _rep, class _period>
+inline auto acquire(semaphore<_max, _initial> &_sem, const std::chrono::duration<_rep, _period> &_timeout)
+{
+    return acquire(_sem, to_ticks(_timeout).count());
+}
+
+} // namespace coro
+
+} // namespace os
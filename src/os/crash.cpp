@@ -0,0 +1,181 @@
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+#include <string.h>
+
+#include "rtx_os.h"
+#include "misc.h"
+#include "crash.h"
+
+extern "C" uint32_t Image$$ARM_LIB_STACKHEAP$$ZI$$Base;
+extern "C" uint32_t Image$$ARM_LIB_STACKHEAP$$ZI$$Limit;
+
+namespace os::crash
+{
+
+/// Survives the reset (UNINIT region of crtp.sct).
+static record_t record __attribute__((section(".bss.noinit")));
+
+/// Valid record of the previous run, taken over by @ref report.
+static bool reported;
+
+/// Copy the stack of the faulting context, bounded by that stack. A stack pointer outside of it
+/// (corrupted, or a thread whose control block is not trusted) is not read: reading flash gaps
+/// or peripherals here could fault again and lock the core up.
+static void save_stack(const uint32_t _sp, const bool _psp, const osRtxThread_t *_thread)
+{
+    uint32_t base = reinterpret_cast<uint32_t>(&Image$$ARM_LIB_STACKHEAP$$ZI$$Base);
+    uint32_t limit = reinterpret_cast<uint32_t>(&Image$$ARM_LIB_STACKHEAP$$ZI$$Limit);
+    if (_psp)
+    {
+        base = 0U;
+        limit = 0U;
+        if (_thread != nullptr)
+        {
+            base = reinterpret_cast<uint32_t>(_thread->stack_mem);
+            limit = base + _thread->stack_size;
+        }
+    }
+
+    const bool inside = _sp >= base && _sp < limit && (_sp % sizeof(uint32_t)) == 0U;
+    uint32_t words = inside ? (limit - _sp) / sizeof(uint32_t) : 0U;
+    if (words > OS_CRASH_STACK_WORDS)
+    {
+        words = OS_CRASH_STACK_WORDS;
+    }
+    const uint32_t *sp = reinterpret_cast<const uint32_t *>(_sp);
+    for (uint32_t i = 0U; i < words; i++)
+    {
+        record.stack[i] = sp[i];
+    }
+    record.stack_words = words;
+}
+
+/// Fill the record. Runs on the main stack in the fault handler: no RTOS calls, no library I/O.
+/// \param[in]     frame         exception stack frame (R0-R3, R12, LR, PC, xPSR).
+/// \param[in]     exc_return    EXC_RETURN value.
+/// \param[in]     regs          R4-R11 saved by the handler entry.
+static void capture(const uint32_t *_frame, const uint32_t _exc_return, const uint32_t *_regs)
+{
+    memset(&record, 0, sizeof(record));
+    record.magic = magic;
+    record.version = version;
+    record.size = sizeof(record);
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        record.r[i] = _frame[i];
+    }
+    for (uint32_t i = 0U; i < 8U; i++)
+    {
+        record.r[4U + i] = _regs[i];
+    }
+    record.r[12] = _frame[4];
+    record.lr = _frame[5];
+    record.pc = _frame[6];
+    record.psr = _frame[7];
+
+    // Basic or extended (FPU) frame, plus the alignment word when xPSR bit 9 is set
+    const uint32_t frame_words = ((_exc_return & 0x10U) != 0U) ? 8U : 26U;
+    record.sp = reinterpret_cast<uint32_t>(_frame) + frame_words * sizeof(uint32_t) +
+                (((record.psr & (1U << 9)) != 0U) ? sizeof(uint32_t) : 0U);
+    record.exc_return = _exc_return;
+    record.msp = __get_MSP();
+    record.psp = __get_PSP();
+
+    record.cfsr = SCB->CFSR;
+    record.hfsr = SCB->HFSR;
+    record.mmfar = SCB->MMFAR;
+    record.bfar = SCB->BFAR;
+
+    // Thread data is only trusted when the control block still looks like a thread
+    const osRtxThread_t *thread = osRtxInfo.thread.run.curr;
+    if (thread != nullptr && thread->id != osRtxIdThread)
+    {
+        thread = nullptr;
+    }
+    if (thread != nullptr)
+    {
+        record.thread_id = reinterpret_cast<uint32_t>(thread);
+        const uint32_t name = reinterpret_cast<uint32_t>(thread->name);
+        if (name >= FLASH_BASE && name < FLASH_END)
+        {
+            strncpy(record.thread_name, thread->name, sizeof(record.thread_name) - 1U);
+        }
+    }
+
+    save_stack(record.sp, (_exc_return & 0x04U) != 0U, thread);
+
+    record.checksum = checksum(record);
+}
+
+const record_t *get(void)
+{
+    return (reported || valid(record)) ? &record : nullptr;
+}
+
+void report(void)
+{
+    if (!valid(record))
+    {
+        return;
+    }
+    reported = true;
+
+    printerr("Hard fault before the last reset.\n");
+    printf("\t thread = %#010x '%s'\n", record.thread_id, record.thread_name);
+    printf("\t pc  = %#010x lr  = %#010x sp  = %#010x psr = %#010x\n", record.pc, record.lr, record.sp, record.psr);
+    for (uint32_t i = 0U; i < 13U; i++)
+    {
+        printf("\t r%-2u = %#010x%s", i, record.r[i], ((i % 4U) == 3U || i == 12U) ? "\n" : "");
+    }
+    printf("\t cfsr = %#010x hfsr = %#010x mmfar = %#010x bfar = %#010x\n", record.cfsr, record.hfsr, record.mmfar, record.bfar);
+
+    // Raw record for tools/crash/crash_decode
+    const uint32_t *words = reinterpret_cast<const uint32_t *>(&record);
+    for (uint32_t i = 0U; i < sizeof(record) / sizeof(uint32_t); i += 8U)
+    {
+        printf("CRSH");
+        for (uint32_t j = i; j < i + 8U && j < sizeof(record) / sizeof(uint32_t); j++)
+        {
+            printf(" %08x", words[j]);
+        }
+        printf("\n");
+    }
+
+    record.magic = 0U;
+}
+
+} // namespace os::crash
+
+extern "C" {
+    __USED static void _crash_capture(const uint32_t *frame, uint32_t exc_return, const uint32_t *regs);
+}
+
+static void _crash_capture(const uint32_t *frame, uint32_t exc_return, const uint32_t *regs)
+{
+    os::crash::capture(frame, exc_return, regs);
+
+    if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0U)
+    {
+        __BKPT(0);
+    }
+    NVIC_SystemReset();
+}
+
+/// System hard fault: save R4-R11 before any compiler generated code can touch them.
+extern "C" __attribute__((naked)) void HardFault_Handler(void);
+void HardFault_Handler(void)
+{
+    __asm volatile
+    (
+        "TST lr, #4          \n"
+        "ITE EQ              \n"
+        "MRSEQ r0, MSP       \n"
+        "MRSNE r0, PSP       \n"
+        "MOV r1, lr          \n"
+        "PUSH {r4-r11}       \n"
+        "MOV r2, sp          \n"
+        "B _crash_capture    \n"
+    );
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef OS_CRASH_STACK_WORDS
+    #define OS_CRASH_STACK_WORDS 64 ///< Stack words saved from the faulting stack pointer upwards
+#endif
+
+/// Hard fault post-mortem capture.
+/// HardFault_Handler saves the full register set, the fault status registers, the running thread
+/// and the top of its stack into a record in the `.bss.noinit` section (not cleared at startup,
+/// see crtp.sct), then resets the device. After the reboot @ref report prints the record.
+/// tools/crash/crash_decode symbolizes the record against the ELF image.
+/// The header is shared with the host tool, so it only depends on the C library.
+namespace os::crash
+{
+
+/// Record marker ("CRSH").
+constexpr uint32_t magic = 0x48535243U;
+
+/// Record layout version.
+constexpr uint32_t version = 1U;
+
+/// Crash record (little endian, 32-bit words only, so the layout is the same on every compiler).
+struct record_t
+{
+    uint32_t magic;             ///< @ref magic
+    uint32_t version;           ///< @ref version
+    uint32_t size;              ///< sizeof(record_t)
+    uint32_t r[13];             ///< R0 - R12
+    uint32_t sp;                ///< Stack pointer before the exception entry
+    uint32_t lr;                ///< LR of the faulting context
+    uint32_t pc;                ///< Faulting instruction
+    uint32_t psr;               ///< xPSR
+    uint32_t exc_return;        ///< EXC_RETURN of the fault handler
+    uint32_t msp;               ///< Main stack pointer in the handler
+    uint32_t psp;               ///< Process stack pointer in the handler
+    uint32_t cfsr;              ///< Configurable Fault Status Register
+    uint32_t hfsr;              ///< HardFault Status Register
+    uint32_t mmfar;             ///< MemManage Fault Address Register
+    uint32_t bfar;              ///< BusFault Address Register
+    uint32_t thread_id;         ///< Running thread (0 - none)
+    char     thread_name[16];   ///< Name of the running thread (null-terminated)
+    uint32_t stack_words;       ///< Valid words in @ref stack
+    uint32_t stack[OS_CRASH_STACK_WORDS]; ///< Stack content from @ref sp upwards
+    uint32_t checksum;          ///< @ref checksum of all preceding words
+};
+
+static_assert(offsetof(record_t, r) == 12U);
+static_assert(offsetof(record_t, sp) == 64U);
+static_assert(offsetof(record_t, exc_return) == 80U);
+static_assert(offsetof(record_t, cfsr) == 92U);
+static_assert(offsetof(record_t, thread_id) == 108U);
+static_assert(offsetof(record_t, stack_words) == 128U);
+static_assert(offsetof(record_t, stack) == 132U);
+static_assert(sizeof(record_t) == 136U + OS_CRASH_STACK_WORDS * 4U);
+static_assert(sizeof(record_t) % sizeof(uint32_t) == 0U);
+
+/// Record checksum (CRC-32, IEEE 802.3) over all words before the checksum field.
+inline uint32_t checksum(const record_t &_rec)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&_rec);
+    uint32_t crc = 0xFFFFFFFFU;
+    for (size_t i = 0U; i < offsetof(record_t, checksum); i++)
+    {
+        crc ^= p[i];
+        for (uint32_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+/// \return true if the record holds a complete capture of this layout.
+inline bool valid(const record_t &_rec)
+{
+    return _rec.magic == magic && _rec.version == version && _rec.size == sizeof(record_t) &&
+           _rec.stack_words <= OS_CRASH_STACK_WORDS && _rec.checksum == checksum(_rec);
+}
+
+/// Get the record of the last crash.
+/// \return record or nullptr if the last reset was not caused by a captured fault.
+const record_t *get(void);
+
+/// Print the record of the last crash (if any) to stderr and clear it.
+/// Call once at startup, after the standard output is available.
+void report(void);
+
+} // namespace os::crash
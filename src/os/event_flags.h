@@ -0,0 +1,228 @@
+#pragma once
+
+#include <type_traits>
+
+#include "os.h"
+#include "chrono.h"
+#include "waiters.h"
+
+#include "rtx_os.h"
+
+namespace os
+{
+
+/// Flag enumeration: a scoped enum whose enumerators are bit numbers 0, 1, ... and whose last
+/// enumerator `count` is the number of flags, e.g.
+/// `enum class ev: uint32_t { rx, tx, error, count };`.
+/// Bit 31 is the error indicator of the RTX flags functions, so at most 31 flags are allowed.
+template <class E>
+concept flag_enum = std::is_enum_v<E> && !std::is_convertible_v<E, uint32_t> && requires { E::count; };
+
+/// Set of flags of a @ref flag_enum, or an error returned by a flags function.
+/// Converts implicitly from a single flag, so `os::flags<ev>(ev::rx) | ev::tx` builds a mask.
+template <flag_enum E>
+class flags
+{
+public:
+    static constexpr uint32_t count = static_cast<uint32_t>(E::count);
+    static_assert(count >= 1U && count <= 31U, "Flag enum must have 1..31 flags (bit 31 is the error indicator).");
+
+    /// All flags of the enum.
+    static constexpr uint32_t all = (1U << count) - 1U;
+
+private:
+    uint32_t raw_;
+
+public:
+    constexpr flags(): raw_(0U) {}
+    constexpr flags(const E _flag): raw_(1U << static_cast<uint32_t>(_flag)) {}
+
+    /// \param[in]     raw           mask or result of an RTX flags function.
+    static constexpr flags from_raw(const uint32_t _raw)
+    {
+        flags result;
+        result.raw_ = _raw;
+        return result;
+    }
+
+    /// \return mask (or error code, see @ref is_error).
+    constexpr uint32_t raw(void) const
+    {
+        return raw_;
+    }
+
+    /// \return true if the value is an error code (see @ref status).
+    constexpr bool is_error(void) const
+    {
+        return (raw_ & osFlagsError) != 0U;
+    }
+
+    /// \return @ref sts_t::OK or the error of a flags function.
+    constexpr sts_t status(void) const
+    {
+        return is_error() ? static_cast<sts_t>(static_cast<int32_t>(raw_)) : sts_t::OK;
+    }
+
+    /// \return true if the flag is set (false for an error).
+    constexpr bool has(const E _flag) const
+    {
+        return !is_error() && (raw_ & flags(_flag).raw_) != 0U;
+    }
+
+    /// \return true if no flag is set.
+    constexpr bool empty(void) const
+    {
+        return raw_ == 0U;
+    }
+
+    friend constexpr flags operator|(const flags _a, const flags _b)
+    {
+        return from_raw(_a.raw_ | _b.raw_);
+    }
+
+    friend constexpr flags operator&(const flags _a, const flags _b)
+    {
+        return from_raw(_a.raw_ & _b.raw_);
+    }
+
+    friend constexpr bool operator==(const flags _a, const flags _b) = default;
+};
+
+/// Static event flags of a @ref flag_enum.
+/// The control block is a member, so event flags defined at namespace scope use neither the RTX
+/// object pool (OS_EVFLAGS_NUM) nor the heap. Define them in the OS control block section to keep
+/// them with other RTX objects:
+/// `static os::event_flags<ev> events __attribute__((section(".bss.os.evflags.cb")));`.
+/// Every call is a single inline osEventFlagsXxx call with a constant mask; set and destroy also
+/// notify the @ref waiters hook, one atomic load when nobody waits without a thread. set, clear,
+/// get and waits with timeout 0 may be called from interrupts.
+/// \tparam E            flag enum.
+template <flag_enum E>
+class event_flags
+{
+private:
+    osRtxEventFlags_t cb_;
+    waiters waiters_;
+
+public:
+    using flags_t = flags<E>;
+
+    constexpr event_flags(): cb_(), waiters_() {}
+
+    event_flags(const event_flags &) = delete;
+    event_flags &operator=(const event_flags &) = delete;
+
+    /// Create the event flags (the kernel must be initialized).
+    /// \param[in]     name          name of the event flags (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t create(const char *_name = nullptr)
+    {
+        const osEventFlagsAttr_t attr =
+        {
+            .name       = _name,
+            .attr_bits  = 0U,
+            .cb_mem     = &cb_,
+            .cb_size    = sizeof(cb_),
+        };
+
+        return (osEventFlagsNew(&attr) != nullptr) ? sts_t::OK : sts_t::err;
+    }
+
+    /// Get the event flags ID.
+    /// \return event flags ID for reference by other functions.
+    osEventFlagsId_t get_id(void)
+    {
+        return &cb_;
+    }
+
+    /// Get name of the event flags.
+    /// \return name as null-terminated string.
+    const char *get_name(void)
+    {
+        return osEventFlagsGetName(&cb_);
+    }
+
+    /// Set flags.
+    /// \return flags after setting or an error.
+    flags_t set(const flags_t _flags)
+    {
+        const flags_t result = flags_t::from_raw(osEventFlagsSet(&cb_, _flags.raw()));
+        if (!result.is_error())
+        {
+            waiters_.notify();
+        }
+        return result;
+    }
+
+    /// Clear flags.
+    /// \return flags before clearing or an error.
+    flags_t clear(const flags_t _flags)
+    {
+        return flags_t::from_raw(osEventFlagsClear(&cb_, _flags.raw()));
+    }
+
+    /// \return current flags.
+    flags_t get(void)
+    {
+        return flags_t::from_raw(osEventFlagsGet(&cb_));
+    }
+
+    /// Wait for any of the flags.
+    /// \param[in]     flags         flags to wait for.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     clear         clear the awaited flags on return.
+    /// \return flags before clearing or an error (@ref flags::status).
+    flags_t wait_any(const flags_t _flags, const uint32_t _timeout = forever, const bool _clear = true)
+    {
+        return flags_t::from_raw(osEventFlagsWait(&cb_, _flags.raw(), osFlagsWaitAny | (_clear ? 0U : osFlagsNoClear), _timeout));
+    }
+
+    /// Wait for any of the flags.
+    /// \param[in]     flags         flags to wait for.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \param[in]     clear         clear the awaited flags on return.
+    /// \return flags before clearing or an error (@ref flags::status).
+    template <class _rep, class _period>
+    flags_t wait_any(const flags_t _flags, const std::chrono::duration<_rep, _period> &_timeout, const bool _clear = true)
+    {
+        return wait_any(_flags, to_ticks(_timeout).count(), _clear);
+    }
+
+    /// Wait for all of the flags.
+    /// \param[in]     flags         flags to wait for.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     clear         clear the awaited flags on return.
+    /// \return flags before clearing or an error (@ref flags::status).
+    flags_t wait_all(const flags_t _flags, const uint32_t _timeout = forever, const bool _clear = true)
+    {
+        return flags_t::from_raw(osEventFlagsWait(&cb_, _flags.raw(), osFlagsWaitAll | (_clear ? 0U : osFlagsNoClear), _timeout));
+    }
+
+    /// Wait for all of the flags.
+    /// \param[in]     flags         flags to wait for.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \param[in]     clear         clear the awaited flags on return.
+    /// \return flags before clearing or an error (@ref flags::status).
+    template <class _rep, class _period>
+    flags_t wait_all(const flags_t _flags, const std::chrono::duration<_rep, _period> &_timeout, const bool _clear = true)
+    {
+        return wait_all(_flags, to_ticks(_timeout).count(), _clear);
+    }
+
+    /// Delete the event flags. Waiting threads are woken with @ref sts_t::err_resource.
+    /// \return status code that indicates the execution status of the function.
+    sts_t destroy(void)
+    {
+        const sts_t sts = static_cast<sts_t>(osEventFlagsDelete(&cb_));
+        waiters_.notify();
+        return sts;
+    }
+
+    /// Get the completion hook (for waiting without a thread, see @ref waiters).
+    waiters &get_waiters(void)
+    {
+        return waiters_;
+    }
+};
+
+} // namespace os
@@ -0,0 +1,210 @@
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+#include "rtx_os.h"
+#include "RTX_Config.h"
+
+#include "idle.h"
+
+namespace os::idle
+{
+
+static_assert(OS_IDLE_THREAD_STACK_SIZE >= 256, "Tickless idle needs OS_IDLE_THREAD_STACK_SIZE of at least 256 bytes.");
+
+/// Written by the idle thread only; readers use the sequence counter (odd while updating).
+static volatile uint32_t seq;
+static volatile uint32_t sleep_ticks_total;
+static volatile uint32_t sleeps_total;
+
+/// Baseline set by @ref reset_stats.
+static stats_t base;
+
+static void account(const uint32_t _slept)
+{
+    seq = seq + 1U;
+    __DMB();
+    sleep_ticks_total = sleep_ticks_total + _slept;
+    sleeps_total = sleeps_total + 1U;
+    __DMB();
+    seq = seq + 1U;
+}
+
+static void read(stats_t &_stats)
+{
+    uint32_t s;
+    do
+    {
+        s = seq;
+        __DMB();
+        _stats.sleep_ticks = sleep_ticks_total;
+        _stats.sleeps = sleeps_total;
+        __DMB();
+    }
+    while ((s & 1U) != 0U || s != seq);
+    _stats.ticks = kernel::get_tick_count();
+}
+
+stats_t get_stats(void)
+{
+    stats_t stats;
+    read(stats);
+
+    const sts_t lock = kernel::lock();
+    stats.ticks -= base.ticks;
+    stats.sleep_ticks -= base.sleep_ticks;
+    stats.sleeps -= base.sleeps;
+    kernel::restore_lock(lock);
+
+    return stats;
+}
+
+void reset_stats(void)
+{
+    stats_t stats;
+    read(stats);
+
+    const sts_t lock = kernel::lock();
+    base = stats;
+    kernel::restore_lock(lock);
+}
+
+/// Ticks to the next timeout as osKernelSuspend computes them, read without suspending the kernel.
+/// Suspending stops SysTick and resuming without a sleep loses the counts in between, so the idle
+/// thread suspends only when a sleep is possible. The lists are read without the kernel lock: the
+/// idle thread runs only when no thread is ready, and an interrupt that changes them meanwhile at
+/// worst makes it wait for the next interrupt instead of sleeping, or suspend in vain.
+static uint32_t next_timeout(void)
+{
+    uint32_t ticks = osWaitForever;
+    const osRtxThread_t *const thread = osRtxInfo.thread.delay_list;
+    if (thread != nullptr)
+    {
+        ticks = thread->delay;
+    }
+    const osRtxTimer_t *const timer = osRtxInfo.timer.list;
+    if (timer != nullptr && timer->tick < ticks)
+    {
+        ticks = timer->tick;
+    }
+    return ticks;
+}
+
+/// The core clock (and the DWT cycle counter with it) stops in sleep unless a debugger keeps it
+/// running: add the cycles slept, so os::timestamp and os::load keep counting real time.
+/// \param[in]     counts        SysTick counts slept (SysTick runs on the core clock).
+static void add_cycles(const uint32_t _counts)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U && (DBGMCU->CR & DBGMCU_CR_DBG_SLEEP) == 0U)
+    {
+        DWT->CYCCNT = DWT->CYCCNT + _counts;
+    }
+}
+
+/// Sleep until the next interrupt with the tick running. The interrupt is taken only after the
+/// SysTick counts slept are added to the cycle counter (@ref add_cycles).
+static void wait(void)
+{
+    __disable_irq();
+
+    (void)SysTick->CTRL;    // Clears COUNTFLAG
+    const uint32_t before = SysTick->VAL;
+
+    __DSB();
+    __WFI();
+
+    const bool wrapped = (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U;
+    const uint32_t after = SysTick->VAL;
+    add_cycles(wrapped ? before + SysTick->LOAD + 1U - after : before - after);
+
+    __enable_irq();
+}
+
+/// Tick period to restore after @ref kernel::resume (0 - none).
+static uint32_t tick_reload;
+
+/// Sleep with the kernel tick stopped. SysTick (the RTX tick) is reprogrammed as the wake-up
+/// timer while PRIMASK is set, so its handler does not run; the pending exception only ends WFI.
+/// The sleep ends at a tick boundary, or on early wake-up SysTick is left loaded with the rest of
+/// the tick, so the time of the current tick before and after the sleep is not lost.
+/// \param[in]     ticks         result of @ref kernel::suspend.
+/// \return elapsed whole ticks.
+static uint32_t sleep(const uint32_t _ticks)
+{
+    const uint32_t reload = SysTick->LOAD + 1U;
+    const uint32_t ticks = sleep_ticks(_ticks, reload, SysTick_LOAD_RELOAD_Msk + 1U);
+    if (ticks == 0U)
+    {
+        return 0U;
+    }
+
+    __disable_irq();
+
+    // Counts of the current tick elapsed before the kernel stopped the timer
+    const uint32_t phase = reload - 1U - SysTick->VAL;
+    const uint32_t load = ticks * reload - phase;
+
+    SysTick->LOAD = load - 1U;
+    SysTick->VAL  = 0U;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+
+    const bool expired = (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U;
+    const uint32_t val = SysTick->VAL;
+    const uint32_t slept = slept_counts(load, val, expired);
+
+    add_cycles(slept);
+
+    // Stop the wake-up timer and load the rest of the tick: the kernel enables the timer on
+    // resume, which takes the first period, and the idle thread then restores the tick period
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+    SCB->ICSR     = SCB_ICSR_PENDSTCLR_Msk;
+    SysTick->LOAD = first_tick_counts(phase + slept, reload) - 1U;
+    SysTick->VAL  = 0U;
+    tick_reload   = reload;
+
+    __enable_irq();
+
+    return slept_ticks(phase + slept, reload);
+}
+
+/// Restore the tick period for the reloads after the first tick.
+static void restore_tick(void)
+{
+    if (tick_reload != 0U)
+    {
+        SysTick->LOAD = tick_reload - 1U;
+        tick_reload = 0U;
+    }
+}
+
+} // namespace os::idle
+
+/// OS Idle Thread (replaces the weak one of RTX_Config.c).
+extern "C" __NO_RETURN void osRtxIdleThread(void *argument);
+void osRtxIdleThread(void *argument)
+{
+    (void)argument;
+
+    for (;;)
+    {
+        if (os::idle::next_timeout() < os::idle::min_sleep_ticks)
+        {
+            // Next timeout is too close to stop the tick: sleep until the next interrupt
+            os::idle::wait();
+            continue;
+        }
+
+        const uint32_t ticks = os::kernel::suspend();
+        const uint32_t slept = os::idle::sleep(ticks);
+
+        os::kernel::resume(slept);
+        os::idle::restore_tick();
+
+        if (slept != 0U)
+        {
+            os::idle::account(slept);
+        }
+    }
+}
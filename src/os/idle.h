@@ -0,0 +1,94 @@
+#pragma once
+
+#include "os.h"
+
+/// Tickless idle.
+/// The idle thread suspends the kernel tick (@ref kernel::suspend), lets the system timer wake the
+/// CPU at the next timeout, sleeps and compensates the tick count (@ref kernel::resume).
+namespace os::idle
+{
+
+/// Idle statistics.
+struct stats_t
+{
+    uint32_t ticks;          ///< Kernel ticks since @ref reset_stats.
+    uint32_t sleep_ticks;    ///< Kernel ticks spent in sleep.
+    uint32_t sleeps;         ///< Number of sleep periods.
+
+    /// \return sleep share in per mille (0 - always running, 1000 - always sleeping).
+    uint32_t sleep_permille(void) const
+    {
+        return (ticks != 0U) ? static_cast<uint32_t>(static_cast<uint64_t>(sleep_ticks) * 1000U / ticks) : 0U;
+    }
+};
+
+/// Minimal sleep period in ticks. Shorter periods are not worth stopping the tick.
+constexpr uint32_t min_sleep_ticks = 2U;
+
+/// Number of ticks to program for the wake-up timer.
+/// \param[in]     ticks         result of @ref kernel::suspend (time to the next timeout).
+/// \param[in]     reload        system timer counts per tick.
+/// \param[in]     range         system timer range in counts (e.g. 2^24 for SysTick).
+/// \return ticks to sleep (0 - do not sleep).
+constexpr uint32_t sleep_ticks(const uint32_t _ticks, const uint32_t _reload, const uint32_t _range)
+{
+    const uint32_t max = (_reload != 0U) ? _range / _reload : 0U;
+    if (_ticks < min_sleep_ticks || max == 0U)
+    {
+        return 0U;
+    }
+    return (_ticks < max) ? _ticks : max;
+}
+
+/// Number of system timer counts elapsed in sleep.
+/// \param[in]     load          programmed sleep in counts.
+/// \param[in]     val           down-counter value at wake-up.
+/// \param[in]     expired       timer reached zero (it has reloaded and counts down again).
+/// \return elapsed counts.
+constexpr uint32_t slept_counts(const uint32_t _load, const uint32_t _val, const bool _expired)
+{
+    const uint32_t elapsed = (_val < _load) ? _load - 1U - _val : 0U;
+    return _expired ? _load + elapsed : elapsed;
+}
+
+/// Number of whole ticks elapsed in sleep (for @ref kernel::resume).
+/// The partial tick is not dropped: the rest of it is the first tick period after the wake-up
+/// (@ref first_tick_counts), so the kernel tick keeps its phase. A tick with less than a quarter
+/// left is counted at once and its rest added to the first period, which leaves the idle thread
+/// time to restore the tick period after @ref kernel::resume.
+/// \param[in]     counts        counts elapsed since the last tick before the sleep.
+/// \param[in]     reload        system timer counts per tick.
+/// \return elapsed whole ticks.
+constexpr uint32_t slept_ticks(const uint32_t _counts, const uint32_t _reload)
+{
+    const uint32_t ticks = _counts / _reload;
+    return (_reload - _counts % _reload < _reload / 4U) ? ticks + 1U : ticks;
+}
+
+/// Length of the first tick period after the wake-up (see @ref slept_ticks).
+/// \param[in]     counts        counts elapsed since the last tick before the sleep.
+/// \param[in]     reload        system timer counts per tick.
+/// \return counts to the next tick.
+constexpr uint32_t first_tick_counts(const uint32_t _counts, const uint32_t _reload)
+{
+    const uint32_t rest = _reload - _counts % _reload;
+    return (rest < _reload / 4U) ? rest + _reload : rest;
+}
+
+static_assert(sleep_ticks(1U, 100000U, 1U << 24) == 0U);
+static_assert(sleep_ticks(0xFFFFFFFFU, 100000U, 1U << 24) == 167U);
+static_assert(sleep_ticks(50U, 100000U, 1U << 24) == 50U);
+static_assert(slept_ticks(50U * 100000U, 100000U) == 50U && first_tick_counts(50U * 100000U, 100000U) == 100000U);
+static_assert(slept_ticks(19U * 100000U + 30000U, 100000U) == 19U && first_tick_counts(19U * 100000U + 30000U, 100000U) == 70000U);
+static_assert(slept_ticks(19U * 100000U + 90000U, 100000U) == 20U && first_tick_counts(19U * 100000U + 90000U, 100000U) == 110000U);
+static_assert(slept_counts(5000000U, 4999999U, false) == 0U);
+static_assert(slept_counts(5000000U, 999999U, false) == 4000000U);
+static_assert(slept_counts(5000000U, 4999989U, true) == 5000010U);
+
+/// Get idle statistics (safe to call from any thread).
+stats_t get_stats(void);
+
+/// Restart idle statistics.
+void reset_stats(void);
+
+} // namespace os::idle
@@ -0,0 +1,225 @@
+#include <atomic>
+
+#include "rtx_os.h"
+
+#include "thread.h"
+#include "isr.h"
+
+namespace os::isr
+{
+
+static_assert((OS_ISR_DEFERRED_QUEUE_SIZE & (OS_ISR_DEFERRED_QUEUE_SIZE - 1)) == 0, "Deferred work queue size must be a power of two.");
+
+/// Thread flag that wakes the worker.
+static constexpr uint32_t flag_work = 1U;
+
+/// Bounded multi-producer single-consumer queue (D. Vyukov's sequence-per-slot scheme).
+/// Producers claim a position with a CAS on the head and publish the slot through its sequence,
+/// so handlers of different priorities may preempt each other. Sequences are kept relative to
+/// the slot index, so the all-zero initial state (.bss) is valid.
+class queue_t
+{
+    static constexpr uint32_t size_ = OS_ISR_DEFERRED_QUEUE_SIZE;
+    static constexpr uint32_t mask_ = size_ - 1U;
+
+    struct slot_t
+    {
+        std::atomic<uint32_t> seq;
+        func_t                func;
+        uint32_t              arg;
+        uint32_t              stamp;
+    };
+
+    std::atomic<uint32_t> head_;
+    std::atomic<uint32_t> tail_;
+    slot_t                slots_[size_];
+
+public:
+    /// \return queue depth after the post or 0 if the queue is full.
+    uint32_t push(const func_t _func, const uint32_t _arg, const uint32_t _stamp)
+    {
+        uint32_t pos = head_.load(std::memory_order_relaxed);
+        slot_t *slot;
+        for (;;)
+        {
+            slot = &slots_[pos & mask_];
+            const int32_t diff = static_cast<int32_t>(slot->seq.load(std::memory_order_acquire) - (pos & ~mask_));
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return 0U;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->func = _func;
+        slot->arg = _arg;
+        slot->stamp = _stamp;
+        slot->seq.store((pos & ~mask_) + 1U, std::memory_order_release);
+
+        return pos + 1U - tail_.load(std::memory_order_relaxed);
+    }
+
+    /// Consumer only.
+    /// \return false if the queue is empty (or the next item is not published yet).
+    bool pop(func_t &_func, uint32_t &_arg, uint32_t &_stamp)
+    {
+        const uint32_t pos = tail_.load(std::memory_order_relaxed);
+        slot_t &slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != (pos & ~mask_) + 1U)
+        {
+            return false;
+        }
+        _func = slot.func;
+        _arg = slot.arg;
+        _stamp = slot.stamp;
+        slot.seq.store((pos & ~mask_) + size_, std::memory_order_release);
+        tail_.store(pos + 1U, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint32_t depth(void) const
+    {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+};
+
+static queue_t queue;
+
+/// Worker needs a wake-up (cleared by the worker before it drains the queue).
+static std::atomic<bool> signalled;
+
+/// Updated by producers.
+static std::atomic<uint32_t> posted;
+static std::atomic<uint32_t> dropped;
+static std::atomic<uint32_t> depth_max;
+
+/// Updated by the worker only; read under the kernel lock.
+static uint32_t executed;
+static uint32_t batches;
+static uint32_t latency_max;
+static uint64_t latency_sum;
+
+class worker: public thread<worker, OS_ISR_DEFERRED_STACK_SIZE, priority::ISR>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            signalled.store(false, std::memory_order_seq_cst);
+
+            func_t func;
+            uint32_t arg;
+            uint32_t stamp;
+            uint32_t cnt = 0U;
+            while (queue.pop(func, arg, stamp))
+            {
+                const uint32_t latency = kernel::get_sys_timer_count() - stamp;
+                func(arg);
+                cnt++;
+                latency_sum += latency;
+                if (latency > latency_max)
+                {
+                    latency_max = latency;
+                }
+            }
+            if (cnt != 0U)
+            {
+                executed += cnt;
+                batches++;
+            }
+
+            osThreadFlagsWait(flag_work, osFlagsWaitAny, osWaitForever);
+        }
+    }
+};
+
+/// The ISR FIFO entry of the worker wake-up (the worker thread adds the rest when it starts).
+constexpr config::usage_t fifo_usage = {.threads = 0U, .stack = 0U, .isr_fifo = 1U};
+
+static_assert(config::usage_of<worker>() + fifo_usage == usage, "os::isr::usage does not match the worker thread.");
+
+static worker worker_thread;
+static bool fifo_added;
+
+sts_t start(void)
+{
+    if (!fifo_added)
+    {
+        if (!config::add(fifo_usage, "isr"))
+        {
+            return sts_t::err_nomem;
+        }
+        fifo_added = true;
+    }
+    return worker_thread.start("isr");
+}
+
+bool post(const func_t _func, const uint32_t _arg)
+{
+    const uint32_t depth = queue.push(_func, _arg, kernel::get_sys_timer_count());
+    if (depth == 0U)
+    {
+        dropped.fetch_add(1U, std::memory_order_relaxed);
+        return false;
+    }
+    posted.fetch_add(1U, std::memory_order_relaxed);
+
+    uint32_t max = depth_max.load(std::memory_order_relaxed);
+    while (depth > max && !depth_max.compare_exchange_weak(max, depth, std::memory_order_relaxed))
+    {
+    }
+
+    if (!signalled.exchange(true, std::memory_order_seq_cst))
+    {
+        osThreadFlagsSet(worker_thread.get_id(), flag_work);
+    }
+    return true;
+}
+
+uint32_t get_depth(void)
+{
+    return queue.depth();
+}
+
+stats_t get_stats(void)
+{
+    const sts_t lock = kernel::lock();
+    const stats_t stats =
+    {
+        .posted      = posted.load(std::memory_order_relaxed),
+        .dropped     = dropped.load(std::memory_order_relaxed),
+        .executed    = executed,
+        .batches     = batches,
+        .depth_max   = depth_max.load(std::memory_order_relaxed),
+        .latency_max = latency_max,
+        .latency_sum = latency_sum,
+    };
+    kernel::restore_lock(lock);
+
+    return stats;
+}
+
+void reset_stats(void)
+{
+    const sts_t lock = kernel::lock();
+    posted.store(0U, std::memory_order_relaxed);
+    dropped.store(0U, std::memory_order_relaxed);
+    depth_max.store(0U, std::memory_order_relaxed);
+    executed = 0U;
+    batches = 0U;
+    latency_max = 0U;
+    latency_sum = 0U;
+    kernel::restore_lock(lock);
+}
+
+} // namespace os::isr
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "os.h"
+#include "config.h"
+
+#ifndef OS_ISR_DEFERRED_QUEUE_SIZE
+    #define OS_ISR_DEFERRED_QUEUE_SIZE 64  ///< Deferred work queue size in items (power of two)
+#endif
+
+#ifndef OS_ISR_DEFERRED_STACK_SIZE
+    #define OS_ISR_DEFERRED_STACK_SIZE 512 ///< Stack size of the deferred work thread in bytes
+#endif
+
+/// Deferred interrupt handling.
+/// Interrupt handlers post small work items (function and argument) into a lock-free queue; a
+/// single thread of @ref priority::ISR drains the queue in batches. A post costs a few
+/// LDREX/STREX-protected stores, and the worker is signalled only when it is not already
+/// draining, so a burst takes one RTX ISR queue entry (see OS_ISR_FIFO_QUEUE) instead of one per
+/// interrupt. Work items run in thread context and may use any RTOS call.
+namespace os::isr
+{
+
+/// Kernel resources of deferred work (see @ref config::check): the worker thread and one ISR FIFO
+/// entry for the coalesced wake-up.
+constexpr config::usage_t usage = {.threads = 1U, .stack = OS_ISR_DEFERRED_STACK_SIZE, .isr_fifo = 1U};
+
+/// Work item function.
+using func_t = void (*)(uint32_t _arg);
+
+/// Deferred work statistics.
+struct stats_t
+{
+    uint32_t posted;        ///< Items posted.
+    uint32_t dropped;       ///< Items lost because the queue was full.
+    uint32_t executed;      ///< Items executed.
+    uint32_t batches;       ///< Worker wake-ups that found work.
+    uint32_t depth_max;     ///< Highest queue depth seen by a post.
+    uint32_t latency_max;   ///< Longest post-to-execution time in system timer counts.
+    uint64_t latency_sum;   ///< Sum of post-to-execution times in system timer counts.
+
+    /// \return average post-to-execution time in system timer counts.
+    uint32_t latency_avg(void) const
+    {
+        return (executed != 0U) ? static_cast<uint32_t>(latency_sum / executed) : 0U;
+    }
+};
+
+/// Start the deferred work thread (the kernel must be initialized).
+/// Items posted before start are executed once the kernel runs.
+/// \return status code that indicates the execution status of the function.
+sts_t start(void);
+
+/// Post a work item. Callable from any interrupt priority and from threads.
+/// \param[in]     func          work item function.
+/// \param[in]     arg           work item argument.
+/// \return false if the queue is full (the item is dropped and counted).
+bool post(const func_t _func, const uint32_t _arg = 0U);
+
+/// \return current number of queued items.
+uint32_t get_depth(void);
+
+/// Get deferred work statistics.
+stats_t get_stats(void);
+
+/// Restart deferred work statistics.
+void reset_stats(void);
+
+} // namespace os::isr
@@ -0,0 +1,105 @@
+#include <stdio.h>
+
+#if (OS_LOAD_DWT != 0)
+    #include "RTE_Components.h"
+    #include CMSIS_device_header
+#endif
+
+#include "rtx_os.h"
+
+#include "load.h"
+
+namespace os::load
+{
+
+/// Updated by the thread switch hook; other readers hold the kernel lock.
+static accounting<OS_LOAD_THREAD_NUM> acc;
+
+static inline uint32_t timer_count(void)
+{
+#if (OS_LOAD_DWT != 0)
+    return DWT->CYCCNT;
+#else
+    return osKernelGetSysTimerCount();
+#endif
+}
+
+static inline uint32_t timer_freq(void)
+{
+#if (OS_LOAD_DWT != 0)
+    return SystemCoreClock;
+#else
+    return osKernelGetSysTimerFreq();
+#endif
+}
+
+void init(void)
+{
+#if (OS_LOAD_DWT != 0)
+    // Not reset: the counter is also the os::timestamp time base
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    reset();
+}
+
+void snapshot(snapshot_t &_snapshot)
+{
+    const sts_t lock = kernel::lock();
+    acc.update(timer_count());
+    _snapshot.threads = acc;
+    kernel::restore_lock(lock);
+
+    _snapshot.total = _snapshot.threads.total();
+    _snapshot.freq = timer_freq();
+}
+
+void reset(void)
+{
+    const sts_t lock = kernel::lock();
+    acc.reset(timer_count());
+    kernel::restore_lock(lock);
+}
+
+void dump(void)
+{
+    static snapshot_t snap;
+    snapshot(snap);
+    reset();
+
+    const uint32_t ms = (snap.freq != 0U) ? static_cast<uint32_t>(snap.total * 1000U / snap.freq) : 0U;
+    printf("CPU load for %u ms:\n", ms);
+    for (uint32_t i = 0U; i < OS_LOAD_THREAD_NUM && snap.threads[i].id != nullptr; i++)
+    {
+        const char *name = osThreadGetName(const_cast<void *>(snap.threads[i].id));
+        const uint32_t permille = snap.permille(i);
+        printf("  %-16s %3u.%u%% %u switches\n", (name != nullptr) ? name : "-",
+               permille / 10U, permille % 10U, snap.threads[i].switches);
+    }
+    const struct
+    {
+        const char *name;
+        const accounting<OS_LOAD_THREAD_NUM>::slot_t &slot;
+    } extra[] =
+    {
+        {"(other)", snap.threads.other()},
+        {"(idle)",  snap.threads.idle()},
+    };
+    for (const auto &e : extra)
+    {
+        if (e.slot.switches != 0U && snap.total != 0U)
+        {
+            const uint32_t permille = static_cast<uint32_t>(e.slot.time * 1000U / snap.total);
+            printf("  %-16s %3u.%u%% %u switches\n", e.name, permille / 10U, permille % 10U, e.slot.switches);
+        }
+    }
+}
+
+} // namespace os::load
+
+/// RTX thread switch event (overrides the weak Event Recorder function of RTX).
+extern "C" void EvrRtxThreadSwitched(osThreadId_t thread_id);
+void EvrRtxThreadSwitched(osThreadId_t thread_id)
+{
+    os::load::acc.switched(thread_id, os::load::timer_count());
+}
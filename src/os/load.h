@@ -0,0 +1,159 @@
+#pragma once
+
+#include "os.h"
+
+#ifndef OS_LOAD_THREAD_NUM
+    #define OS_LOAD_THREAD_NUM 16 ///< Number of threads with individual statistics (others are summed up)
+#endif
+
+#ifndef OS_LOAD_DWT
+    #define OS_LOAD_DWT 0 ///< 1 - DWT cycle counter (see os/timestamp.h), 0 - kernel system timer
+#endif
+
+/// Per-thread CPU load.
+/// The RTX thread switch event (EvrRtxThreadSwitched, enabled by the operation level of
+/// OS_EVR_THREAD_LEVEL) charges the time since the previous switch to the thread that ran.
+/// The hook costs a timer read and a short table lookup per switch.
+/// The 32-bit time base wraps (e.g. after 42 s at 100 MHz): take a snapshot at least that often
+/// if a single thread may run longer without a switch.
+namespace os::load
+{
+
+/// Time accounting per thread (kernel independent, so it can be tested on a host).
+/// \tparam N            number of threads with individual statistics.
+template <uint32_t N>
+class accounting
+{
+public:
+    struct slot_t
+    {
+        const void *id;         ///< Thread ID (null - free slot).
+        uint64_t    time;       ///< Accumulated run time in timer counts.
+        uint32_t    switches;   ///< Number of times the thread was switched in.
+    };
+
+private:
+    slot_t   slots_[N];
+    slot_t   other_;            ///< Threads that did not fit into the table.
+    slot_t   idle_;             ///< No thread running (reported as a null ID, e.g. by the host simulator).
+    slot_t  *curr_;             ///< Running thread (null before the first switch).
+    uint32_t stamp_;            ///< Time of the last switch or update.
+
+    slot_t *find(const void *_id)
+    {
+        if (_id == nullptr)
+        {
+            return &idle_;
+        }
+        for (slot_t &slot : slots_)
+        {
+            if (slot.id == _id)
+            {
+                return &slot;
+            }
+            if (slot.id == nullptr)
+            {
+                slot.id = _id;
+                return &slot;
+            }
+        }
+        return &other_;
+    }
+
+public:
+    constexpr accounting(): slots_(), other_(), idle_(), curr_(nullptr), stamp_(0U) {}
+
+    /// Thread switch.
+    /// \param[in]     id            thread switched in (null - none).
+    /// \param[in]     now           timer count.
+    void switched(const void *_id, const uint32_t _now)
+    {
+        update(_now);
+        curr_ = find(_id);
+        curr_->switches++;
+    }
+
+    /// Charge the running thread up to now.
+    /// \param[in]     now           timer count.
+    void update(const uint32_t _now)
+    {
+        if (curr_ != nullptr)
+        {
+            curr_->time += _now - stamp_;
+        }
+        stamp_ = _now;
+    }
+
+    /// Clear accumulated times and switch counts (thread IDs are kept).
+    /// \param[in]     now           timer count.
+    void reset(const uint32_t _now)
+    {
+        for (slot_t &slot : slots_)
+        {
+            slot.time = 0U;
+            slot.switches = 0U;
+        }
+        other_.time = 0U;
+        other_.switches = 0U;
+        idle_.time = 0U;
+        idle_.switches = 0U;
+        stamp_ = _now;
+    }
+
+    const slot_t &operator[](const uint32_t _idx) const
+    {
+        return slots_[_idx];
+    }
+
+    /// \return statistics of threads that did not fit into the table.
+    const slot_t &other(void) const
+    {
+        return other_;
+    }
+
+    /// \return statistics of the time without a running thread.
+    const slot_t &idle(void) const
+    {
+        return idle_;
+    }
+
+    /// \return accumulated time of all threads.
+    uint64_t total(void) const
+    {
+        uint64_t sum = other_.time + idle_.time;
+        for (const slot_t &slot : slots_)
+        {
+            sum += slot.time;
+        }
+        return sum;
+    }
+};
+
+/// Load statistics at one moment.
+struct snapshot_t
+{
+    accounting<OS_LOAD_THREAD_NUM> threads;   ///< Per-thread times, in table order.
+    uint64_t                       total;     ///< Time covered by the snapshot in timer counts.
+    uint32_t                       freq;      ///< Timer frequency in hertz.
+
+    /// \return share of a thread in per mille.
+    uint32_t permille(const uint32_t _idx) const
+    {
+        return (total != 0U) ? static_cast<uint32_t>(threads[_idx].time * 1000U / total) : 0U;
+    }
+};
+
+/// Enable the time base (the DWT cycle counter if OS_LOAD_DWT) and restart the statistics.
+void init(void);
+
+/// Take a snapshot of the statistics.
+/// \param[out]    snapshot      statistics since @ref init or @ref reset.
+void snapshot(snapshot_t &_snapshot);
+
+/// Restart the statistics.
+void reset(void);
+
+/// Print the statistics (stdout, i.e. RTT channel 0) and restart them. Call it periodically.
+void dump(void);
+
+} // namespace os::load
@@ -5,24 +5,28 @@
 #define STRINGIFY(x) #x
 #define STR(x) STRINGIFY(x)
 #define printerr(_s, ...) fprintf(stderr, "\033[31mError:\033[0m '" __FILE__ "'[" STR(__LINE__) "] : " _s __VA_OPT__(,) __VA_ARGS__)
+#define printwarn(_s, ...) fprintf(stderr, "\033[33mWarning:\033[0m '" __FILE__ "'[" STR(__LINE__) "] : " _s __VA_OPT__(,) __VA_ARGS__)
 
 #define U32 "%#010x"
 
 #ifdef __cplusplus
 
+#include <chrono>
+
 constexpr unsigned long long operator "" _KiB(unsigned long long bytes)
 {
     return static_cast<unsigned long long>(bytes * 1024U);
 }
 
-constexpr unsigned long long operator "" _sec(long double sec)
+/// Seconds as a std::chrono duration (converted to ticks by os::to_ticks, see os/chrono.h).
+constexpr std::chrono::duration<long double> operator "" _sec(long double sec)
 {
-    return static_cast<unsigned long long>(sec * 1000U);
+    return std::chrono::duration<long double>(sec);
 }
 
-constexpr unsigned long long operator "" _sec(unsigned long long sec)
+constexpr std::chrono::seconds operator "" _sec(unsigned long long sec)
 {
-    return static_cast<unsigned long long>(sec * 1000U);
+    return std::chrono::seconds(static_cast<std::chrono::seconds::rep>(sec));
 }
 
 #endif // __cplusplus
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "os.h"
+#include "chrono.h"
+
+#include "rtx_os.h"
+
+namespace os
+{
+
+/// Mutex attributes.
+enum class mutex_attr : uint32_t
+{
+    none            = 0U,                   ///< Non-recursive, no priority inheritance, not robust.
+    recursive       = osMutexRecursive,     ///< The owner may acquire the mutex again (up to 255 times).
+    prio_inherit    = osMutexPrioInherit,   ///< Owner runs at the priority of the highest waiting thread.
+    robust          = osMutexRobust,        ///< Released automatically when the owner terminates.
+};
+
+constexpr mutex_attr operator|(const mutex_attr _a, const mutex_attr _b)
+{
+    return static_cast<mutex_attr>(static_cast<uint32_t>(_a) | static_cast<uint32_t>(_b));
+}
+
+/// Static mutex.
+/// The control block is a member, so a mutex defined at namespace scope uses neither the RTX
+/// object pool nor the heap. Define it in the OS control block section to keep it with other
+/// RTX objects: `static os::mutex<> mtx __attribute__((section(".bss.os.mutex.cb")));`.
+/// The mutex ID is the address of the control block, so acquire/release are plain
+/// osMutexAcquire/osMutexRelease calls with a constant argument.
+/// \tparam _attr        mutex attributes.
+template <mutex_attr _attr = mutex_attr::prio_inherit>
+class mutex
+{
+private:
+    osRtxMutex_t cb_;
+
+public:
+    static constexpr mutex_attr attr = _attr;
+
+    constexpr mutex(): cb_() {}
+
+    mutex(const mutex &) = delete;
+    mutex &operator=(const mutex &) = delete;
+
+    /// Create the mutex (the kernel must be initialized).
+    /// \param[in]     name          name of the mutex (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t create(const char *_name = nullptr)
+    {
+        const osMutexAttr_t attr =
+        {
+            .name       = _name,
+            .attr_bits  = static_cast<uint32_t>(_attr),
+            .cb_mem     = &cb_,
+            .cb_size    = sizeof(cb_),
+        };
+
+        return (osMutexNew(&attr) != nullptr) ? sts_t::OK : sts_t::err;
+    }
+
+    /// Get the mutex ID.
+    /// \return mutex ID for reference by other functions.
+    osMutexId_t get_id(void)
+    {
+        return &cb_;
+    }
+
+    /// Get name of the mutex.
+    /// \return name as null-terminated string.
+    const char *get_name(void)
+    {
+        return osMutexGetName(&cb_);
+    }
+
+    /// Acquire the mutex or timeout if it is locked.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return status code that indicates the execution status of the function.
+    sts_t acquire(const uint32_t _timeout = osWaitForever)
+    {
+        return static_cast<sts_t>(osMutexAcquire(&cb_, _timeout));
+    }
+
+    /// Acquire the mutex or timeout if it is locked.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t acquire(const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return acquire(to_ticks(_timeout).count());
+    }
+
+    /// Release the mutex that was acquired by @ref acquire.
+    /// \return status code that indicates the execution status of the function.
+    sts_t release(void)
+    {
+        return static_cast<sts_t>(osMutexRelease(&cb_));
+    }
+
+    /// Get the thread that owns the mutex.
+    /// \return thread ID of owner thread or NULL when the mutex was not acquired.
+    osThreadId_t get_owner(void)
+    {
+        return osMutexGetOwner(&cb_);
+    }
+
+    /// Delete the mutex. Waiting threads are woken with @ref sts_t::err_resource.
+    /// \return status code that indicates the execution status of the function.
+    sts_t destroy(void)
+    {
+        return static_cast<sts_t>(osMutexDelete(&cb_));
+    }
+};
+
+/// Scoped mutex lock: acquires in the constructor and releases in the destructor when the
+/// acquisition succeeded. Check @ref status before touching the protected data.
+/// \tparam _mutex       mutex type (anything with `sts_t acquire(uint32_t)` and `sts_t release()`).
+template <class _mutex>
+class lock_guard
+{
+private:
+    _mutex &mtx_;
+    const sts_t sts_;
+
+public:
+    /// \param[in]     mtx           mutex to lock.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    explicit lock_guard(_mutex &_mtx, const uint32_t _timeout = osWaitForever):
+        mtx_(_mtx),
+        sts_(_mtx.acquire(_timeout))
+    {
+    }
+
+    ~lock_guard()
+    {
+        if (sts_ == sts_t::OK)
+        {
+            mtx_.release();
+        }
+    }
+
+    lock_guard(const lock_guard &) = delete;
+    lock_guard &operator=(const lock_guard &) = delete;
+
+    /// \return status of the acquisition.
+    sts_t status(void) const
+    {
+        return sts_;
+    }
+
+    /// \return true if the mutex is held.
+    explicit operator bool(void) const
+    {
+        return sts_ == sts_t::OK;
+    }
+};
+
+} // namespace os
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+#include "os.h"
+#include "chrono.h"
+#include "event_flags.h"
+
+#include "rtx_os.h"
+
+/// Direct-to-thread notifications on thread flags.
+/// A notification needs no RTX object: the receiver is a thread, and the wake-up is one
+/// osThreadFlagsSet/osThreadFlagsWait pair. That saves the object, not time: on the host
+/// (tools/notify_bench) a wake-up costs the same as through a semaphore, as the context switch
+/// dominates, and without a waiter os::semaphore is cheaper as it does not enter the kernel.
+/// - Typed flags: @ref signal and @ref wait_any / @ref wait_all with a @ref flag_enum.
+/// - Counting mode: @ref counter, a counting semaphore for one receiving thread.
+/// - Value mode: @ref mailbox, the latest 31-bit value for one receiving thread.
+/// Counters and mailboxes occupy one thread flag of their receiver (template parameter _bit), which
+/// must not be used by other notifications of that thread. The receiver is the thread that waits
+/// first (or the one passed to bind), and everything sent before is kept. Sending is lock-free and
+/// callable from interrupts.
+namespace os::notify
+{
+
+/// Set typed flags of a thread.
+/// \param[in]     thread        thread ID.
+/// \param[in]     flags         flags to set.
+/// \return status code that indicates the execution status of the function.
+template <flag_enum E>
+inline sts_t signal(const osThreadId_t _thread, const flags<E> _flags)
+{
+    return flags<E>::from_raw(osThreadFlagsSet(_thread, _flags.raw())).status();
+}
+
+/// Wait for any of the typed flags of the current thread.
+/// \param[in]     flags         flags to wait for (cleared on return).
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return thread flags before clearing or an error (@ref flags::status).
+template <flag_enum E>
+inline flags<E> wait_any(const flags<E> _flags, const uint32_t _timeout = forever)
+{
+    const uint32_t result = osThreadFlagsWait(_flags.raw(), osFlagsWaitAny, _timeout);
+    return flags<E>::from_raw(((result & osFlagsError) != 0U) ? result : result & flags<E>::all);
+}
+
+/// Wait for all of the typed flags of the current thread.
+/// \param[in]     flags         flags to wait for (cleared on return).
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return thread flags before clearing or an error (@ref flags::status).
+template <flag_enum E>
+inline flags<E> wait_all(const flags<E> _flags, const uint32_t _timeout = forever)
+{
+    const uint32_t result = osThreadFlagsWait(_flags.raw(), osFlagsWaitAll, _timeout);
+    return flags<E>::from_raw(((result & osFlagsError) != 0U) ? result : result & flags<E>::all);
+}
+
+/// Ticks left of a timeout that started at a tick count.
+/// \param[in]     start         tick count at the start of the wait.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return ticks to wait (0 - expired).
+inline uint32_t remaining(const uint32_t _start, const uint32_t _timeout)
+{
+    if (_timeout == 0U || _timeout == forever)
+    {
+        return _timeout;
+    }
+    const uint32_t elapsed = osKernelGetTickCount() - _start;
+    return (elapsed < _timeout) ? _timeout - elapsed : 0U;
+}
+
+/// Receiver binding and wake-up of @ref counter and @ref mailbox.
+/// The sender updates its state and then reads the receiver; the receiver binds itself and then
+/// reads the state (both sequentially consistent), so one of them always sees the other.
+/// The receiver tries the state first and binds only when it finds nothing, so a pending
+/// notification is taken without a kernel call (osThreadGetId and osKernelGetTickCount are SVCs).
+template <uint32_t _bit>
+class receiver
+{
+    static_assert(_bit < 31U, "Thread flag bit must be in range 0..30.");
+
+private:
+    std::atomic<osThreadId_t> thread_;
+
+protected:
+    static constexpr uint32_t flag_ = 1U << _bit;
+
+    constexpr receiver(): thread_(nullptr) {}
+
+    /// Bind the current thread and start the timeout before the first sleep (receiver side).
+    /// The caller tries its state once more before it sleeps.
+    /// \param[out]    start         tick count at the start of the wait.
+    void bind_self(uint32_t &_start)
+    {
+        const osThreadId_t self = osThreadGetId();
+        if (thread_.load(std::memory_order_relaxed) != self)
+        {
+            thread_.store(self);
+        }
+        _start = osKernelGetTickCount();
+    }
+
+    /// Wake the receiver if it is known (sender side).
+    void wake(void)
+    {
+        const osThreadId_t thread = thread_.load();
+        if (thread != nullptr)
+        {
+            osThreadFlagsSet(thread, flag_);
+        }
+    }
+
+    /// Wait for a wake-up. The flag may be left over from a state already consumed, so the caller
+    /// checks its state again after any return.
+    /// \return status code that indicates the execution status of the function.
+    static sts_t sleep(const uint32_t _start, const uint32_t _timeout)
+    {
+        const uint32_t wait = remaining(_start, _timeout);
+        if (wait == 0U)
+        {
+            return (_timeout == 0U) ? sts_t::err_resource : sts_t::err_timeout;
+        }
+        const uint32_t result = osThreadFlagsWait(flag_, osFlagsWaitAny, wait);
+        return ((result & osFlagsError) != 0U) ? static_cast<sts_t>(static_cast<int32_t>(result)) : sts_t::OK;
+    }
+
+public:
+    receiver(const receiver &) = delete;
+    receiver &operator=(const receiver &) = delete;
+
+    /// Bind the receiving thread before it waits (optional).
+    /// \param[in]     thread        thread ID.
+    void bind(const osThreadId_t _thread)
+    {
+        thread_.store(_thread);
+    }
+};
+
+/// Counting notification: a counting semaphore for one receiving thread.
+/// \tparam _bit         thread flag of the receiver used for the wake-up.
+template <uint32_t _bit = 0U>
+class counter: public receiver<_bit>
+{
+private:
+    std::atomic<uint32_t> count_;
+
+public:
+    constexpr counter(): count_(0U) {}
+
+    /// Add one notification (lock-free, callable from interrupts).
+    void give(void)
+    {
+        if (count_.fetch_add(1U) == 0U)
+        {
+            this->wake();
+        }
+    }
+
+    /// Take one notification or timeout if there is none (receiving thread only).
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return status code that indicates the execution status of the function.
+    sts_t take(const uint32_t _timeout = forever)
+    {
+        bool bound = false;
+        uint32_t start = 0U;
+        sts_t sts = sts_t::OK;
+        for (;;)
+        {
+            uint32_t count = count_.load();
+            while (count != 0U)
+            {
+                if (count_.compare_exchange_weak(count, count - 1U))
+                {
+                    return sts_t::OK;
+                }
+            }
+            // Checked once more after a failed wait, a notification may have raced with the timeout
+            if (sts != sts_t::OK)
+            {
+                return sts;
+            }
+            if (!bound)
+            {
+                this->bind_self(start);
+                bound = true;
+                continue;
+            }
+            sts = this->sleep(start, _timeout);
+        }
+    }
+
+    /// Take one notification or timeout if there is none (receiving thread only).
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t take(const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return take(to_ticks(_timeout).count());
+    }
+
+    /// Take all notifications, waiting for at least one (receiving thread only).
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return number of notifications taken (0 - timeout).
+    uint32_t take_all(const uint32_t _timeout = forever)
+    {
+        bool bound = false;
+        uint32_t start = 0U;
+        sts_t sts = sts_t::OK;
+        for (;;)
+        {
+            const uint32_t count = count_.exchange(0U);
+            if (count != 0U || sts != sts_t::OK)
+            {
+                return count;
+            }
+            if (!bound)
+            {
+                this->bind_self(start);
+                bound = true;
+                continue;
+            }
+            sts = this->sleep(start, _timeout);
+        }
+    }
+
+    /// \return number of pending notifications.
+    uint32_t get_count(void) const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+};
+
+/// Value notification: a mailbox holding the latest value for one receiving thread.
+/// The value and its pending bit share one atomic word, so values are limited to 31 bits.
+/// \tparam T            value type (integral or enum type of at most 32 bits).
+/// \tparam _bit         thread flag of the receiver used for the wake-up.
+template <class T = uint32_t, uint32_t _bit = 0U>
+class mailbox: public receiver<_bit>
+{
+    static_assert((std::is_integral_v<T> || std::is_enum_v<T>) && sizeof(T) <= sizeof(uint32_t),
+                  "Mailbox values must be integral or enum types of at most 32 bits.");
+
+private:
+    static constexpr uint32_t pending_ = 0x80000000U;
+
+    std::atomic<uint32_t> state_;
+
+public:
+    /// Largest value that can be posted.
+    static constexpr uint32_t max_value = pending_ - 1U;
+
+    constexpr mailbox(): state_(0U) {}
+
+    /// Post a value, overwriting a value not yet received (lock-free, callable from interrupts).
+    /// \param[in]     value         value (at most @ref max_value).
+    /// \return @ref sts_t::err_parameter if the value does not fit, otherwise @ref sts_t::OK.
+    sts_t post(const T _value)
+    {
+        const uint32_t value = static_cast<uint32_t>(_value);
+        if (value > max_value)
+        {
+            return sts_t::err_parameter;
+        }
+        state_.store(pending_ | value);
+        this->wake();
+        return sts_t::OK;
+    }
+
+    /// Post a value unless a value is pending (lock-free, callable from interrupts).
+    /// \param[in]     value         value (at most @ref max_value).
+    /// \return status code (@ref sts_t::err_resource - a value is pending).
+    sts_t try_post(const T _value)
+    {
+        const uint32_t value = static_cast<uint32_t>(_value);
+        if (value > max_value)
+        {
+            return sts_t::err_parameter;
+        }
+        uint32_t state = state_.load();
+        do
+        {
+            if ((state & pending_) != 0U)
+            {
+                return sts_t::err_resource;
+            }
+        } while (!state_.compare_exchange_weak(state, pending_ | value));
+        this->wake();
+        return sts_t::OK;
+    }
+
+    /// Receive the pending value or timeout if there is none (receiving thread only).
+    /// \param[out]    value         value.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return status code that indicates the execution status of the function.
+    sts_t receive(T &_value, const uint32_t _timeout = forever)
+    {
+        bool bound = false;
+        uint32_t start = 0U;
+        sts_t sts = sts_t::OK;
+        for (;;)
+        {
+            const uint32_t state = state_.exchange(0U);
+            if ((state & pending_) != 0U)
+            {
+                _value = static_cast<T>(state & max_value);
+                return sts_t::OK;
+            }
+            if (sts != sts_t::OK)
+            {
+                return sts;
+            }
+            if (!bound)
+            {
+                this->bind_self(start);
+                bound = true;
+                continue;
+            }
+            sts = this->sleep(start, _timeout);
+        }
+    }
+
+    /// Receive the pending value or timeout if there is none (receiving thread only).
+    /// \param[out]    value         value.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t receive(T &_value, const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return receive(_value, to_ticks(_timeout).count());
+    }
+
+    /// \return true if a value is pending.
+    bool is_pending(void) const
+    {
+        return (state_.load(std::memory_order_relaxed) & pending_) != 0U;
+    }
+};
+
+} // namespace os::notify
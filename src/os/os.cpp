@@ -1,7 +1,9 @@
 #include "RTX_Config.h"
 #include "cmsis_os2.h"
+#include "rtx_os.h"
 
 #include "os.h"
+#include "chrono.h"
 
 namespace os
 {
@@ -12,9 +14,6 @@ static OT chck(const T _sts)
     return static_cast<OT>(_sts);
 }
 
-// Timeout value.
-constexpr uint32_t forever = 0xFFFFFFFFU; ///< Wait forever timeout value.
-
 /// Wait for Timeout (Time Delay).
 /// \param[in]     ticks         \ref CMSIS_RTOS_TimeOutValue "time ticks" value
 /// \return status code that indicates the execution status of the function.
@@ -30,6 +29,8 @@ sts_t delay_until(const uint32_t _ticks)
 {
     return chck(osDelayUntil(_ticks));
 }
+
+static_assert(forever == osWaitForever);
     
 namespace kernel
 {
@@ -1,3 +1,6 @@
+#pragma once
+
+#include <stdint.h>
 
 namespace os
 {
@@ -76,9 +79,10 @@ enum class sts_t : int32_t
 };
 
 /// Timeout value.
-extern const uint32_t forever; ///< Wait forever timeout value.
+constexpr uint32_t forever = 0xFFFFFFFFU; ///< Wait forever timeout value.
 
 /// Wait for Timeout (Time Delay).
+/// Prefer the std::chrono overload of chrono.h, which does not depend on the tick rate.
 /// \param[in]     ticks         \ref CMSIS_RTOS_TimeOutValue "time ticks" value
 /// \return status code that indicates the execution status of the function.
 sts_t delay(const uint32_t _ticks);
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace os
+{
+
+/// Fixed-block memory pool with static storage.
+/// Free blocks form a lock-free stack of block indices: alloc and free are one compare-and-swap
+/// of a 32-bit word (LDREX/STREX on Cortex-M4), so they are O(1) and may be called from threads
+/// and interrupts of any priority. The upper half of the word is a tag that changes with every
+/// operation, against the ABA problem of a thread preempted between reading and swapping the top.
+/// Blocks that were never used are handed out by a separate counter, so the pool needs no
+/// initialization: a zero-filled pool is full.
+/// \tparam T            block type (any type, the pool does not construct it unless @ref create is used).
+/// \tparam N            number of blocks.
+template <class T, uint32_t N>
+class pool
+{
+    static_assert(N != 0U && N < 0xFFFFU, "Pool size must be in range 1..65534.");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Pool free list must be lock-free.");
+
+private:
+    static constexpr uint32_t idx_mask_ = 0xFFFFU;      ///< Block index + 1 (0 - empty)
+    static constexpr uint32_t tag_step_ = 0x10000U;
+
+    std::atomic<uint32_t> head_;                        ///< Free list top: tag and index
+    std::atomic<uint32_t> fresh_;                       ///< Number of blocks ever taken
+    std::atomic<uint16_t> next_[N];                     ///< Free list links (index + 1)
+    alignas(T) uint8_t    mem_[N][sizeof(T)];
+
+    T *block(const uint32_t _idx)
+    {
+        return reinterpret_cast<T *>(mem_[_idx]);
+    }
+
+public:
+    static constexpr uint32_t capacity = N;
+    static constexpr size_t block_size = sizeof(T);
+    static constexpr size_t block_align = alignof(T);
+
+    constexpr pool(): head_(0U), fresh_(0U), next_(), mem_() {}
+
+    pool(const pool &) = delete;
+    pool &operator=(const pool &) = delete;
+
+    /// Allocate a block (lock-free, callable from interrupts).
+    /// \return uninitialized block or nullptr if the pool is exhausted.
+    T *alloc(void)
+    {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        while ((head & idx_mask_) != 0U)
+        {
+            const uint32_t idx = (head & idx_mask_) - 1U;
+            const uint32_t next = ((head & ~idx_mask_) + tag_step_) | next_[idx].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return block(idx);
+            }
+        }
+
+        uint32_t fresh = fresh_.load(std::memory_order_relaxed);
+        while (fresh < N)
+        {
+            if (fresh_.compare_exchange_weak(fresh, fresh + 1U, std::memory_order_relaxed))
+            {
+                return block(fresh);
+            }
+        }
+        return nullptr;
+    }
+
+    /// Return a block taken by @ref alloc (lock-free, callable from interrupts).
+    /// \param[in]     block         block (nullptr is ignored).
+    void free(void *_block)
+    {
+        if (_block == nullptr)
+        {
+            return;
+        }
+        const uint32_t idx = static_cast<uint32_t>((static_cast<uint8_t *>(_block) - mem_[0]) / sizeof(T));
+
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t next;
+        do
+        {
+            next_[idx].store(static_cast<uint16_t>(head & idx_mask_), std::memory_order_relaxed);
+            next = ((head & ~idx_mask_) + tag_step_) | (idx + 1U);
+        } while (!head_.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// Allocate a block and construct an object in it.
+    /// \param[in]     args          constructor arguments.
+    /// \return object or nullptr if the pool is exhausted.
+    template <class... _args>
+    T *create(_args &&..._arg)
+    {
+        T *obj = alloc();
+        return (obj != nullptr) ? new (obj) T(std::forward<_args>(_arg)...) : nullptr;
+    }
+
+    /// Destroy an object made by @ref create and return its block.
+    /// \param[in]     obj           object (nullptr is ignored).
+    void destroy(T *_obj)
+    {
+        if (_obj != nullptr)
+        {
+            _obj->~T();
+            free(_obj);
+        }
+    }
+
+    /// \return true if the pointer is a block of this pool.
+    bool owns(const void *_ptr) const
+    {
+        const uint8_t *ptr = static_cast<const uint8_t *>(_ptr);
+        return ptr >= mem_[0] && ptr < mem_[0] + sizeof(mem_) && (ptr - mem_[0]) % sizeof(T) == 0;
+    }
+
+    /// \return number of blocks that were never allocated (a lower bound of the free blocks).
+    uint32_t get_untouched(void) const
+    {
+        return N - fresh_.load(std::memory_order_relaxed);
+    }
+
+    /// Per-thread block cache.
+    /// Keeps up to K freed blocks for the next allocations of the owner, so a thread that
+    /// allocates and frees at a steady rate does not touch the shared free list. Owned by one
+    /// thread (not thread safe); the blocks return to the pool when it is flushed or destroyed.
+    /// \tparam K        cache size in blocks.
+    template <uint32_t K>
+    class cache
+    {
+        static_assert(K != 0U, "Cache size must not be zero.");
+
+    private:
+        pool     &pool_;
+        T        *blocks_[K];
+        uint32_t  count_;
+
+    public:
+        explicit constexpr cache(pool &_pool): pool_(_pool), blocks_(), count_(0U) {}
+
+        cache(const cache &) = delete;
+        cache &operator=(const cache &) = delete;
+
+        ~cache()
+        {
+            flush();
+        }
+
+        /// \return uninitialized block or nullptr if the pool is exhausted.
+        T *alloc(void)
+        {
+            return (count_ != 0U) ? blocks_[--count_] : pool_.alloc();
+        }
+
+        /// Return a block to the cache (to the pool if the cache is full).
+        void free(void *_block)
+        {
+            if (_block == nullptr)
+            {
+                return;
+            }
+            if (count_ < K)
+            {
+                blocks_[count_++] = static_cast<T *>(_block);
+            }
+            else
+            {
+                pool_.free(_block);
+            }
+        }
+
+        /// Return all cached blocks to the pool.
+        void flush(void)
+        {
+            while (count_ != 0U)
+            {
+                pool_.free(blocks_[--count_]);
+            }
+        }
+
+        /// \return number of cached blocks.
+        uint32_t get_count(void) const
+        {
+            return count_;
+        }
+    };
+};
+
+/// Pool as a std::pmr::memory_resource, so standard containers can allocate from it, e.g.
+/// `std::pmr::list<int> l(&res);` with a pool of list nodes. Requests that do not fit a block
+/// (or find the pool exhausted) go to the upstream resource, which throws std::bad_alloc by
+/// default. Deallocation checks the pointer range, so both kinds of blocks may be mixed.
+/// \tparam _pool        pool type (@ref pool).
+template <class _pool>
+class pool_resource: public std::pmr::memory_resource
+{
+private:
+    _pool &pool_;
+    std::pmr::memory_resource *upstream_;
+
+    void *do_allocate(const size_t _bytes, const size_t _align) override
+    {
+        if (_bytes <= _pool::block_size && _align <= _pool::block_align)
+        {
+            void *block = pool_.alloc();
+            if (block != nullptr)
+            {
+                return block;
+            }
+        }
+        return upstream_->allocate(_bytes, _align);
+    }
+
+    void do_deallocate(void *_ptr, const size_t _bytes, const size_t _align) override
+    {
+        if (pool_.owns(_ptr))
+        {
+            pool_.free(_ptr);
+        }
+        else
+        {
+            upstream_->deallocate(_ptr, _bytes, _align);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override
+    {
+        return this == &_other;
+    }
+
+public:
+    explicit pool_resource(_pool &_blocks, std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource()):
+        pool_(_blocks),
+        upstream_(_upstream)
+    {
+    }
+};
+
+} // namespace os
@@ -0,0 +1,2356 @@
+/// CMSIS-RTOS2 API subset on POSIX threads and CLOCK_MONOTONIC.
+/// Every RTX thread is a host thread. Kernel objects are protected by one kernel mutex and every
+/// blocking call ends in @ref block.
+/// Limitations: priorities are recorded but not enforced, the kernel lock only excludes the other
+/// threads that take it (it does not stop other host threads), suspend/terminate of another thread
+/// takes effect at its next blocking call.
+///
+/// With OS_POSIX_SIM=1 the backend is a deterministic virtual-time simulator instead: only one
+/// thread owns the CPU at a time, the highest priority ready thread runs (FIFO within a priority),
+/// a switch happens only at kernel calls, and the tick advances only when every thread is blocked,
+/// jumping straight to the nearest timeout. Runs repeat bit-for-bit and take no wall-clock time.
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <new>
+
+#include "RTX_Config.h"
+#include "cmsis_os2.h"
+#include "rtx_os.h"
+
+#ifndef OS_POSIX_SIM
+    #define OS_POSIX_SIM 0 ///< 1 - deterministic virtual-time simulator, 0 - real time
+#endif
+
+namespace
+{
+
+constexpr uint64_t ns_per_sec = 1000000000U;
+
+struct kernel_t
+{
+    pthread_mutex_t       mtx = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t        cond;
+    osKernelState_t       state = osKernelInactive;
+    osRtxThread_t        *threads = nullptr;  ///< Active threads list
+    uint32_t              count = 0;          ///< Number of active threads
+    uint64_t              epoch = 0;          ///< Host time of kernel initialization
+    int64_t               tick_offset = 0;    ///< Tick compensation (see osKernelResume)
+    uint32_t              tick_frozen = 0;    ///< Tick count while suspended
+    osRtxTimer_t         *timers = nullptr;   ///< Running timers, sorted by expiry (delta ticks)
+    uint32_t              timer_base = 0;     ///< Tick the delta of the first running timer counts from
+    osThreadId_t          timer_thread = nullptr; ///< Timer thread (created by the first osTimerNew)
+#if (OS_POSIX_SIM == 0)
+    bool                  locked = false;     ///< Kernel lock held (state stays osKernelRunning)
+    pthread_t             lock_owner;         ///< Host thread holding the kernel lock
+#else
+    uint64_t              sim_time = 0;       ///< Virtual time (ns)
+    osRtxThread_t        *curr = nullptr;     ///< Thread owning the (virtual) CPU
+    osRtxThread_t        *ready = nullptr;    ///< Ready list, sorted by priority
+#endif
+};
+
+kernel_t krn;
+
+thread_local osRtxThread_t *thread_curr = nullptr;
+
+/// Kernel mutex guard. A thread holds at most one at a time, so the ownership is a thread-local
+/// flag: @ref release unlocks before the end of the scope (see @ref check_requests, where
+/// pthread_exit unwinds through the guard) and the destructor then does nothing.
+class kernel_lock
+{
+private:
+    inline static thread_local bool held_ = false;
+
+public:
+    kernel_lock()
+    {
+        pthread_mutex_lock(&krn.mtx);
+        held_ = true;
+    }
+    ~kernel_lock()
+    {
+        release();
+    }
+
+    /// Unlock the kernel mutex held by the current thread.
+    static void release(void)
+    {
+        if (held_)
+        {
+            held_ = false;
+            pthread_mutex_unlock(&krn.mtx);
+        }
+    }
+};
+
+void cond_init(pthread_cond_t *_cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+uint64_t clock_ns(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * ns_per_sec + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/// Time since kernel initialization (host time or virtual time).
+uint64_t now_ns(void)
+{
+#if (OS_POSIX_SIM != 0)
+    return krn.sim_time;
+#else
+    return clock_ns() - krn.epoch;
+#endif
+}
+
+uint64_t ticks_to_ns(const uint32_t _ticks)
+{
+    return static_cast<uint64_t>(_ticks) * ns_per_sec / OS_TICK_FREQ;
+}
+
+uint32_t tick_count(void)
+{
+    if (krn.state == osKernelSuspended)
+    {
+        return krn.tick_frozen;
+    }
+    return static_cast<uint32_t>(static_cast<int64_t>(now_ns() * OS_TICK_FREQ / ns_per_sec) + krn.tick_offset);
+}
+
+#if (OS_POSIX_SIM == 0)
+
+/// Whether the calling host thread holds the kernel lock.
+/// \note kernel mutex must be held.
+bool lock_held(void)
+{
+    return krn.locked && pthread_equal(krn.lock_owner, pthread_self()) != 0;
+}
+
+/// Take the kernel lock, waiting while another host thread holds it.
+/// \note kernel mutex must be held.
+void lock_take(void)
+{
+    while (krn.locked && !lock_held())
+    {
+        pthread_cond_wait(&krn.cond, &krn.mtx);
+    }
+    krn.locked = true;
+    krn.lock_owner = pthread_self();
+}
+
+/// Release the kernel lock held by the calling host thread.
+/// \note kernel mutex must be held.
+void lock_give(void)
+{
+    if (lock_held())
+    {
+        krn.locked = false;
+        pthread_cond_broadcast(&krn.cond);
+    }
+}
+
+#endif
+
+/// Whether the calling thread may block: the kernel runs and the caller does not hold its lock.
+/// \note kernel mutex must be held.
+bool may_block(void)
+{
+#if (OS_POSIX_SIM != 0)
+    return krn.state == osKernelRunning;
+#else
+    return krn.state == osKernelRunning && !lock_held();
+#endif
+}
+
+osRtxThread_t *thread_get(const osThreadId_t _id)
+{
+    osRtxThread_t *thread = static_cast<osRtxThread_t *>(_id);
+    return (thread != nullptr && thread->id == osRtxIdThread) ? thread : nullptr;
+}
+
+#if (OS_POSIX_SIM != 0)
+
+/// Put a thread into the ready list behind (or, if preempted, in front of) threads of equal priority.
+void ready_put(osRtxThread_t *_thread, const bool _front = false)
+{
+    osRtxThread_t **pos = &krn.ready;
+    while (*pos != nullptr && ((*pos)->priority > _thread->priority ||
+                               (!_front && (*pos)->priority == _thread->priority)))
+    {
+        pos = &(*pos)->ready_next;
+    }
+    _thread->ready_next = *pos;
+    *pos = _thread;
+    _thread->state = osThreadReady;
+}
+
+void ready_remove(osRtxThread_t *_thread)
+{
+    osRtxThread_t **pos = &krn.ready;
+    while (*pos != nullptr && *pos != _thread)
+    {
+        pos = &(*pos)->ready_next;
+    }
+    if (*pos != nullptr)
+    {
+        *pos = _thread->ready_next;
+        _thread->ready_next = nullptr;
+    }
+}
+
+/// Hand the CPU to the first ready thread. When no thread is ready, virtual time jumps to the
+/// nearest timeout. Without any timeout the CPU is left idle and osKernelStart returns.
+void dispatch(void)
+{
+    while (krn.ready == nullptr)
+    {
+        uint64_t next = 0U;
+        for (const osRtxThread_t *thread = krn.threads; thread != nullptr; thread = thread->thread_next)
+        {
+            if (thread->deadline != 0U && (next == 0U || thread->deadline < next))
+            {
+                next = thread->deadline;
+            }
+        }
+        if (next == 0U)
+        {
+            krn.curr = nullptr;
+            pthread_cond_broadcast(&krn.cond);
+            return;
+        }
+        if (krn.curr != nullptr)
+        {
+            krn.curr = nullptr;
+            EvrRtxThreadSwitched(nullptr);
+        }
+        krn.sim_time = next;
+        for (osRtxThread_t *thread = krn.threads; thread != nullptr; thread = thread->thread_next)
+        {
+            if (thread->deadline != 0U && thread->deadline <= next)
+            {
+                thread->deadline = 0U;
+                ready_put(thread);
+            }
+        }
+    }
+
+    krn.curr = krn.ready;
+    krn.ready = krn.curr->ready_next;
+    krn.curr->ready_next = nullptr;
+    krn.curr->state = osThreadRunning;
+    EvrRtxThreadSwitched(krn.curr);
+    pthread_cond_signal(&krn.curr->cond);
+}
+
+/// Wait until the scheduler gives the CPU to the calling thread.
+void cpu_wait(osRtxThread_t *_thread)
+{
+    while (krn.curr != _thread)
+    {
+        pthread_cond_wait(&_thread->cond, &krn.mtx);
+    }
+}
+
+#endif
+
+/// Let a ready thread of higher priority (or of equal priority if yielding) run first.
+/// Only the simulator switches threads, on the host all threads run concurrently.
+/// \note kernel mutex must be held.
+void reschedule(const bool _yield = false)
+{
+#if (OS_POSIX_SIM != 0)
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr || thread != krn.curr || krn.state != osKernelRunning || krn.ready == nullptr ||
+        krn.ready->priority < thread->priority || (!_yield && krn.ready->priority == thread->priority))
+    {
+        return;
+    }
+    ready_put(thread, !_yield);
+    dispatch();
+    cpu_wait(thread);
+#else
+    if (_yield)
+    {
+        pthread_mutex_unlock(&krn.mtx);
+        sched_yield();
+        pthread_mutex_lock(&krn.mtx);
+    }
+#endif
+}
+
+/// Park the current thread while a suspend request is pending, exit on a terminate request.
+/// \note kernel mutex must be held.
+void check_requests(osRtxThread_t *_thread)
+{
+    while (_thread->suspend != 0U && _thread->terminate == 0U)
+    {
+        _thread->state = osThreadBlocked;
+        _thread->suspend = 2U;
+#if (OS_POSIX_SIM != 0)
+        dispatch();
+        cpu_wait(_thread);
+#else
+        pthread_cond_wait(&_thread->cond, &krn.mtx);
+#endif
+    }
+    _thread->state = osThreadRunning;
+    if (_thread->terminate != 0U)
+    {
+        kernel_lock::release();
+        pthread_exit(nullptr);
+    }
+}
+
+/// Put a thread into an object wait list, sorted by priority (FIFO within a priority).
+/// \note kernel mutex must be held.
+void wait_put(osRtxThread_t **_list, osRtxThread_t *_thread)
+{
+    osRtxThread_t **pos = _list;
+    while (*pos != nullptr && (*pos)->priority >= _thread->priority)
+    {
+        pos = &(*pos)->wait_next;
+    }
+    _thread->wait_next = *pos;
+    *pos = _thread;
+    _thread->wait_list = _list;
+}
+
+/// Remove a thread from the wait list it is in (if any).
+/// \note kernel mutex must be held.
+void wait_remove(osRtxThread_t *_thread)
+{
+    if (_thread->wait_list == nullptr)
+    {
+        return;
+    }
+    osRtxThread_t **pos = _thread->wait_list;
+    while (*pos != nullptr && *pos != _thread)
+    {
+        pos = &(*pos)->wait_next;
+    }
+    if (*pos != nullptr)
+    {
+        *pos = _thread->wait_next;
+    }
+    _thread->wait_next = nullptr;
+    _thread->wait_list = nullptr;
+}
+
+/// Block the current thread until it is woken (see @ref wake) or timeout.
+/// On timeout (or terminate request) the thread is removed from its wait list.
+/// \note kernel mutex must be held.
+/// \return result passed by the waker or osErrorTimeout.
+osStatus_t block(osRtxThread_t *_thread, const uint32_t _timeout)
+{
+    _thread->state = osThreadBlocked;
+    _thread->woken = 0U;
+    _thread->deadline = (_timeout == osWaitForever) ? 0U : now_ns() + ticks_to_ns(_timeout);
+
+#if (OS_POSIX_SIM != 0)
+    dispatch();
+    cpu_wait(_thread);
+#else
+    const uint64_t abs_deadline = krn.epoch + _thread->deadline;
+    const timespec ts =
+    {
+        .tv_sec  = static_cast<time_t>(abs_deadline / ns_per_sec),
+        .tv_nsec = static_cast<long>(abs_deadline % ns_per_sec),
+    };
+
+    while (_thread->woken == 0U && _thread->terminate == 0U)
+    {
+        if (_thread->deadline == 0U)
+        {
+            pthread_cond_wait(&_thread->cond, &krn.mtx);
+        }
+        else if (pthread_cond_timedwait(&_thread->cond, &krn.mtx, &ts) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+#endif
+    _thread->deadline = 0U;
+    wait_remove(_thread);
+
+    check_requests(_thread);
+
+    return (_thread->woken != 0U) ? static_cast<osStatus_t>(_thread->wait_result) : osErrorTimeout;
+}
+
+/// Make a thread that is blocked (or parked by suspend) runnable again.
+/// \note kernel mutex must be held.
+void unblock(osRtxThread_t *_thread)
+{
+#if (OS_POSIX_SIM != 0)
+    if (_thread->state == osThreadBlocked)
+    {
+        _thread->deadline = 0U;
+        ready_put(_thread);
+    }
+#else
+    pthread_cond_signal(&_thread->cond);
+#endif
+}
+
+/// Take the highest priority thread out of a wait list and pass it the wait result.
+/// \note kernel mutex must be held.
+/// \return woken thread or nullptr if the list is empty.
+osRtxThread_t *wake(osRtxThread_t **_list, const osStatus_t _result)
+{
+    osRtxThread_t *thread = *_list;
+    if (thread != nullptr)
+    {
+        wait_remove(thread);
+        thread->woken = 1U;
+        thread->wait_result = _result;
+        unblock(thread);
+    }
+    return thread;
+}
+
+/// Set the running priority of a thread and keep the lists it is in sorted.
+/// \note kernel mutex must be held.
+void priority_set(osRtxThread_t *_thread, const int8_t _priority)
+{
+    if (_thread->priority == _priority)
+    {
+        return;
+    }
+    _thread->priority = _priority;
+#if (OS_POSIX_SIM != 0)
+    if (_thread->state == osThreadReady)
+    {
+        ready_remove(_thread);
+        ready_put(_thread);
+    }
+#endif
+    if (_thread->wait_list != nullptr)
+    {
+        osRtxThread_t **list = _thread->wait_list;
+        wait_remove(_thread);
+        wait_put(list, _thread);
+    }
+}
+
+/// Recalculate the priority of a mutex owner: base priority raised to the highest waiter
+/// of its priority inheritance mutexes.
+/// \note kernel mutex must be held.
+void priority_restore(osRtxThread_t *_thread)
+{
+    int8_t priority = _thread->priority_base;
+    for (const osRtxMutex_t *mutex = _thread->mutex_list; mutex != nullptr; mutex = mutex->owner_next)
+    {
+        if ((mutex->attr & osMutexPrioInherit) != 0U && mutex->thread_list != nullptr &&
+            mutex->thread_list->priority > priority)
+        {
+            priority = mutex->thread_list->priority;
+        }
+    }
+    priority_set(_thread, priority);
+}
+
+void mutex_own(osRtxMutex_t *_mutex, osRtxThread_t *_thread)
+{
+    _mutex->owner_thread = _thread;
+    _mutex->owner_prev = nullptr;
+    _mutex->owner_next = _thread->mutex_list;
+    if (_thread->mutex_list != nullptr)
+    {
+        _thread->mutex_list->owner_prev = _mutex;
+    }
+    _thread->mutex_list = _mutex;
+    _mutex->lock = 1U;
+}
+
+void mutex_disown(osRtxMutex_t *_mutex)
+{
+    osRtxThread_t *owner = _mutex->owner_thread;
+    if (_mutex->owner_prev != nullptr)
+    {
+        _mutex->owner_prev->owner_next = _mutex->owner_next;
+    }
+    else
+    {
+        owner->mutex_list = _mutex->owner_next;
+    }
+    if (_mutex->owner_next != nullptr)
+    {
+        _mutex->owner_next->owner_prev = _mutex->owner_prev;
+    }
+    _mutex->owner_thread = nullptr;
+    _mutex->owner_prev = nullptr;
+    _mutex->owner_next = nullptr;
+    _mutex->lock = 0U;
+}
+
+/// Pass a released mutex to the highest priority waiter.
+/// \note kernel mutex must be held.
+void mutex_handover(osRtxMutex_t *_mutex)
+{
+    osRtxThread_t *thread = wake(&_mutex->thread_list, osOK);
+    if (thread != nullptr)
+    {
+        mutex_own(_mutex, thread);
+        priority_restore(thread);
+    }
+}
+
+void thread_unlink(osRtxThread_t *_thread)
+{
+    if (_thread->thread_prev != nullptr)
+    {
+        _thread->thread_prev->thread_next = _thread->thread_next;
+    }
+    else
+    {
+        krn.threads = _thread->thread_next;
+    }
+    if (_thread->thread_next != nullptr)
+    {
+        _thread->thread_next->thread_prev = _thread->thread_prev;
+    }
+    krn.count--;
+}
+
+/// Releases the control block when the host thread finishes (return, osThreadExit or terminate).
+class thread_guard
+{
+    osRtxThread_t *thread_;
+
+public:
+    explicit thread_guard(osRtxThread_t *_thread): thread_(_thread) {}
+    ~thread_guard()
+    {
+        kernel_lock lock;
+
+        // Robust mutexes are released, others stay locked as on RTX
+        for (osRtxMutex_t *mutex = thread_->mutex_list, *next; mutex != nullptr; mutex = next)
+        {
+            next = mutex->owner_next;
+            if ((mutex->attr & osMutexRobust) != 0U)
+            {
+                mutex_disown(mutex);
+                mutex_handover(mutex);
+            }
+        }
+        thread_unlink(thread_);
+#if (OS_POSIX_SIM == 0)
+        lock_give();
+#endif
+        pthread_cond_destroy(&thread_->cond);
+        thread_->state = osThreadTerminated;
+        thread_->id = osRtxIdInvalid;
+        if ((thread_->flags & osRtxFlagSystemObject) != 0U)
+        {
+            free(thread_);
+        }
+#if (OS_POSIX_SIM != 0)
+        dispatch();
+#else
+        pthread_cond_broadcast(&krn.cond);
+#endif
+    }
+};
+
+void *thread_entry(void *_arg)
+{
+    osRtxThread_t *thread = static_cast<osRtxThread_t *>(_arg);
+    thread_guard guard(thread);
+
+    thread_curr = thread;
+    {
+        kernel_lock lock;
+
+#if (OS_POSIX_SIM != 0)
+        cpu_wait(thread);
+#else
+        while (krn.state == osKernelReady)
+        {
+            pthread_cond_wait(&krn.cond, &krn.mtx);
+        }
+#endif
+        check_requests(thread);
+    }
+
+    thread->func(thread->arg);
+
+    return nullptr;
+}
+
+} // namespace
+
+//  ==== Event Recorder hooks ====
+
+__attribute__((weak)) void EvrRtxThreadSwitched(osThreadId_t thread_id)
+{
+    (void)thread_id;
+}
+
+//  ==== Kernel Management Functions ====
+
+osStatus_t osKernelInitialize(void)
+{
+    kernel_lock lock;
+
+    if (krn.state != osKernelInactive)
+    {
+        return (krn.state == osKernelReady) ? osOK : osError;
+    }
+    cond_init(&krn.cond);
+    krn.epoch = clock_ns();
+    krn.tick_offset = 0;
+#if (OS_POSIX_SIM != 0)
+    krn.sim_time = 0U;
+#endif
+    krn.state = osKernelReady;
+
+    return osOK;
+}
+
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size)
+{
+    if (version != nullptr)
+    {
+        version->api    = osRtxVersionAPI;
+        version->kernel = osRtxVersionKernel;
+    }
+    if (id_buf != nullptr && id_size != 0U)
+    {
+        strncpy(id_buf, osRtxKernelId, id_size - 1U);
+        id_buf[id_size - 1U] = '\0';
+    }
+    return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+    kernel_lock lock;
+
+#if (OS_POSIX_SIM == 0)
+    if (lock_held())
+    {
+        return osKernelLocked;
+    }
+#endif
+    return krn.state;
+}
+
+/// Start the scheduler. Unlike RTX the call returns once all threads have finished (osOK).
+/// The simulator also returns when the remaining threads wait forever (osError).
+osStatus_t osKernelStart(void)
+{
+    kernel_lock lock;
+
+    if (krn.state != osKernelReady)
+    {
+        return osError;
+    }
+    krn.state = osKernelRunning;
+
+#if (OS_POSIX_SIM != 0)
+    dispatch();
+    while (krn.curr != nullptr)
+    {
+        pthread_cond_wait(&krn.cond, &krn.mtx);
+    }
+
+    return (krn.count == 0U) ? osOK : osError;
+#else
+    pthread_cond_broadcast(&krn.cond);
+    while (krn.count != 0U)
+    {
+        pthread_cond_wait(&krn.cond, &krn.mtx);
+    }
+
+    return osOK;
+#endif
+}
+
+/// In real time the kernel lock is a mutual exclusion between host threads instead of a state: a
+/// thread waits while another one holds it, and only the holder sees osKernelLocked.
+int32_t osKernelLock(void)
+{
+    kernel_lock lock;
+
+#if (OS_POSIX_SIM == 0)
+    if (krn.state != osKernelRunning)
+    {
+        return osError;
+    }
+    if (lock_held())
+    {
+        return 1;
+    }
+    lock_take();
+    return 0;
+#else
+    switch (krn.state)
+    {
+        case osKernelRunning:
+            krn.state = osKernelLocked;
+            return 0;
+        case osKernelLocked:
+            return 1;
+        default:
+            return osError;
+    }
+#endif
+}
+
+int32_t osKernelUnlock(void)
+{
+    kernel_lock lock;
+
+#if (OS_POSIX_SIM == 0)
+    if (krn.state != osKernelRunning)
+    {
+        return osError;
+    }
+    if (!lock_held())
+    {
+        return 0;
+    }
+    lock_give();
+    return 1;
+#else
+    switch (krn.state)
+    {
+        case osKernelRunning:
+            return 0;
+        case osKernelLocked:
+            krn.state = osKernelRunning;
+            return 1;
+        default:
+            return osError;
+    }
+#endif
+}
+
+int32_t osKernelRestoreLock(int32_t lock_state)
+{
+    kernel_lock lock;
+
+    if (krn.state != osKernelRunning && krn.state != osKernelLocked)
+    {
+        return osError;
+    }
+    switch (lock_state)
+    {
+        case 1:
+#if (OS_POSIX_SIM == 0)
+            lock_take();
+#else
+            krn.state = osKernelLocked;
+#endif
+            return 1;
+        case 0:
+#if (OS_POSIX_SIM == 0)
+            lock_give();
+#else
+            krn.state = osKernelRunning;
+#endif
+            return 0;
+        default:
+            return osError;
+    }
+}
+
+uint32_t osKernelSuspend(void)
+{
+    kernel_lock lock;
+
+    if (krn.state != osKernelRunning)
+    {
+        return 0U;
+    }
+
+    uint64_t next = 0U;
+    for (const osRtxThread_t *thread = krn.threads; thread != nullptr; thread = thread->thread_next)
+    {
+        if (thread->deadline != 0U && (next == 0U || thread->deadline < next))
+        {
+            next = thread->deadline;
+        }
+    }
+
+    krn.tick_frozen = tick_count();
+    krn.state = osKernelSuspended;
+
+    if (next == 0U)
+    {
+        return osWaitForever;
+    }
+    const uint64_t now = now_ns();
+    return (next > now) ? static_cast<uint32_t>((next - now) * OS_TICK_FREQ / ns_per_sec) : 0U;
+}
+
+void osKernelResume(uint32_t sleep_ticks)
+{
+    kernel_lock lock;
+
+    if (krn.state != osKernelSuspended)
+    {
+        return;
+    }
+    krn.state = osKernelRunning;
+    krn.tick_offset += static_cast<int32_t>(krn.tick_frozen + sleep_ticks - tick_count());
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+    kernel_lock lock;
+
+    return tick_count();
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+    return OS_TICK_FREQ;
+}
+
+/// Lock free, so it may be called from kernel hooks (virtual time changes only in @ref dispatch).
+uint32_t osKernelGetSysTimerCount(void)
+{
+    return static_cast<uint32_t>(now_ns());
+}
+
+uint64_t osRtxSysTimerCount64(void)
+{
+    return now_ns();
+}
+
+uint32_t osKernelGetSysTimerFreq(void)
+{
+    return ns_per_sec;
+}
+
+//  ==== Thread Management Functions ====
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+    if (func == nullptr)
+    {
+        return nullptr;
+    }
+
+    const osPriority_t priority = (attr != nullptr && attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal;
+    if (priority < osPriorityIdle || priority > osPriorityISR)
+    {
+        return nullptr;
+    }
+
+    kernel_lock lock;
+
+    if (krn.state == osKernelInactive)
+    {
+        return nullptr;
+    }
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxThread_t));
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxThread_t))
+    {
+        return nullptr;
+    }
+
+    osRtxThread_t *thread = new (mem) osRtxThread_t();
+    thread->id = osRtxIdThread;
+    thread->state = osThreadReady;
+    thread->flags = flags;
+    thread->attr = static_cast<uint8_t>((attr != nullptr) ? attr->attr_bits : osThreadDetached);
+    thread->name = (attr != nullptr) ? attr->name : nullptr;
+    thread->priority = static_cast<int8_t>(priority);
+    thread->priority_base = static_cast<int8_t>(priority);
+    thread->func = func;
+    thread->arg = argument;
+    thread->stack_mem = (attr != nullptr) ? attr->stack_mem : nullptr;
+    thread->stack_size = (attr != nullptr && attr->stack_size != 0U) ? attr->stack_size : OS_STACK_SIZE;
+    if (thread->stack_mem != nullptr)
+    {
+        // Host threads run on their own stacks; the marks keep stack monitors working
+        uint32_t *stack = static_cast<uint32_t *>(thread->stack_mem);
+        for (uint32_t i = 0U; i < thread->stack_size / sizeof(uint32_t); i++)
+        {
+            stack[i] = (OS_STACK_WATERMARK != 0) ? osRtxStackFillPattern : 0U;
+        }
+        stack[0] = osRtxStackMagicWord;
+    }
+    cond_init(&thread->cond);
+
+    if (pthread_create(&thread->handle, nullptr, thread_entry, thread) != 0)
+    {
+        pthread_cond_destroy(&thread->cond);
+        thread->id = osRtxIdInvalid;
+        if (flags != 0U)
+        {
+            free(thread);
+        }
+        return nullptr;
+    }
+    pthread_detach(thread->handle);
+    if (thread->name != nullptr)
+    {
+        char name[16];
+        strncpy(name, thread->name, sizeof(name) - 1U);
+        name[sizeof(name) - 1U] = '\0';
+        pthread_setname_np(thread->handle, name);
+    }
+
+    thread->thread_next = krn.threads;
+    if (krn.threads != nullptr)
+    {
+        krn.threads->thread_prev = thread;
+    }
+    krn.threads = thread;
+    krn.count++;
+
+#if (OS_POSIX_SIM != 0)
+    ready_put(thread);
+    reschedule();
+#endif
+
+    return thread;
+}
+
+const char *osThreadGetName(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    const osRtxThread_t *thread = thread_get(thread_id);
+    return (thread != nullptr) ? thread->name : nullptr;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+    return thread_curr;
+}
+
+osThreadState_t osThreadGetState(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    const osRtxThread_t *thread = thread_get(thread_id);
+    return (thread != nullptr) ? static_cast<osThreadState_t>(thread->state) : osThreadError;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    const osRtxThread_t *thread = thread_get(thread_id);
+    return (thread != nullptr) ? thread->stack_size : 0U;
+}
+
+/// Host threads run on their own stacks, so the whole configured stack is reported as free.
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id)
+{
+    return osThreadGetStackSize(thread_id);
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority)
+{
+    if (priority < osPriorityIdle || priority > osPriorityISR)
+    {
+        return osErrorParameter;
+    }
+
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_get(thread_id);
+    if (thread == nullptr)
+    {
+        return osErrorParameter;
+    }
+    thread->priority_base = static_cast<int8_t>(priority);
+    priority_restore(thread);
+    reschedule();
+
+    return osOK;
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    const osRtxThread_t *thread = thread_get(thread_id);
+    return (thread != nullptr) ? static_cast<osPriority_t>(thread->priority) : osPriorityError;
+}
+
+osStatus_t osThreadYield(void)
+{
+    kernel_lock lock;
+
+    reschedule(true);
+
+    return osOK;
+}
+
+osStatus_t osThreadSuspend(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_get(thread_id);
+    if (thread == nullptr)
+    {
+        return osErrorParameter;
+    }
+    if (thread->state == osThreadTerminated || thread->suspend != 0U)
+    {
+        return osErrorResource;
+    }
+    thread->suspend = 1U;
+    if (thread == thread_curr)
+    {
+        check_requests(thread);
+    }
+
+    return osOK;
+}
+
+osStatus_t osThreadResume(osThreadId_t thread_id)
+{
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_get(thread_id);
+    if (thread == nullptr)
+    {
+        return osErrorParameter;
+    }
+    if (thread->suspend == 0U)
+    {
+        return osErrorResource;
+    }
+    if (thread->suspend == 2U)
+    {
+        unblock(thread);
+    }
+    thread->suspend = 0U;
+    reschedule();
+
+    return osOK;
+}
+
+void osThreadExit(void)
+{
+    pthread_exit(nullptr);
+}
+
+osStatus_t osThreadTerminate(osThreadId_t thread_id)
+{
+    osRtxThread_t *thread;
+    {
+        kernel_lock lock;
+
+        thread = thread_get(thread_id);
+        if (thread == nullptr)
+        {
+            return osErrorParameter;
+        }
+        if (thread != thread_curr)
+        {
+            thread->terminate = 1U;
+            unblock(thread);
+            reschedule();
+            return osOK;
+        }
+    }
+    pthread_exit(nullptr);
+}
+
+uint32_t osThreadGetCount(void)
+{
+    kernel_lock lock;
+
+    return krn.count;
+}
+
+uint32_t osThreadEnumerate(osThreadId_t *thread_array, uint32_t array_items)
+{
+    kernel_lock lock;
+
+    uint32_t cnt = 0U;
+    for (osRtxThread_t *thread = krn.threads; thread != nullptr && cnt < array_items; thread = thread->thread_next)
+    {
+        thread_array[cnt++] = thread;
+    }
+    return cnt;
+}
+
+//  ==== Thread Flags Functions ====
+
+namespace
+{
+
+/// Check the flags a thread waits for and clear them unless osFlagsNoClear.
+/// \note kernel mutex must be held.
+/// \return flags before clearing or 0 if the wait condition is not satisfied.
+uint32_t thread_flags_check(osRtxThread_t *_thread, const uint32_t _flags, const uint32_t _options)
+{
+    const uint32_t flags = _thread->thread_flags;
+    const bool ready = ((_options & osFlagsWaitAll) != 0U) ? (flags & _flags) == _flags : (flags & _flags) != 0U;
+    if (!ready)
+    {
+        return 0U;
+    }
+    if ((_options & osFlagsNoClear) == 0U)
+    {
+        _thread->thread_flags &= ~_flags;
+    }
+    return flags;
+}
+
+} // namespace
+
+/// Callable from any context, including host threads that stand in for interrupt handlers.
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+    if ((flags & osFlagsError) != 0U)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_get(thread_id);
+    if (thread == nullptr || thread->state == osThreadTerminated)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    thread->thread_flags |= flags;
+    const uint32_t thread_flags = thread->thread_flags;
+
+    // A thread waiting for event flags is in their wait list and has wait_flags set as well
+    if (thread->wait_flags != 0U && thread->wait_list == nullptr && thread->woken == 0U)
+    {
+        const uint32_t result = thread_flags_check(thread, thread->wait_flags, thread->flags_options);
+        if (result != 0U)
+        {
+            thread->wait_flags = 0U;
+            thread->woken = 1U;
+            thread->wait_result = static_cast<int32_t>(result);
+            unblock(thread);
+            reschedule();
+        }
+    }
+
+    return thread_flags;
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return osFlagsErrorISR;
+    }
+    if ((flags & osFlagsError) != 0U)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    kernel_lock lock;
+
+    const uint32_t thread_flags = thread->thread_flags;
+    thread->thread_flags &= ~flags;
+
+    return thread_flags;
+}
+
+uint32_t osThreadFlagsGet(void)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return 0U;
+    }
+
+    kernel_lock lock;
+
+    return thread->thread_flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return osFlagsErrorISR;
+    }
+    if ((flags & osFlagsError) != 0U)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    kernel_lock lock;
+
+    const uint32_t result = thread_flags_check(thread, flags, options);
+    if (result != 0U)
+    {
+        return result;
+    }
+    if (timeout == 0U)
+    {
+        return osFlagsErrorResource;
+    }
+
+    thread->wait_flags = flags;
+    thread->flags_options = static_cast<uint8_t>(options);
+    const osStatus_t sts = block(thread, timeout);
+    thread->wait_flags = 0U;
+
+    return (sts == osErrorTimeout) ? osFlagsErrorTimeout : static_cast<uint32_t>(thread->wait_result);
+}
+
+//  ==== Generic Wait Functions ====
+
+osStatus_t osDelay(uint32_t ticks)
+{
+    if (ticks == 0U)
+    {
+        return osOK;
+    }
+
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr || !may_block())
+    {
+        return osError;
+    }
+    block(thread, ticks);
+
+    return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+    kernel_lock lock;
+
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr || !may_block())
+    {
+        return osError;
+    }
+    const uint32_t delay = ticks - tick_count();
+    if (delay == 0U || delay > 0x7FFFFFFFU)
+    {
+        return osErrorParameter;
+    }
+    block(thread, delay);
+
+    return osOK;
+}
+
+//  ==== Timer Management Functions ====
+
+namespace
+{
+
+/// Thread flag that makes the timer thread recalculate its timeout.
+constexpr uint32_t timer_flag = 1U;
+
+osRtxTimer_t *timer_get(const osTimerId_t _id)
+{
+    osRtxTimer_t *timer = static_cast<osRtxTimer_t *>(_id);
+    return (timer != nullptr && timer->id == osRtxIdTimer) ? timer : nullptr;
+}
+
+/// Insert a timer into the running list, after the timers that expire at the same tick.
+/// As on RTX the list holds the delta to the previous timer, so an insert walks the list.
+/// \note kernel mutex must be held.
+/// \return true if the timer is now the first to expire.
+bool timer_insert(osRtxTimer_t *_timer, uint32_t _delta)
+{
+    osRtxTimer_t *prev = nullptr;
+    osRtxTimer_t *next = krn.timers;
+    while (next != nullptr && next->tick <= _delta)
+    {
+        _delta -= next->tick;
+        prev = next;
+        next = next->next;
+    }
+    _timer->tick = _delta;
+    _timer->prev = prev;
+    _timer->next = next;
+    if (next != nullptr)
+    {
+        next->tick -= _delta;
+        next->prev = _timer;
+    }
+    if (prev != nullptr)
+    {
+        prev->next = _timer;
+    }
+    else
+    {
+        krn.timers = _timer;
+    }
+    _timer->state = osRtxTimerRunning;
+    return prev == nullptr;
+}
+
+/// \note kernel mutex must be held.
+void timer_remove(osRtxTimer_t *_timer)
+{
+    if (_timer->next != nullptr)
+    {
+        _timer->next->tick += _timer->tick;
+        _timer->next->prev = _timer->prev;
+    }
+    if (_timer->prev != nullptr)
+    {
+        _timer->prev->next = _timer->next;
+    }
+    else
+    {
+        krn.timers = _timer->next;
+    }
+    _timer->prev = nullptr;
+    _timer->next = nullptr;
+    _timer->state = osRtxTimerStopped;
+}
+
+/// Runs the callbacks of the expired timers. Unlike RTX they are called directly instead of
+/// through the callback queue (OS_TIMER_CB_QUEUE), so none is lost.
+void timer_thread(void *)
+{
+    for (;;)
+    {
+        osRtxTimerFinfo_t finfo = {};
+        uint32_t wait = osWaitForever;
+        {
+            kernel_lock lock;
+
+            osRtxTimer_t *timer = krn.timers;
+            if (timer != nullptr)
+            {
+                const uint32_t elapsed = tick_count() - krn.timer_base;
+                if (elapsed >= timer->tick)
+                {
+                    // Periodic timers reload from their expiry, so a late callback does not drift
+                    krn.timer_base += timer->tick;
+                    timer->tick = 0U;
+                    timer_remove(timer);
+                    finfo = timer->finfo;
+                    if (timer->type == osTimerPeriodic)
+                    {
+                        timer_insert(timer, timer->load);
+                    }
+                }
+                else
+                {
+                    wait = timer->tick - elapsed;
+                }
+            }
+        }
+
+        if (finfo.func != nullptr)
+        {
+            finfo.func(finfo.arg);
+        }
+        else
+        {
+            osThreadFlagsWait(timer_flag, osFlagsWaitAny, wait);
+        }
+    }
+}
+
+/// Create the timer thread on first use (RTX creates it at kernel start).
+bool timer_setup(void)
+{
+    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+
+    pthread_mutex_lock(&mtx);
+    bool ok;
+    {
+        kernel_lock lock;
+        ok = (krn.timer_thread != nullptr);
+    }
+    if (!ok)
+    {
+        const osThreadAttr_t attr =
+        {
+            .name       = "osRtxTimerThread",
+            .attr_bits  = osThreadDetached,
+            .cb_mem     = nullptr,
+            .cb_size    = 0U,
+            .stack_mem  = nullptr,
+            .stack_size = OS_TIMER_THREAD_STACK_SIZE,
+            .priority   = static_cast<osPriority_t>(OS_TIMER_THREAD_PRIO),
+            .tz_module  = 0U,
+            .reserved   = 0U,
+        };
+        const osThreadId_t id = osThreadNew(timer_thread, nullptr, &attr);
+        kernel_lock lock;
+        krn.timer_thread = id;
+        ok = (id != nullptr);
+    }
+    pthread_mutex_unlock(&mtx);
+    return ok;
+}
+
+} // namespace
+
+/// The first timer starts the timer thread, which then keeps osKernelStart from returning.
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *attr)
+{
+    if (func == nullptr || (type != osTimerOnce && type != osTimerPeriodic))
+    {
+        return nullptr;
+    }
+    if (!timer_setup())
+    {
+        return nullptr;
+    }
+
+    kernel_lock lock;
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxTimer_t));
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxTimer_t))
+    {
+        return nullptr;
+    }
+
+    osRtxTimer_t *timer = new (mem) osRtxTimer_t();
+    timer->id = osRtxIdTimer;
+    timer->state = osRtxTimerStopped;
+    timer->flags = flags;
+    timer->type = static_cast<uint8_t>(type);
+    timer->name = (attr != nullptr) ? attr->name : nullptr;
+    timer->finfo.func = func;
+    timer->finfo.arg = argument;
+
+    return timer;
+}
+
+const char *osTimerGetName(osTimerId_t timer_id)
+{
+    kernel_lock lock;
+
+    const osRtxTimer_t *timer = timer_get(timer_id);
+    return (timer != nullptr) ? timer->name : nullptr;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+{
+    if (ticks == 0U)
+    {
+        return osErrorParameter;
+    }
+
+    osThreadId_t wake = nullptr;
+    {
+        kernel_lock lock;
+
+        osRtxTimer_t *timer = timer_get(timer_id);
+        if (timer == nullptr)
+        {
+            return osErrorParameter;
+        }
+        if (timer->state == osRtxTimerRunning)
+        {
+            timer_remove(timer);
+        }
+        const uint32_t now = tick_count();
+        if (krn.timers == nullptr)
+        {
+            krn.timer_base = now;
+        }
+        timer->load = ticks;
+        if (timer_insert(timer, (now - krn.timer_base) + ticks))
+        {
+            wake = krn.timer_thread;
+        }
+    }
+
+    if (wake != nullptr)
+    {
+        osThreadFlagsSet(wake, timer_flag);
+    }
+    return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id)
+{
+    kernel_lock lock;
+
+    osRtxTimer_t *timer = timer_get(timer_id);
+    if (timer == nullptr)
+    {
+        return osErrorParameter;
+    }
+    if (timer->state != osRtxTimerRunning)
+    {
+        return osErrorResource;
+    }
+    timer_remove(timer);
+
+    return osOK;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id)
+{
+    kernel_lock lock;
+
+    const osRtxTimer_t *timer = timer_get(timer_id);
+    return (timer != nullptr && timer->state == osRtxTimerRunning) ? 1U : 0U;
+}
+
+osStatus_t osTimerDelete(osTimerId_t timer_id)
+{
+    kernel_lock lock;
+
+    osRtxTimer_t *timer = timer_get(timer_id);
+    if (timer == nullptr)
+    {
+        return osErrorParameter;
+    }
+    if (timer->state == osRtxTimerRunning)
+    {
+        timer_remove(timer);
+    }
+    timer->id = osRtxIdInvalid;
+    timer->state = osRtxTimerInactive;
+    if ((timer->flags & osRtxFlagSystemObject) != 0U)
+    {
+        free(timer);
+    }
+
+    return osOK;
+}
+
+//  ==== Event Flags Management Functions ====
+
+namespace
+{
+
+osRtxEventFlags_t *event_flags_get(const osEventFlagsId_t _id)
+{
+    osRtxEventFlags_t *ef = static_cast<osRtxEventFlags_t *>(_id);
+    return (ef != nullptr && ef->id == osRtxIdEventFlags) ? ef : nullptr;
+}
+
+/// Check event flags against a wait condition and clear them unless osFlagsNoClear.
+/// \note kernel mutex must be held.
+/// \return flags before clearing or 0 if the wait condition is not satisfied.
+uint32_t event_flags_check(osRtxEventFlags_t *_ef, const uint32_t _flags, const uint32_t _options)
+{
+    const uint32_t flags = _ef->event_flags;
+    const bool ready = ((_options & osFlagsWaitAll) != 0U) ? (flags & _flags) == _flags : (flags & _flags) != 0U;
+    if (!ready)
+    {
+        return 0U;
+    }
+    if ((_options & osFlagsNoClear) == 0U)
+    {
+        _ef->event_flags &= ~_flags;
+    }
+    return flags;
+}
+
+} // namespace
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr)
+{
+    kernel_lock lock;
+
+    if (krn.state == osKernelInactive)
+    {
+        return nullptr;
+    }
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxEventFlags_t));
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxEventFlags_t))
+    {
+        return nullptr;
+    }
+
+    osRtxEventFlags_t *ef = new (mem) osRtxEventFlags_t();
+    ef->id = osRtxIdEventFlags;
+    ef->flags = flags;
+    ef->name = (attr != nullptr) ? attr->name : nullptr;
+
+    return ef;
+}
+
+const char *osEventFlagsGetName(osEventFlagsId_t ef_id)
+{
+    kernel_lock lock;
+
+    const osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    return (ef != nullptr) ? ef->name : nullptr;
+}
+
+/// Callable from any context, including host threads that stand in for interrupt handlers.
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
+{
+    kernel_lock lock;
+
+    osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    if (ef == nullptr || (flags & osFlagsError) != 0U)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    ef->event_flags |= flags;
+    const uint32_t event_flags = ef->event_flags;
+
+    // Wake every waiter whose condition holds, in priority order (clearing may starve later ones)
+    bool woken = false;
+    osRtxThread_t *thread = ef->thread_list;
+    while (thread != nullptr)
+    {
+        osRtxThread_t *next = thread->wait_next;
+        const uint32_t result = event_flags_check(ef, thread->wait_flags, thread->flags_options);
+        if (result != 0U)
+        {
+            wait_remove(thread);
+            thread->woken = 1U;
+            thread->wait_result = static_cast<int32_t>(result);
+            unblock(thread);
+            woken = true;
+        }
+        thread = next;
+    }
+    if (woken)
+    {
+        reschedule();
+    }
+
+    return event_flags;
+}
+
+/// Callable from any context.
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags)
+{
+    kernel_lock lock;
+
+    osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    if (ef == nullptr || (flags & osFlagsError) != 0U)
+    {
+        return osFlagsErrorParameter;
+    }
+
+    const uint32_t event_flags = ef->event_flags;
+    ef->event_flags &= ~flags;
+
+    return event_flags;
+}
+
+/// Callable from any context.
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id)
+{
+    kernel_lock lock;
+
+    const osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    return (ef != nullptr) ? ef->event_flags : 0U;
+}
+
+/// Callable from any context with timeout 0.
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+
+    kernel_lock lock;
+
+    osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    if (ef == nullptr || (flags & osFlagsError) != 0U || (thread == nullptr && timeout != 0U))
+    {
+        return osFlagsErrorParameter;
+    }
+
+    const uint32_t result = event_flags_check(ef, flags, options);
+    if (result != 0U)
+    {
+        return result;
+    }
+    if (timeout == 0U)
+    {
+        return osFlagsErrorResource;
+    }
+
+    thread->wait_flags = flags;
+    thread->flags_options = static_cast<uint8_t>(options);
+    wait_put(&ef->thread_list, thread);
+    const osStatus_t sts = block(thread, timeout);
+    thread->wait_flags = 0U;
+
+    // Woken by osEventFlagsSet with the flags or by osEventFlagsDelete with osErrorResource
+    return (sts == osErrorTimeout) ? osFlagsErrorTimeout : static_cast<uint32_t>(thread->wait_result);
+}
+
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id)
+{
+    kernel_lock lock;
+
+    osRtxEventFlags_t *ef = event_flags_get(ef_id);
+    if (ef == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    while (wake(&ef->thread_list, osErrorResource) != nullptr)
+    {
+    }
+    ef->id = osRtxIdInvalid;
+    if ((ef->flags & osRtxFlagSystemObject) != 0U)
+    {
+        free(ef);
+    }
+    reschedule();
+
+    return osOK;
+}
+
+//  ==== Mutex Management Functions ====
+
+namespace
+{
+
+osRtxMutex_t *mutex_get(const osMutexId_t _id)
+{
+    osRtxMutex_t *mutex = static_cast<osRtxMutex_t *>(_id);
+    return (mutex != nullptr && mutex->id == osRtxIdMutex) ? mutex : nullptr;
+}
+
+} // namespace
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+    kernel_lock lock;
+
+    if (krn.state == osKernelInactive)
+    {
+        return nullptr;
+    }
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxMutex_t));
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxMutex_t))
+    {
+        return nullptr;
+    }
+
+    osRtxMutex_t *mutex = new (mem) osRtxMutex_t();
+    mutex->id = osRtxIdMutex;
+    mutex->flags = flags;
+    mutex->attr = static_cast<uint8_t>((attr != nullptr) ? attr->attr_bits : 0U);
+    mutex->name = (attr != nullptr) ? attr->name : nullptr;
+
+    return mutex;
+}
+
+const char *osMutexGetName(osMutexId_t mutex_id)
+{
+    kernel_lock lock;
+
+    const osRtxMutex_t *mutex = mutex_get(mutex_id);
+    return (mutex != nullptr) ? mutex->name : nullptr;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return osErrorISR;
+    }
+
+    kernel_lock lock;
+
+    osRtxMutex_t *mutex = mutex_get(mutex_id);
+    if (mutex == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    if (mutex->lock == 0U)
+    {
+        mutex_own(mutex, thread);
+        return osOK;
+    }
+    if (mutex->owner_thread == thread)
+    {
+        if ((mutex->attr & osMutexRecursive) == 0U || mutex->lock == UINT8_MAX)
+        {
+            return osErrorResource;
+        }
+        mutex->lock++;
+        return osOK;
+    }
+    if (timeout == 0U)
+    {
+        return osErrorResource;
+    }
+
+    osRtxThread_t *owner = mutex->owner_thread;
+    if ((mutex->attr & osMutexPrioInherit) != 0U && owner->priority < thread->priority)
+    {
+        priority_set(owner, thread->priority);
+    }
+    wait_put(&mutex->thread_list, thread);
+
+    const osStatus_t sts = block(thread, timeout);
+    if (sts != osOK && mutex_get(mutex_id) == mutex && mutex->owner_thread != nullptr)
+    {
+        priority_restore(mutex->owner_thread);
+    }
+
+    return sts;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return osErrorISR;
+    }
+
+    kernel_lock lock;
+
+    osRtxMutex_t *mutex = mutex_get(mutex_id);
+    if (mutex == nullptr)
+    {
+        return osErrorParameter;
+    }
+    if (mutex->lock == 0U || mutex->owner_thread != thread)
+    {
+        return osErrorResource;
+    }
+
+    if (--mutex->lock == 0U)
+    {
+        mutex_disown(mutex);
+        priority_restore(thread);
+        mutex_handover(mutex);
+        reschedule();
+    }
+
+    return osOK;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id)
+{
+    kernel_lock lock;
+
+    const osRtxMutex_t *mutex = mutex_get(mutex_id);
+    return (mutex != nullptr) ? mutex->owner_thread : nullptr;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id)
+{
+    kernel_lock lock;
+
+    osRtxMutex_t *mutex = mutex_get(mutex_id);
+    if (mutex == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    if (mutex->lock != 0U)
+    {
+        osRtxThread_t *owner = mutex->owner_thread;
+        mutex_disown(mutex);
+        priority_restore(owner);
+    }
+    while (wake(&mutex->thread_list, osErrorResource) != nullptr)
+    {
+    }
+    mutex->id = osRtxIdInvalid;
+    if ((mutex->flags & osRtxFlagSystemObject) != 0U)
+    {
+        free(mutex);
+    }
+    reschedule();
+
+    return osOK;
+}
+
+//  ==== Semaphore Management Functions ====
+
+namespace
+{
+
+osRtxSemaphore_t *semaphore_get(const osSemaphoreId_t _id)
+{
+    osRtxSemaphore_t *semaphore = static_cast<osRtxSemaphore_t *>(_id);
+    return (semaphore != nullptr && semaphore->id == osRtxIdSemaphore) ? semaphore : nullptr;
+}
+
+} // namespace
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr)
+{
+    kernel_lock lock;
+
+    if (krn.state == osKernelInactive || max_count == 0U || max_count > osRtxSemaphoreTokenLimit ||
+        initial_count > max_count)
+    {
+        return nullptr;
+    }
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxSemaphore_t));
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxSemaphore_t))
+    {
+        return nullptr;
+    }
+
+    osRtxSemaphore_t *semaphore = new (mem) osRtxSemaphore_t();
+    semaphore->id = osRtxIdSemaphore;
+    semaphore->flags = flags;
+    semaphore->name = (attr != nullptr) ? attr->name : nullptr;
+    semaphore->tokens = static_cast<uint16_t>(initial_count);
+    semaphore->max_tokens = static_cast<uint16_t>(max_count);
+
+    return semaphore;
+}
+
+const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id)
+{
+    kernel_lock lock;
+
+    const osRtxSemaphore_t *semaphore = semaphore_get(semaphore_id);
+    return (semaphore != nullptr) ? semaphore->name : nullptr;
+}
+
+/// Callable from any context with timeout 0.
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+
+    kernel_lock lock;
+
+    osRtxSemaphore_t *semaphore = semaphore_get(semaphore_id);
+    if (semaphore == nullptr || (thread == nullptr && timeout != 0U))
+    {
+        return osErrorParameter;
+    }
+
+    if (semaphore->tokens != 0U)
+    {
+        semaphore->tokens--;
+        return osOK;
+    }
+    if (timeout == 0U)
+    {
+        return osErrorResource;
+    }
+
+    wait_put(&semaphore->thread_list, thread);
+
+    return block(thread, timeout);
+}
+
+/// Callable from any context. A waiting thread takes the token directly.
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+    kernel_lock lock;
+
+    osRtxSemaphore_t *semaphore = semaphore_get(semaphore_id);
+    if (semaphore == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    if (wake(&semaphore->thread_list, osOK) != nullptr)
+    {
+        reschedule();
+        return osOK;
+    }
+    if (semaphore->tokens == semaphore->max_tokens)
+    {
+        return osErrorResource;
+    }
+    semaphore->tokens++;
+
+    return osOK;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id)
+{
+    kernel_lock lock;
+
+    const osRtxSemaphore_t *semaphore = semaphore_get(semaphore_id);
+    return (semaphore != nullptr) ? semaphore->tokens : 0U;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id)
+{
+    kernel_lock lock;
+
+    osRtxSemaphore_t *semaphore = semaphore_get(semaphore_id);
+    if (semaphore == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    while (wake(&semaphore->thread_list, osErrorResource) != nullptr)
+    {
+    }
+    semaphore->id = osRtxIdInvalid;
+    if ((semaphore->flags & osRtxFlagSystemObject) != 0U)
+    {
+        free(semaphore);
+    }
+    reschedule();
+
+    return osOK;
+}
+
+//  ==== Message Queue Management Functions ====
+
+namespace
+{
+
+osRtxMessageQueue_t *mq_get(const osMessageQueueId_t _id)
+{
+    osRtxMessageQueue_t *mq = static_cast<osRtxMessageQueue_t *>(_id);
+    return (mq != nullptr && mq->id == osRtxIdMessageQueue) ? mq : nullptr;
+}
+
+/// \return data of a message block.
+void *mq_data(osRtxMessage_t *_msg)
+{
+    return _msg + 1;
+}
+
+/// Take a block from the free list, copy a message into it and queue it by priority
+/// (FIFO within a priority).
+/// \note kernel mutex must be held, the free list must not be empty.
+void mq_insert(osRtxMessageQueue_t *_mq, const void *_data, const uint8_t _prio)
+{
+    osRtxMessage_t *msg = _mq->msg_free;
+    _mq->msg_free = msg->next;
+    memcpy(mq_data(msg), _data, _mq->msg_size);
+    msg->priority = _prio;
+
+    osRtxMessage_t **pos = &_mq->msg_first;
+    while (*pos != nullptr && (*pos)->priority >= _prio)
+    {
+        pos = &(*pos)->next;
+    }
+    msg->next = *pos;
+    *pos = msg;
+    _mq->msg_count++;
+}
+
+/// Take the first message out of the queue and return its block to the free list.
+/// \note kernel mutex must be held, the queue must not be empty.
+void mq_remove(osRtxMessageQueue_t *_mq, void *_data, uint8_t *_prio)
+{
+    osRtxMessage_t *msg = _mq->msg_first;
+    _mq->msg_first = msg->next;
+    memcpy(_data, mq_data(msg), _mq->msg_size);
+    if (_prio != nullptr)
+    {
+        *_prio = msg->priority;
+    }
+    msg->next = _mq->msg_free;
+    _mq->msg_free = msg;
+    _mq->msg_count--;
+}
+
+/// Move the messages of blocked senders into the free blocks.
+/// \note kernel mutex must be held, the wait list holds senders only.
+bool mq_accept_senders(osRtxMessageQueue_t *_mq)
+{
+    bool woken = false;
+    while (_mq->msg_free != nullptr && _mq->thread_list != nullptr)
+    {
+        const osRtxThread_t *sender = _mq->thread_list;
+        mq_insert(_mq, sender->wait_msg, *sender->wait_prio);
+        wake(&_mq->thread_list, osOK);
+        woken = true;
+    }
+    return woken;
+}
+
+} // namespace
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+    kernel_lock lock;
+
+    if (krn.state == osKernelInactive || msg_count == 0U || msg_size == 0U)
+    {
+        return nullptr;
+    }
+
+    const uint32_t block_size = osRtxMessageQueueMemSize(1U, msg_size);
+    if (msg_count > UINT32_MAX / block_size)
+    {
+        return nullptr;
+    }
+
+    void *mem = (attr != nullptr) ? attr->cb_mem : nullptr;
+    void *mq_mem = (attr != nullptr) ? attr->mq_mem : nullptr;
+    if ((mem == nullptr) != (mq_mem == nullptr))
+    {
+        return nullptr;
+    }
+    uint8_t flags = 0U;
+    if (mem == nullptr)
+    {
+        mem = malloc(sizeof(osRtxMessageQueue_t) + msg_count * block_size);
+        if (mem == nullptr)
+        {
+            return nullptr;
+        }
+        mq_mem = static_cast<osRtxMessageQueue_t *>(mem) + 1;
+        flags = osRtxFlagSystemObject;
+    }
+    else if (attr->cb_size < sizeof(osRtxMessageQueue_t) || attr->mq_size < msg_count * block_size ||
+             (reinterpret_cast<uintptr_t>(mq_mem) & 3U) != 0U)
+    {
+        return nullptr;
+    }
+
+    osRtxMessageQueue_t *mq = new (mem) osRtxMessageQueue_t();
+    mq->id = osRtxIdMessageQueue;
+    mq->flags = flags;
+    mq->name = (attr != nullptr) ? attr->name : nullptr;
+    mq->msg_size = msg_size;
+    mq->max_count = msg_count;
+
+    uint8_t *block = static_cast<uint8_t *>(mq_mem);
+    for (uint32_t i = 0U; i < msg_count; i++, block += block_size)
+    {
+        osRtxMessage_t *msg = reinterpret_cast<osRtxMessage_t *>(block);
+        msg->next = mq->msg_free;
+        mq->msg_free = msg;
+    }
+
+    return mq;
+}
+
+const char *osMessageQueueGetName(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    const osRtxMessageQueue_t *mq = mq_get(mq_id);
+    return (mq != nullptr) ? mq->name : nullptr;
+}
+
+/// Callable from any context with timeout 0.
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+
+    kernel_lock lock;
+
+    osRtxMessageQueue_t *mq = mq_get(mq_id);
+    if (mq == nullptr || msg_ptr == nullptr || (thread == nullptr && timeout != 0U))
+    {
+        return osErrorParameter;
+    }
+
+    // Receivers wait only while the queue is empty: hand the message over directly
+    if (mq->msg_count == 0U && mq->thread_list != nullptr)
+    {
+        osRtxThread_t *receiver = mq->thread_list;
+        memcpy(receiver->wait_msg, msg_ptr, mq->msg_size);
+        if (receiver->wait_prio != nullptr)
+        {
+            *receiver->wait_prio = msg_prio;
+        }
+        wake(&mq->thread_list, osOK);
+        reschedule();
+        return osOK;
+    }
+    if (mq->msg_free != nullptr)
+    {
+        mq_insert(mq, msg_ptr, msg_prio);
+        return osOK;
+    }
+    if (timeout == 0U)
+    {
+        return osErrorResource;
+    }
+
+    thread->wait_msg = const_cast<void *>(msg_ptr);
+    thread->wait_prio = &msg_prio;
+    wait_put(&mq->thread_list, thread);
+
+    return block(thread, timeout);
+}
+
+/// Callable from any context with timeout 0.
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+    osRtxThread_t *thread = thread_curr;
+
+    kernel_lock lock;
+
+    osRtxMessageQueue_t *mq = mq_get(mq_id);
+    if (mq == nullptr || msg_ptr == nullptr || (thread == nullptr && timeout != 0U))
+    {
+        return osErrorParameter;
+    }
+
+    if (mq->msg_count != 0U)
+    {
+        mq_remove(mq, msg_ptr, msg_prio);
+        // Senders wait only while the queue is full: the freed block takes the next one
+        if (mq_accept_senders(mq))
+        {
+            reschedule();
+        }
+        return osOK;
+    }
+    if (timeout == 0U)
+    {
+        return osErrorResource;
+    }
+
+    thread->wait_msg = msg_ptr;
+    thread->wait_prio = msg_prio;
+    wait_put(&mq->thread_list, thread);
+
+    return block(thread, timeout);
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    const osRtxMessageQueue_t *mq = mq_get(mq_id);
+    return (mq != nullptr) ? mq->max_count : 0U;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    const osRtxMessageQueue_t *mq = mq_get(mq_id);
+    return (mq != nullptr) ? mq->msg_size : 0U;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    const osRtxMessageQueue_t *mq = mq_get(mq_id);
+    return (mq != nullptr) ? mq->msg_count : 0U;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    const osRtxMessageQueue_t *mq = mq_get(mq_id);
+    return (mq != nullptr) ? mq->max_count - mq->msg_count : 0U;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id)
+{
+    osRtxThread_t *thread = thread_curr;
+    if (thread == nullptr)
+    {
+        return osErrorISR;
+    }
+
+    kernel_lock lock;
+
+    osRtxMessageQueue_t *mq = mq_get(mq_id);
+    if (mq == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    while (mq->msg_first != nullptr)
+    {
+        osRtxMessage_t *msg = mq->msg_first;
+        mq->msg_first = msg->next;
+        msg->next = mq->msg_free;
+        mq->msg_free = msg;
+    }
+    mq->msg_count = 0U;
+    if (mq_accept_senders(mq))
+    {
+        reschedule();
+    }
+
+    return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id)
+{
+    kernel_lock lock;
+
+    osRtxMessageQueue_t *mq = mq_get(mq_id);
+    if (mq == nullptr)
+    {
+        return osErrorParameter;
+    }
+
+    while (wake(&mq->thread_list, osErrorResource) != nullptr)
+    {
+    }
+    mq->id = osRtxIdInvalid;
+    if ((mq->flags & osRtxFlagSystemObject) != 0U)
+    {
+        free(mq);
+    }
+    reschedule();
+
+    return osOK;
+}
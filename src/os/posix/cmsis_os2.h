@@ -0,0 +1,296 @@
+#pragma once
+
+/// CMSIS-RTOS2 API subset implemented on POSIX threads.
+/// Used instead of the RTX5 header by the host build (see CMakeLists.txt), so os:: wrappers
+/// compile and run unchanged on Linux. Types and values follow CMSIS-RTOS2 API v2.1.3.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef  __cplusplus
+extern "C"
+{
+#endif
+
+//  ==== Enumerations, structures, defines ====
+
+/// Version information.
+typedef struct
+{
+    uint32_t api;                         ///< API version (major.minor.rev: mmnnnrrrr dec).
+    uint32_t kernel;                      ///< Kernel version (major.minor.rev: mmnnnrrrr dec).
+} osVersion_t;
+
+/// Kernel state.
+typedef enum
+{
+    osKernelInactive        =  0,         ///< Inactive.
+    osKernelReady           =  1,         ///< Ready.
+    osKernelRunning         =  2,         ///< Running.
+    osKernelLocked          =  3,         ///< Locked.
+    osKernelSuspended       =  4,         ///< Suspended.
+    osKernelError           = -1,         ///< Error.
+    osKernelReserved        = 0x7FFFFFFF  ///< Prevents enum down-size compiler optimization.
+} osKernelState_t;
+
+/// Thread state.
+typedef enum
+{
+    osThreadInactive        =  0,         ///< Inactive.
+    osThreadReady           =  1,         ///< Ready.
+    osThreadRunning         =  2,         ///< Running.
+    osThreadBlocked         =  3,         ///< Blocked.
+    osThreadTerminated      =  4,         ///< Terminated.
+    osThreadError           = -1,         ///< Error.
+    osThreadReserved        = 0x7FFFFFFF  ///< Prevents enum down-size compiler optimization.
+} osThreadState_t;
+
+/// Priority values.
+typedef enum
+{
+    osPriorityNone          =  0,         ///< No priority (not initialized).
+    osPriorityIdle          =  1,         ///< Reserved for Idle thread.
+    osPriorityLow           =  8,         ///< Priority: low
+    osPriorityBelowNormal   = 16,         ///< Priority: below normal
+    osPriorityNormal        = 24,         ///< Priority: normal
+    osPriorityAboveNormal   = 32,         ///< Priority: above normal
+    osPriorityHigh          = 40,         ///< Priority: high
+    osPriorityRealtime      = 48,         ///< Priority: realtime
+    osPriorityRealtime7     = 48 + 7,     ///< Priority: realtime + 7
+    osPriorityISR           = 56,         ///< Reserved for ISR deferred thread.
+    osPriorityError         = -1,         ///< System cannot determine priority or illegal priority.
+    osPriorityReserved      = 0x7FFFFFFF  ///< Prevents enum down-size compiler optimization.
+} osPriority_t;
+
+/// Entry point of a thread.
+typedef void (*osThreadFunc_t) (void *argument);
+
+/// Timer callback function.
+typedef void (*osTimerFunc_t) (void *argument);
+
+/// Timer type.
+typedef enum
+{
+    osTimerOnce             = 0,          ///< One-shot timer.
+    osTimerPeriodic         = 1           ///< Repeating timer.
+} osTimerType_t;
+
+/// Status code values returned by CMSIS-RTOS functions.
+typedef enum
+{
+    osOK                    =  0,         ///< Operation completed successfully.
+    osError                 = -1,         ///< Unspecified RTOS error: run-time error but no other error message fits.
+    osErrorTimeout          = -2,         ///< Operation not completed within the timeout period.
+    osErrorResource         = -3,         ///< Resource not available.
+    osErrorParameter        = -4,         ///< Parameter error.
+    osErrorNoMemory         = -5,         ///< System is out of memory: it was impossible to allocate or reserve memory for the operation.
+    osErrorISR              = -6,         ///< Not allowed in ISR context: the function cannot be called from interrupt service routines.
+    osStatusReserved        = 0x7FFFFFFF  ///< Prevents enum down-size compiler optimization.
+} osStatus_t;
+
+/// \details Thread ID identifies the thread.
+typedef void *osThreadId_t;
+
+/// \details Timer ID identifies the timer.
+typedef void *osTimerId_t;
+
+/// \details Event Flags ID identifies the event flags.
+typedef void *osEventFlagsId_t;
+
+/// \details Mutex ID identifies the mutex.
+typedef void *osMutexId_t;
+
+/// \details Semaphore ID identifies the semaphore.
+typedef void *osSemaphoreId_t;
+
+/// \details Message Queue ID identifies the message queue.
+typedef void *osMessageQueueId_t;
+
+/// TrustZone module identifier.
+typedef uint32_t TZ_ModuleId_t;
+
+// Thread attributes (attr_bits in \ref osThreadAttr_t).
+#define osThreadDetached      0x00000000U ///< Thread created in detached mode (default)
+#define osThreadJoinable      0x00000001U ///< Thread created in joinable mode
+
+// Flags options (\ref osThreadFlagsWait).
+#define osFlagsWaitAny        0x00000000U ///< Wait for any flag (default).
+#define osFlagsWaitAll        0x00000001U ///< Wait for all flags.
+#define osFlagsNoClear        0x00000002U ///< Do not clear flags which have been specified to wait for.
+
+// Flags errors (returned by osThreadFlagsXxxx).
+#define osFlagsError          0x80000000U ///< Error indicator.
+#define osFlagsErrorUnknown   0xFFFFFFFFU ///< osError (-1).
+#define osFlagsErrorTimeout   0xFFFFFFFEU ///< osErrorTimeout (-2).
+#define osFlagsErrorResource  0xFFFFFFFDU ///< osErrorResource (-3).
+#define osFlagsErrorParameter 0xFFFFFFFCU ///< osErrorParameter (-4).
+#define osFlagsErrorISR       0xFFFFFFFAU ///< osErrorISR (-6).
+
+// Mutex attributes (attr_bits in \ref osMutexAttr_t).
+#define osMutexRecursive      0x00000001U ///< Recursive mutex.
+#define osMutexPrioInherit    0x00000002U ///< Priority inherit protocol.
+#define osMutexRobust         0x00000008U ///< Robust mutex.
+
+/// Timeout value.
+#define osWaitForever         0xFFFFFFFFU ///< Wait forever timeout value.
+
+/// Attributes structure for thread.
+typedef struct
+{
+    const char                   *name;   ///< name of the thread
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+    void                   *stack_mem;    ///< memory for stack
+    uint32_t                stack_size;   ///< size of stack
+    osPriority_t              priority;   ///< initial thread priority (default: osPriorityNormal)
+    TZ_ModuleId_t            tz_module;   ///< TrustZone module identifier
+    uint32_t                  reserved;   ///< reserved (must be 0)
+} osThreadAttr_t;
+
+/// Attributes structure for timer.
+typedef struct
+{
+    const char                   *name;   ///< name of the timer
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+} osTimerAttr_t;
+
+/// Attributes structure for event flags.
+typedef struct
+{
+    const char                   *name;   ///< name of the event flags
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+} osEventFlagsAttr_t;
+
+/// Attributes structure for mutex.
+typedef struct
+{
+    const char                   *name;   ///< name of the mutex
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+} osMutexAttr_t;
+
+/// Attributes structure for semaphore.
+typedef struct
+{
+    const char                   *name;   ///< name of the semaphore
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+} osSemaphoreAttr_t;
+
+/// Attributes structure for message queue.
+typedef struct
+{
+    const char                   *name;   ///< name of the message queue
+    uint32_t                 attr_bits;   ///< attribute bits
+    void                      *cb_mem;    ///< memory for control block
+    uint32_t                   cb_size;   ///< size of provided memory for control block
+    void                      *mq_mem;    ///< memory for data storage
+    uint32_t                   mq_size;   ///< size of provided memory for data storage
+} osMessageQueueAttr_t;
+
+//  ==== Kernel Management Functions ====
+
+osStatus_t osKernelInitialize(void);
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size);
+osKernelState_t osKernelGetState(void);
+osStatus_t osKernelStart(void);
+int32_t osKernelLock(void);
+int32_t osKernelUnlock(void);
+int32_t osKernelRestoreLock(int32_t lock);
+uint32_t osKernelSuspend(void);
+void osKernelResume(uint32_t sleep_ticks);
+uint32_t osKernelGetTickCount(void);
+uint32_t osKernelGetTickFreq(void);
+uint32_t osKernelGetSysTimerCount(void);
+uint32_t osKernelGetSysTimerFreq(void);
+
+//  ==== Thread Management Functions ====
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr);
+const char *osThreadGetName(osThreadId_t thread_id);
+osThreadId_t osThreadGetId(void);
+osThreadState_t osThreadGetState(osThreadId_t thread_id);
+uint32_t osThreadGetStackSize(osThreadId_t thread_id);
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id);
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority);
+osPriority_t osThreadGetPriority(osThreadId_t thread_id);
+osStatus_t osThreadYield(void);
+osStatus_t osThreadSuspend(osThreadId_t thread_id);
+osStatus_t osThreadResume(osThreadId_t thread_id);
+void osThreadExit(void);
+osStatus_t osThreadTerminate(osThreadId_t thread_id);
+uint32_t osThreadGetCount(void);
+uint32_t osThreadEnumerate(osThreadId_t *thread_array, uint32_t array_items);
+
+//  ==== Thread Flags Functions ====
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsClear(uint32_t flags);
+uint32_t osThreadFlagsGet(void);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+//  ==== Generic Wait Functions ====
+
+osStatus_t osDelay(uint32_t ticks);
+osStatus_t osDelayUntil(uint32_t ticks);
+
+//  ==== Timer Management Functions ====
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *attr);
+const char *osTimerGetName(osTimerId_t timer_id);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+osStatus_t osTimerStop(osTimerId_t timer_id);
+uint32_t osTimerIsRunning(osTimerId_t timer_id);
+osStatus_t osTimerDelete(osTimerId_t timer_id);
+
+//  ==== Event Flags Management Functions ====
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr);
+const char *osEventFlagsGetName(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout);
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id);
+
+//  ==== Mutex Management Functions ====
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+const char *osMutexGetName(osMutexId_t mutex_id);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id);
+osStatus_t osMutexDelete(osMutexId_t mutex_id);
+
+//  ==== Semaphore Management Functions ====
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr);
+const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id);
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout);
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id);
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id);
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id);
+
+//  ==== Message Queue Management Functions ====
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr);
+const char *osMessageQueueGetName(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout);
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout);
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id);
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id);
+
+#ifdef  __cplusplus
+}
+#endif
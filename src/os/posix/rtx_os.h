@@ -0,0 +1,182 @@
+#pragma once
+
+/// Host replacement of the RTX5 "rtx_os.h".
+/// Control blocks keep the RTX type names so static objects of the os:: wrappers can be placed
+/// in user memory on the host exactly as on the target. Their layout is host specific.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "cmsis_os2.h"
+
+#ifdef  __cplusplus
+extern "C"
+{
+#endif
+
+/// Kernel Information
+#define osRtxVersionAPI      20010003   ///< API version (2.1.3)
+#define osRtxVersionKernel   50050004   ///< Kernel version (5.5.4)
+#define osRtxKernelId     "RTX V5.5.4"  ///< Kernel identification string
+
+/// Object Identifier definitions
+#define osRtxIdInvalid          0x00U
+#define osRtxIdThread           0xF1U
+#define osRtxIdTimer            0xF2U
+#define osRtxIdEventFlags       0xF3U
+#define osRtxIdMutex            0xF5U
+#define osRtxIdSemaphore        0xF6U
+#define osRtxIdMessageQueue     0xFAU
+
+/// Object Flags definitions
+#define osRtxFlagSystemObject   0x01U
+#define osRtxFlagSystemMemory   0x02U
+
+struct osRtxMutex_s;
+
+/// Stack Marker definitions
+#define osRtxStackMagicWord     0xE25A2EA5U ///< Stack Magic Word (Stack Base)
+#define osRtxStackFillPattern   0xCCCCCCCCU ///< Stack Fill Pattern
+
+/// Thread Control Block
+typedef struct osRtxThread_s
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t                       state;  ///< Object State
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                        attr;  ///< Object Attributes
+    const char                    *name;  ///< Object Name
+    struct osRtxThread_s   *thread_next;  ///< Link pointer to next Thread in Object list
+    struct osRtxThread_s   *thread_prev;  ///< Link pointer to previous Thread in Object list
+    struct osRtxThread_s     *wait_next;  ///< Link pointer to next Thread waiting for an object
+    struct osRtxThread_s    **wait_list;  ///< Wait list of the object the Thread is waiting for
+    struct osRtxThread_s    *ready_next;  ///< Link pointer to next Thread in Ready list (simulator)
+    int8_t                     priority;  ///< Thread Priority
+    int8_t                priority_base;  ///< Base Priority
+    uint8_t                     suspend;  ///< Suspend request (1 - requested, 2 - parked)
+    uint8_t                   terminate;  ///< Terminate request
+    uint8_t                       woken;  ///< Wake-up received while blocked
+    uint8_t               flags_options;  ///< Thread/Event Flags Options
+    uint32_t                 wait_flags;  ///< Waiting Thread/Event Flags
+    uint32_t               thread_flags;  ///< Thread Flags
+    int32_t                 wait_result;  ///< Result passed by the waker
+    void                      *wait_msg;  ///< Message buffer of a blocked put or get
+    uint8_t                  *wait_prio;  ///< Message priority of a blocked put or get
+    uint64_t                   deadline;  ///< Wake-up time of a timed wait (ns, 0 - none)
+    struct osRtxMutex_s     *mutex_list;  ///< Link pointer to list of owned Mutexes
+    osThreadFunc_t                 func;  ///< Thread function
+    void                           *arg;  ///< Thread function argument
+    void                     *stack_mem;  ///< Stack memory (not used for execution on host)
+    uint32_t                 stack_size;  ///< Stack Size
+    pthread_t                    handle;  ///< Host thread
+    pthread_cond_t                 cond;  ///< Wake-up condition
+} osRtxThread_t;
+
+/// Timer State definitions
+#define osRtxTimerInactive      0x00U   ///< Timer Inactive
+#define osRtxTimerStopped       0x01U   ///< Timer Stopped
+#define osRtxTimerRunning       0x02U   ///< Timer Running
+
+/// Timer Function Information
+typedef struct
+{
+    osTimerFunc_t                  func;  ///< Function Pointer
+    void                           *arg;  ///< Function Argument
+} osRtxTimerFinfo_t;
+
+/// Timer Control Block
+typedef struct osRtxTimer_s
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t                       state;  ///< Object State
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                        type;  ///< Timer Type (Periodic/One-shot)
+    const char                    *name;  ///< Object Name
+    struct osRtxTimer_s           *prev;  ///< Pointer to previous active Timer
+    struct osRtxTimer_s           *next;  ///< Pointer to next active Timer
+    uint32_t                       tick;  ///< Delta Tick Value
+    uint32_t                       load;  ///< Load Value
+    osRtxTimerFinfo_t             finfo;  ///< Timer Function Info
+} osRtxTimer_t;
+
+/// Event Flags Control Block
+typedef struct
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t              reserved_state;  ///< Object State (not used)
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                    reserved;
+    const char                    *name;  ///< Object Name
+    osRtxThread_t          *thread_list;  ///< Waiting Threads List
+    uint32_t                event_flags;  ///< Event Flags
+} osRtxEventFlags_t;
+
+/// Mutex Control Block
+typedef struct osRtxMutex_s
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t              reserved_state;  ///< Object State (not used)
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                        attr;  ///< Object Attributes
+    const char                    *name;  ///< Object Name
+    osRtxThread_t          *thread_list;  ///< Waiting Threads List
+    osRtxThread_t         *owner_thread;  ///< Owner Thread
+    struct osRtxMutex_s     *owner_prev;  ///< Pointer to previous Mutex in Thread owner list
+    struct osRtxMutex_s     *owner_next;  ///< Pointer to next Mutex in Thread owner list
+    uint8_t                        lock;  ///< Lock counter
+    uint8_t                  padding[3];
+} osRtxMutex_t;
+
+/// Semaphore Control Block
+typedef struct
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t              reserved_state;  ///< Object State (not used)
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                    reserved;
+    const char                    *name;  ///< Object Name
+    osRtxThread_t          *thread_list;  ///< Waiting Threads List
+    uint16_t                     tokens;  ///< Current number of tokens
+    uint16_t                 max_tokens;  ///< Maximum number of tokens
+} osRtxSemaphore_t;
+
+/// Semaphore token limit
+#define osRtxSemaphoreTokenLimit    65535U
+
+/// Message header in the queue memory (a block of the message size follows)
+typedef struct osRtxMessage_s
+{
+    struct osRtxMessage_s         *next;  ///< Next message in the queue or in the free list
+    uint8_t                    priority;  ///< Message Priority
+    uint8_t                  padding[7];
+} osRtxMessage_t;
+
+/// Message Queue Control Block
+typedef struct
+{
+    uint8_t                          id;  ///< Object Identifier
+    uint8_t                       flags;  ///< Object Flags
+    uint8_t                  padding[2];
+    const char                    *name;  ///< Object Name
+    osRtxThread_t          *thread_list;  ///< Waiting Threads List (senders if full, receivers if empty)
+    uint32_t                   msg_size;  ///< Message Size
+    uint32_t                  max_count;  ///< Capacity
+    uint32_t                  msg_count;  ///< Number of queued Messages
+    osRtxMessage_t            *msg_free;  ///< Free Message blocks
+    osRtxMessage_t           *msg_first;  ///< First Message (highest priority)
+} osRtxMessageQueue_t;
+
+/// Message Queue Data Memory size (header and data rounded up to 8 bytes per message)
+#define osRtxMessageQueueMemSize(msg_count, msg_size) \
+    ((msg_count) * (sizeof(osRtxMessage_t) + (((msg_size) + 7U) & ~7U)))
+
+/// 64-bit system timer count (host backend only; lock free like osKernelGetSysTimerCount).
+uint64_t osRtxSysTimerCount64(void);
+
+/// Thread switch event of the RTX Event Recorder interface (simulator only; weak, may be overridden).
+void EvrRtxThreadSwitched(osThreadId_t thread_id);
+
+#ifdef  __cplusplus
+}
+#endif
@@ -0,0 +1,26 @@
+/// Host implementation of os::timestamp on the 64-bit system timer of the backend (host time or
+/// virtual time, in nanoseconds since osKernelInitialize), which needs no wrap extension.
+
+#include "cmsis_os2.h"
+#include "rtx_os.h"
+
+#include "timestamp.h"
+
+namespace os::timestamp
+{
+
+void init(void)
+{
+}
+
+uint64_t now(void)
+{
+    return osRtxSysTimerCount64();
+}
+
+uint32_t get_freq(void)
+{
+    return osKernelGetSysTimerFreq();
+}
+
+} // namespace os::timestamp
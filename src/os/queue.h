@@ -0,0 +1,360 @@
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "os.h"
+#include "chrono.h"
+#include "waiters.h"
+
+#include "rtx_os.h"
+
+namespace os
+{
+
+/// Static message queue of trivially copyable messages.
+/// The control block and the message storage are members, so a queue defined at namespace scope
+/// uses neither the RTX object pool (OS_MSGQUEUE_NUM) nor the global data pool
+/// (OS_MSGQUEUE_DATA_SIZE). Define it in the OS control block section to keep it with other RTX
+/// objects: `static os::queue<frame_t, 8> q __attribute__((section(".bss.os.msgqueue.cb")));`.
+/// put and get copy the message; for large messages use @ref borrow_queue. A successful put
+/// notifies the @ref waiters hook.
+/// put and get may be called from interrupts with timeout 0.
+/// \tparam T            message type.
+/// \tparam N            capacity in messages.
+template <class T, uint32_t N>
+class queue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Queue messages are copied with memcpy, use os::borrow_queue.");
+    static_assert(N != 0U, "Queue capacity must not be zero.");
+
+private:
+    osRtxMessageQueue_t cb_;
+    alignas(8) uint8_t mem_[osRtxMessageQueueMemSize(N, sizeof(T))];
+    waiters waiters_;
+
+public:
+    static constexpr uint32_t capacity = N;
+
+    constexpr queue(): cb_(), mem_(), waiters_() {}
+
+    queue(const queue &) = delete;
+    queue &operator=(const queue &) = delete;
+
+    /// Create the queue (the kernel must be initialized).
+    /// \param[in]     name          name of the queue (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t create(const char *_name = nullptr)
+    {
+        const osMessageQueueAttr_t attr =
+        {
+            .name       = _name,
+            .attr_bits  = 0U,
+            .cb_mem     = &cb_,
+            .cb_size    = sizeof(cb_),
+            .mq_mem     = mem_,
+            .mq_size    = sizeof(mem_),
+        };
+
+        return (osMessageQueueNew(N, sizeof(T), &attr) != nullptr) ? sts_t::OK : sts_t::err;
+    }
+
+    /// Get the message queue ID.
+    /// \return message queue ID for reference by other functions.
+    osMessageQueueId_t get_id(void)
+    {
+        return &cb_;
+    }
+
+    /// Get name of the queue.
+    /// \return name as null-terminated string.
+    const char *get_name(void)
+    {
+        return osMessageQueueGetName(&cb_);
+    }
+
+    /// Put a message into the queue or timeout if it is full.
+    /// \param[in]     msg           message.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     prio          message priority (higher priority messages are got first).
+    /// \return status code that indicates the execution status of the function.
+    sts_t put(const T &_msg, const uint32_t _timeout = forever, const uint8_t _prio = 0U)
+    {
+        const sts_t sts = static_cast<sts_t>(osMessageQueuePut(&cb_, &_msg, _prio, _timeout));
+        if (sts == sts_t::OK)
+        {
+            waiters_.notify();
+        }
+        return sts;
+    }
+
+    /// Put a message into the queue or timeout if it is full.
+    /// \param[in]     msg           message.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \param[in]     prio          message priority (higher priority messages are got first).
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t put(const T &_msg, const std::chrono::duration<_rep, _period> &_timeout, const uint8_t _prio = 0U)
+    {
+        return put(_msg, to_ticks(_timeout).count(), _prio);
+    }
+
+    /// Get a message from the queue or timeout if it is empty.
+    /// \param[out]    msg           message.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return status code that indicates the execution status of the function.
+    sts_t get(T &_msg, const uint32_t _timeout = forever)
+    {
+        return static_cast<sts_t>(osMessageQueueGet(&cb_, &_msg, nullptr, _timeout));
+    }
+
+    /// Get a message from the queue or timeout if it is empty.
+    /// \param[out]    msg           message.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t get(T &_msg, const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return get(_msg, to_ticks(_timeout).count());
+    }
+
+    /// \return number of queued messages.
+    uint32_t get_count(void)
+    {
+        return osMessageQueueGetCount(&cb_);
+    }
+
+    /// \return number of free message slots.
+    uint32_t get_space(void)
+    {
+        return osMessageQueueGetSpace(&cb_);
+    }
+
+    /// Discard the queued messages (not from interrupts).
+    /// \return status code that indicates the execution status of the function.
+    sts_t reset(void)
+    {
+        return static_cast<sts_t>(osMessageQueueReset(&cb_));
+    }
+
+    /// Delete the queue. Waiting threads are woken with @ref sts_t::err_resource.
+    /// \return status code that indicates the execution status of the function.
+    sts_t destroy(void)
+    {
+        const sts_t sts = static_cast<sts_t>(osMessageQueueDelete(&cb_));
+        waiters_.notify();
+        return sts;
+    }
+
+    /// Get the completion hook (for waiting without a thread, see @ref waiters).
+    waiters &get_waiters(void)
+    {
+        return waiters_;
+    }
+};
+
+/// Zero-copy message queue: messages live in N static slots and only pointers are queued.
+/// The sender constructs a message in a free slot (@ref alloc) and sends it, the receiver gets a
+/// @ref handle that returns the slot when it goes out of scope. Two RTX queues of pointers carry
+/// the slots (sent and free), so both sides block like on a plain queue: the sender while all
+/// slots are in use, the receiver while nothing is sent. send never blocks, since a slot always
+/// has room in the sent queue. Any type may be used, the message is never copied or moved.
+/// A message takes four queue operations instead of two, so borrowing pays off for messages whose
+/// two copies cost more than that (on a PC host from a few kilobytes, see tools/queue_bench).
+/// \tparam T            message type.
+/// \tparam N            number of slots.
+template <class T, uint32_t N>
+class borrow_queue
+{
+public:
+    /// Received message. Move-only; returns the slot to the queue when destroyed.
+    class handle
+    {
+    private:
+        borrow_queue *queue_;
+        T *msg_;
+
+    public:
+        constexpr handle(): queue_(nullptr), msg_(nullptr) {}
+        constexpr handle(borrow_queue &_queue, T *_msg): queue_(&_queue), msg_(_msg) {}
+
+        handle(handle &&_other): queue_(_other.queue_), msg_(_other.msg_)
+        {
+            _other.msg_ = nullptr;
+        }
+
+        handle &operator=(handle &&_other)
+        {
+            if (this != &_other)
+            {
+                reset();
+                queue_ = _other.queue_;
+                msg_ = _other.msg_;
+                _other.msg_ = nullptr;
+            }
+            return *this;
+        }
+
+        handle(const handle &) = delete;
+        handle &operator=(const handle &) = delete;
+
+        ~handle()
+        {
+            reset();
+        }
+
+        /// Return the message to the queue now.
+        void reset(void)
+        {
+            if (msg_ != nullptr)
+            {
+                queue_->release(msg_);
+                msg_ = nullptr;
+            }
+        }
+
+        /// Give up ownership without returning the slot (pass it to @ref release later).
+        /// \return message or nullptr.
+        T *release(void)
+        {
+            T *msg = msg_;
+            msg_ = nullptr;
+            return msg;
+        }
+
+        /// \return message or nullptr.
+        T *get(void) const
+        {
+            return msg_;
+        }
+
+        T *operator->(void) const
+        {
+            return msg_;
+        }
+
+        T &operator*(void) const
+        {
+            return *msg_;
+        }
+
+        /// \return true if a message was received.
+        explicit operator bool(void) const
+        {
+            return msg_ != nullptr;
+        }
+    };
+
+private:
+    queue<T *, N> sent_;
+    queue<T *, N> free_;
+    alignas(T) uint8_t slots_[N][sizeof(T)];
+
+public:
+    static constexpr uint32_t capacity = N;
+
+    constexpr borrow_queue(): sent_(), free_(), slots_() {}
+
+    borrow_queue(const borrow_queue &) = delete;
+    borrow_queue &operator=(const borrow_queue &) = delete;
+
+    /// Create the queue (the kernel must be initialized).
+    /// \param[in]     name          name of the queue (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t create(const char *_name = nullptr)
+    {
+        if (sent_.create(_name) != sts_t::OK || free_.create(_name) != sts_t::OK)
+        {
+            return sts_t::err;
+        }
+        for (uint32_t i = 0U; i < N; i++)
+        {
+            free_.put(reinterpret_cast<T *>(slots_[i]), 0U);
+        }
+        return sts_t::OK;
+    }
+
+    /// Take a free slot and construct a message in it.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     args          constructor arguments of the message.
+    /// \return message to fill and pass to @ref send (or @ref release), nullptr on timeout.
+    template <class... _args>
+    T *alloc(const uint32_t _timeout, _args &&..._arg)
+    {
+        T *slot;
+        if (free_.get(slot, _timeout) != sts_t::OK)
+        {
+            return nullptr;
+        }
+        return new (slot) T(std::forward<_args>(_arg)...);
+    }
+
+    /// Send a message taken by @ref alloc (never blocks).
+    /// \param[in]     msg           message.
+    /// \param[in]     prio          message priority (higher priority messages are received first).
+    /// \return status code that indicates the execution status of the function.
+    sts_t send(T *_msg, const uint8_t _prio = 0U)
+    {
+        return sent_.put(_msg, 0U, _prio);
+    }
+
+    /// Construct a message in a free slot and send it.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \param[in]     args          constructor arguments of the message.
+    /// \return status code that indicates the execution status of the function.
+    template <class... _args>
+    sts_t emplace(const uint32_t _timeout, _args &&..._arg)
+    {
+        T *msg = alloc(_timeout, std::forward<_args>(_arg)...);
+        if (msg == nullptr)
+        {
+            return (_timeout == 0U) ? sts_t::err_resource : sts_t::err_timeout;
+        }
+        return send(msg);
+    }
+
+    /// Receive a message or timeout if none is sent.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return handle of the message (empty on timeout).
+    handle receive(const uint32_t _timeout = forever)
+    {
+        T *msg;
+        if (sent_.get(msg, _timeout) != sts_t::OK)
+        {
+            return handle();
+        }
+        return handle(*this, msg);
+    }
+
+    /// Receive a message or timeout if none is sent.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return handle of the message (empty on timeout).
+    template <class _rep, class _period>
+    handle receive(const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return receive(to_ticks(_timeout).count());
+    }
+
+    /// Destroy a message and return its slot (received, or allocated and not sent).
+    /// \param[in]     msg           message.
+    void release(T *_msg)
+    {
+        _msg->~T();
+        free_.put(_msg, 0U);
+    }
+
+    /// \return number of sent and not yet received messages.
+    uint32_t get_count(void)
+    {
+        return sent_.get_count();
+    }
+
+    /// \return number of free slots.
+    uint32_t get_space(void)
+    {
+        return free_.get_count();
+    }
+};
+
+} // namespace os
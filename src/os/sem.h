@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+
+#include "os.h"
+#include "chrono.h"
+#include "waiters.h"
+
+#include "rtx_os.h"
+
+namespace os
+{
+
+/// Static counting semaphore with a lock-free fast path.
+/// The tokens are counted in an atomic word of the object; the RTX semaphore (a member control
+/// block, so no OS_SEMAPHORE_NUM pool object) is used only to block and wake threads. A negative
+/// count is the number of waiting threads. So an acquire that finds a token and a release that
+/// finds no waiter are a single LDREX/STREX update without a kernel call; in particular a release
+/// from an interrupt with no thread waiting neither enters RTX nor takes an ISR FIFO entry. Only a
+/// release that must wake a thread calls osSemaphoreRelease; one that does not checks the
+/// @ref waiters hook instead, an atomic load. The gain is on the counting path;
+/// the wake-up itself is the kernel's (tools/sem_bench measures both on the host).
+/// Define it in the OS control block section to keep it with other RTX objects:
+/// `static os::semaphore<4> sem __attribute__((section(".bss.os.semaphore.cb")));`.
+/// release and acquire with timeout 0 may be called from interrupts.
+/// \tparam _max         maximum number of tokens.
+/// \tparam _initial     initial number of tokens.
+template <uint32_t _max, uint32_t _initial = 0U>
+class semaphore
+{
+    static_assert(_max != 0U && _max <= osRtxSemaphoreTokenLimit, "Semaphore maximum count is out of range.");
+    static_assert(_initial <= _max, "Semaphore initial count exceeds the maximum.");
+    static_assert(std::atomic<int32_t>::is_always_lock_free, "Semaphore count must be lock-free.");
+
+private:
+    std::atomic<int32_t> count_;
+    osRtxSemaphore_t cb_;
+    waiters waiters_;
+
+    /// Take a token if there is one.
+    bool try_take(void)
+    {
+        int32_t count = count_.load(std::memory_order_relaxed);
+        while (count > 0)
+        {
+            if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    static constexpr uint32_t max_count = _max;
+
+    constexpr semaphore(): count_(static_cast<int32_t>(_initial)), cb_(), waiters_() {}
+
+    semaphore(const semaphore &) = delete;
+    semaphore &operator=(const semaphore &) = delete;
+
+    /// Create the semaphore (the kernel must be initialized).
+    /// \param[in]     name          name of the semaphore (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t create(const char *_name = nullptr)
+    {
+        const osSemaphoreAttr_t attr =
+        {
+            .name       = _name,
+            .attr_bits  = 0U,
+            .cb_mem     = &cb_,
+            .cb_size    = sizeof(cb_),
+        };
+
+        // Kernel tokens are only the hand-overs to waiting threads
+        return (osSemaphoreNew(osRtxSemaphoreTokenLimit, 0U, &attr) != nullptr) ? sts_t::OK : sts_t::err;
+    }
+
+    /// Get the semaphore ID.
+    /// \return semaphore ID for reference by other functions.
+    osSemaphoreId_t get_id(void)
+    {
+        return &cb_;
+    }
+
+    /// Get name of the semaphore.
+    /// \return name as null-terminated string.
+    const char *get_name(void)
+    {
+        return osSemaphoreGetName(&cb_);
+    }
+
+    /// Acquire a token or timeout if no tokens are available.
+    /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+    /// \return status code that indicates the execution status of the function.
+    sts_t acquire(const uint32_t _timeout = forever)
+    {
+        if (_timeout == 0U)
+        {
+            return try_take() ? sts_t::OK : sts_t::err_resource;
+        }
+        if (count_.fetch_sub(1, std::memory_order_acquire) > 0)
+        {
+            return sts_t::OK;
+        }
+
+        const sts_t sts = static_cast<sts_t>(osSemaphoreAcquire(&cb_, _timeout));
+        if (sts == sts_t::OK)
+        {
+            return sts;
+        }
+
+        // Withdraw from the waiters, unless a release has already handed a token over
+        int32_t count = count_.load(std::memory_order_relaxed);
+        while (count < 0)
+        {
+            if (count_.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+            {
+                return sts;
+            }
+        }
+        return static_cast<sts_t>(osSemaphoreAcquire(&cb_, forever));
+    }
+
+    /// Acquire a token or timeout if no tokens are available.
+    /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+    /// \return status code that indicates the execution status of the function.
+    template <class _rep, class _period>
+    sts_t acquire(const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return acquire(to_ticks(_timeout).count());
+    }
+
+    /// Release a token (callable from interrupts).
+    /// \return status code (@ref sts_t::err_resource - the maximum count is reached).
+    sts_t release(void)
+    {
+        int32_t count = count_.load(std::memory_order_relaxed);
+        do
+        {
+            if (count >= static_cast<int32_t>(_max))
+            {
+                return sts_t::err_resource;
+            }
+        } while (!count_.compare_exchange_weak(count, count + 1, std::memory_order_release, std::memory_order_relaxed));
+
+        if (count < 0)
+        {
+            return static_cast<sts_t>(osSemaphoreRelease(&cb_));
+        }
+        waiters_.notify();
+        return sts_t::OK;
+    }
+
+    /// \return number of available tokens.
+    uint32_t get_count(void) const
+    {
+        const int32_t count = count_.load(std::memory_order_relaxed);
+        return (count > 0) ? static_cast<uint32_t>(count) : 0U;
+    }
+
+    /// Delete the semaphore. Waiting threads are woken with @ref sts_t::err_resource.
+    /// \return status code that indicates the execution status of the function.
+    sts_t destroy(void)
+    {
+        const sts_t sts = static_cast<sts_t>(osSemaphoreDelete(&cb_));
+        waiters_.notify();
+        return sts;
+    }
+
+    /// Get the completion hook (for waiting without a thread, see @ref waiters).
+    waiters &get_waiters(void)
+    {
+        return waiters_;
+    }
+};
+
+/// Binary semaphore (one token, initially taken).
+using binary_semaphore = semaphore<1U, 0U>;
+
+} // namespace os
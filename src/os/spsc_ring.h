@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <span>
+
+#ifndef OS_CACHE_LINE_SIZE
+    #if defined(__ARM_ARCH)
+        #define OS_CACHE_LINE_SIZE 4  ///< No data cache on Cortex-M4: keep the indices in separate words only
+    #else
+        #define OS_CACHE_LINE_SIZE 64 ///< Host: keep producer and consumer indices in separate cache lines
+    #endif
+#endif
+
+namespace os
+{
+
+/// Lock-free single producer, single consumer ring buffer.
+/// One context (e.g. an ISR) pushes and one context (e.g. a thread) pops; neither disables
+/// interrupts. Each index is written by one side only, with release/acquire ordering, which is
+/// a plain aligned word store/load plus DMB on Cortex-M4. Indices run freely and wrap at 2^32,
+/// so all N slots are usable.
+/// \tparam T            element type.
+/// \tparam N            capacity in elements (power of two).
+template <typename T, uint32_t N>
+class spsc_ring
+{
+    static_assert(N != 0U && (N & (N - 1U)) == 0U, "Ring size must be a power of two.");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Ring indices must be lock-free.");
+
+private:
+    alignas(OS_CACHE_LINE_SIZE) std::atomic<uint32_t> head_;  ///< Written by the producer
+    alignas(OS_CACHE_LINE_SIZE) std::atomic<uint32_t> tail_;  ///< Written by the consumer
+    alignas(std::max<size_t>(OS_CACHE_LINE_SIZE, alignof(T))) T buf_[N];
+
+    static constexpr uint32_t mask_ = N - 1U;
+
+public:
+    static constexpr uint32_t capacity = N;
+
+    constexpr spsc_ring(): head_(0U), tail_(0U), buf_() {}
+
+    spsc_ring(const spsc_ring &) = delete;
+    spsc_ring &operator=(const spsc_ring &) = delete;
+
+    /// Push one element (producer only).
+    /// \return false if the ring is full.
+    bool push(const T &_val)
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N)
+        {
+            return false;
+        }
+        buf_[head & mask_] = _val;
+        head_.store(head + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /// Push as many elements as fit (producer only).
+    /// \param[in]     vals          elements to push.
+    /// \return number of elements pushed.
+    uint32_t push(const std::span<const T> _vals)
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t free = N - (head - tail_.load(std::memory_order_acquire));
+        const uint32_t cnt = (_vals.size() < free) ? static_cast<uint32_t>(_vals.size()) : free;
+
+        for (uint32_t i = 0U; i < cnt; i++)
+        {
+            buf_[(head + i) & mask_] = _vals[i];
+        }
+        head_.store(head + cnt, std::memory_order_release);
+        return cnt;
+    }
+
+    /// Pop one element (consumer only).
+    /// \return false if the ring is empty.
+    bool pop(T &_val)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail)
+        {
+            return false;
+        }
+        _val = buf_[tail & mask_];
+        tail_.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /// Pop up to the size of the destination (consumer only).
+    /// \param[out]    vals          destination.
+    /// \return number of elements popped.
+    uint32_t pop(const std::span<T> _vals)
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t used = head_.load(std::memory_order_acquire) - tail;
+        const uint32_t cnt = (_vals.size() < used) ? static_cast<uint32_t>(_vals.size()) : used;
+
+        for (uint32_t i = 0U; i < cnt; i++)
+        {
+            _vals[i] = buf_[(tail + i) & mask_];
+        }
+        tail_.store(tail + cnt, std::memory_order_release);
+        return cnt;
+    }
+
+    /// Readable elements in place (consumer only): the first contiguous part of the ring content.
+    /// Release them with @ref consume. Call again after consuming to get the part after the wrap.
+    std::span<const T> peek(void) const
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t used = head_.load(std::memory_order_acquire) - tail;
+        const uint32_t off = tail & mask_;
+        return {&buf_[off], (used < N - off) ? used : N - off};
+    }
+
+    /// Release elements obtained by @ref peek (consumer only).
+    void consume(const uint32_t _cnt)
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + _cnt, std::memory_order_release);
+    }
+
+    /// \return number of stored elements (exact for the producer and the consumer, a snapshot for others).
+    uint32_t size(void) const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty(void) const
+    {
+        return size() == 0U;
+    }
+
+    bool full(void) const
+    {
+        return size() == N;
+    }
+};
+
+} // namespace os
@@ -0,0 +1,136 @@
+#include "misc.h"
+#include "thread.h"
+#include "stack.h"
+
+namespace os::stack
+{
+
+struct entry_t
+{
+    osThreadId_t id;
+    scan_t       scan;
+    bool         warned;
+};
+
+/// Written by the monitor thread under the kernel lock.
+static entry_t table[OS_STACK_MONITOR_THREAD_NUM];
+static uint32_t count;
+
+/// Sync the table with the active threads. Entries of threads that are gone are dropped, new
+/// threads (or threads restarted with another stack) start a fresh scan.
+static void refresh(void)
+{
+    osThreadId_t ids[OS_STACK_MONITOR_THREAD_NUM];
+    const uint32_t cnt = osThreadEnumerate(ids, OS_STACK_MONITOR_THREAD_NUM);
+
+    const sts_t lock = kernel::lock();
+
+    uint32_t kept = 0U;
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        for (uint32_t j = 0U; j < cnt; j++)
+        {
+            if (ids[j] == table[i].id && static_cast<const osRtxThread_t *>(ids[j])->stack_mem == table[i].scan.mem)
+            {
+                table[kept++] = table[i];
+                ids[j] = nullptr;
+                break;
+            }
+        }
+    }
+    count = kept;
+
+    for (uint32_t j = 0U; j < cnt && count < OS_STACK_MONITOR_THREAD_NUM; j++)
+    {
+        const osRtxThread_t *cb = static_cast<const osRtxThread_t *>(ids[j]);
+        if (cb == nullptr || cb->stack_mem == nullptr || cb->stack_size < 2U * sizeof(uint32_t))
+        {
+            continue;
+        }
+        table[count++] = {ids[j], scan_t(static_cast<const uint32_t *>(cb->stack_mem), static_cast<uint32_t>(cb->stack_size / sizeof(uint32_t))), false};
+    }
+
+    kernel::restore_lock(lock);
+}
+
+/// Check a few words of one stack.
+/// \return true when the round of this stack has finished.
+static bool pass(entry_t &_entry)
+{
+    const sts_t lock = kernel::lock();
+    const bool done = _entry.scan.step(OS_STACK_MONITOR_WORDS);
+    kernel::restore_lock(lock);
+
+    const uint32_t size = _entry.scan.size();
+    if (!_entry.warned && _entry.scan.peak() * 100U >= size * OS_STACK_MONITOR_WARN)
+    {
+        _entry.warned = true;
+        const char *name = osThreadGetName(_entry.id);
+        printwarn("Stack use of thread '%s' reached %u of %u bytes.\n", (name != nullptr) ? name : "undefined",
+                  _entry.scan.peak(), size);
+    }
+    return done;
+}
+
+class monitor: public thread<monitor, OS_STACK_SIZE, priority::low>
+{
+public:
+    void run(void)
+    {
+        uint32_t idx = 0U;
+        for (;;)
+        {
+            if (idx >= count)
+            {
+                refresh();
+                idx = 0U;
+            }
+            if (idx < count && pass(table[idx]))
+            {
+                idx++;
+            }
+            delay(OS_STACK_MONITOR_PERIOD);
+        }
+    }
+};
+
+static_assert(config::usage_of<monitor>() == usage, "os::stack::usage does not match the monitor thread.");
+
+static monitor monitor_thread;
+
+sts_t start(void)
+{
+    return monitor_thread.start("stack");
+}
+
+uint32_t get_usage(usage_t *_usage, const uint32_t _cnt)
+{
+    const sts_t lock = kernel::lock();
+    uint32_t i = 0U;
+    for (; i < count && i < _cnt; i++)
+    {
+        _usage[i] = {table[i].id, table[i].scan.size(), table[i].scan.peak()};
+    }
+    kernel::restore_lock(lock);
+
+    return i;
+}
+
+uint32_t get_peak(const osThreadId_t _id)
+{
+    const sts_t lock = kernel::lock();
+    uint32_t peak = 0U;
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (table[i].id == _id)
+        {
+            peak = table[i].scan.peak();
+            break;
+        }
+    }
+    kernel::restore_lock(lock);
+
+    return peak;
+}
+
+} // namespace os::stack
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "os.h"
+#include "config.h"
+
+#include "rtx_os.h"
+
+#ifndef OS_STACK_MONITOR_THREAD_NUM
+    #define OS_STACK_MONITOR_THREAD_NUM 16  ///< Number of monitored threads
+#endif
+
+#ifndef OS_STACK_MONITOR_WORDS
+    #define OS_STACK_MONITOR_WORDS 16       ///< Stack words checked per pass
+#endif
+
+#ifndef OS_STACK_MONITOR_PERIOD
+    #define OS_STACK_MONITOR_PERIOD 10      ///< Pass period in ticks
+#endif
+
+#ifndef OS_STACK_MONITOR_WARN
+    #define OS_STACK_MONITOR_WARN 75        ///< Warning threshold in percent of the stack size
+#endif
+
+/// Stack high-water-mark monitor.
+/// RTX fills thread stacks with a pattern (OS_STACK_WATERMARK). A low priority thread walks each
+/// stack from the bottom up to the first overwritten word, a few words per pass, and keeps the
+/// deepest use per thread. A warning is printed once when a thread reaches the threshold, i.e.
+/// before the overflow that osRtxErrorNotify reports.
+namespace os::stack
+{
+
+/// Kernel resources of the monitor (see @ref config::check).
+constexpr config::usage_t usage = {.threads = 1U, .stack = OS_STACK_SIZE, .isr_fifo = 0U};
+
+/// Stack fill pattern of RTX.
+constexpr uint32_t fill_pattern = osRtxStackFillPattern;
+
+/// Incremental watermark scan of one stack (kernel independent, so it can be tested on a host).
+/// A round walks from the bottom (word 0 holds the RTX magic word) to the first overwritten
+/// word; the round ends there or at the deepest use found before, then starts again.
+struct scan_t
+{
+    const uint32_t *mem;    ///< Stack memory.
+    uint32_t        words;  ///< Stack size in words.
+    uint32_t        mark;   ///< Lowest overwritten word (words - nothing used yet).
+    uint32_t        cursor; ///< Next word to check.
+
+    constexpr scan_t(): mem(nullptr), words(0U), mark(0U), cursor(1U) {}
+
+    constexpr scan_t(const uint32_t *_mem, const uint32_t _words): mem(_mem), words(_words), mark(_words), cursor(1U) {}
+
+    /// Check up to `cnt` words.
+    /// \return true when a round has finished.
+    bool step(uint32_t _cnt)
+    {
+        for (; _cnt != 0U && cursor < mark; _cnt--, cursor++)
+        {
+            if (mem[cursor] != fill_pattern)
+            {
+                mark = cursor;
+            }
+        }
+        if (cursor >= mark)
+        {
+            cursor = 1U;
+            return true;
+        }
+        return false;
+    }
+
+    /// \return stack size in bytes.
+    uint32_t size(void) const
+    {
+        return words * static_cast<uint32_t>(sizeof(uint32_t));
+    }
+
+    /// \return peak stack use in bytes.
+    uint32_t peak(void) const
+    {
+        return (words - mark) * static_cast<uint32_t>(sizeof(uint32_t));
+    }
+};
+
+/// Stack use of a thread.
+struct usage_t
+{
+    osThreadId_t id;        ///< Thread ID.
+    uint32_t     size;      ///< Stack size in bytes.
+    uint32_t     peak;      ///< Peak stack use in bytes (exact once a full round has been scanned).
+};
+
+/// Start the monitor thread (the kernel must be initialized).
+/// \return status code that indicates the execution status of the function.
+sts_t start(void);
+
+/// Get stack use of the monitored threads.
+/// \param[out]    usage         array for the results.
+/// \param[in]     cnt           array size.
+/// \return number of entries written.
+uint32_t get_usage(usage_t *_usage, const uint32_t _cnt);
+
+/// Get peak stack use of a thread.
+/// \param[in]     id            thread ID.
+/// \return peak stack use in bytes (0 if the thread is not monitored yet).
+uint32_t get_peak(const osThreadId_t _id);
+
+} // namespace os::stack
@@ -1,12 +1,171 @@
+#pragma once
 
 #include "os.h"
+#include "config.h"
 
 #include "rtx_os.h"
 #include "RTX_Config.h"
 
 namespace os
 {
-    
-    
-    
+
+/// Thread state.
+enum class tsts_t : int32_t
+{
+    inactive        =  0,         ///< Inactive.
+    ready           =  1,         ///< Ready.
+    running         =  2,         ///< Running.
+    blocked         =  3,         ///< Blocked.
+    terminated      =  4,         ///< Terminated.
+    err             = -1,         ///< Error.
+    reserved        = 0x7FFFFFFF  ///< Prevents enum down-size compiler optimization.
+};
+
+/// Static thread (CRTP base).
+/// Control block and stack are placed in static memory per derived class, so no RTX object pool
+/// and no heap are used. The derived class must provide `void run(void)`.
+/// The thread ID is static too: all objects of a derived class are the same thread, and @ref start
+/// fails while it runs. Define one object per derived class.
+/// \tparam _derived     derived thread class.
+/// \tparam _stack_size  stack size in bytes (multiple of 8).
+/// \tparam _prio        initial thread priority.
+template <class _derived, uint32_t _stack_size = OS_STACK_SIZE, priority _prio = priority::normal>
+class thread
+{
+    static_assert(_stack_size % 8U == 0U, "Thread stack size must be a multiple of 8 bytes.");
+    static_assert(_stack_size >= 72U, "Thread stack size is less than the minimal RTX thread stack size.");
+    static_assert(_prio > priority::idle && _prio <= priority::ISR, "Illegal thread priority.");
+
+private:
+    inline static osRtxThread_t cb_ __attribute__((section(".bss.os.thread.cb")));
+    alignas(8) inline static uint64_t stack_[_stack_size / sizeof(uint64_t)] __attribute__((section(".bss.os.thread.stack")));
+
+    inline static osThreadId_t id_;
+    inline static bool         added_;  ///< Usage added to config::get_usage
+
+    static void entry_(void *_arg)
+    {
+        static_cast<_derived *>(_arg)->run();
+    }
+
+public:
+    static constexpr uint32_t stack_size = _stack_size;
+
+    /// Kernel resources of the thread (see @ref config::check).
+    static constexpr config::usage_t usage = {.threads = 1U, .stack = _stack_size, .isr_fifo = 0U};
+
+    constexpr thread() {}
+
+    thread(const thread &) = delete;
+    thread &operator=(const thread &) = delete;
+
+    /// Create the thread and add it to Active Threads.
+    /// The first start adds the @ref usage of the class to the application total (see @ref config::add).
+    /// \param[in]     name          name of the thread (null for none).
+    /// \return status code that indicates the execution status of the function
+    /// (@ref sts_t::err_nomem - the kernel configuration is exceeded).
+    sts_t start(const char *_name = nullptr)
+    {
+        switch (get_state())
+        {
+            case tsts_t::ready:
+            case tsts_t::running:
+            case tsts_t::blocked:
+                return sts_t::err_resource;
+            default:
+                break;
+        }
+
+        if (!added_)
+        {
+            if (!config::add(usage, _name))
+            {
+                return sts_t::err_nomem;
+            }
+            added_ = true;
+        }
+
+        const osThreadAttr_t attr =
+        {
+            .name       = _name,
+            .attr_bits  = osThreadDetached,
+            .cb_mem     = &cb_,
+            .cb_size    = sizeof(cb_),
+            .stack_mem  = stack_,
+            .stack_size = sizeof(stack_),
+            .priority   = static_cast<osPriority_t>(_prio),
+            .tz_module  = 0,
+            .reserved   = 0,
+        };
+
+        id_ = osThreadNew(entry_, static_cast<_derived *>(this), &attr);
+
+        return (id_ != nullptr) ? sts_t::OK : sts_t::err;
+    }
+
+    /// Get the thread ID.
+    /// \return thread ID for reference by other functions or NULL if the thread was not started.
+    osThreadId_t get_id(void) const
+    {
+        return id_;
+    }
+
+    /// Get name of the thread.
+    /// \return name as null-terminated string.
+    const char *get_name(void) const
+    {
+        return (id_ != nullptr) ? osThreadGetName(id_) : nullptr;
+    }
+
+    /// Get current thread state.
+    /// \return current thread state.
+    tsts_t get_state(void) const
+    {
+        return (id_ != nullptr) ? static_cast<tsts_t>(osThreadGetState(id_)) : tsts_t::inactive;
+    }
+
+    /// Get available stack space of the thread based on stack watermark recording during execution.
+    /// \return remaining stack space in bytes.
+    uint32_t get_stack_space(void) const
+    {
+        return (id_ != nullptr) ? osThreadGetStackSpace(id_) : _stack_size;
+    }
+
+    /// Change priority of the thread.
+    /// \param[in]     priority      new priority value for the thread function.
+    /// \return status code that indicates the execution status of the function.
+    sts_t set_priority(const priority _priority)
+    {
+        return static_cast<sts_t>(osThreadSetPriority(id_, static_cast<osPriority_t>(_priority)));
+    }
+
+    /// Get current priority of the thread.
+    /// \return current priority value of the thread.
+    priority get_priority(void) const
+    {
+        return static_cast<priority>(osThreadGetPriority(id_));
+    }
+
+    /// Suspend execution of the thread.
+    /// \return status code that indicates the execution status of the function.
+    sts_t suspend(void)
+    {
+        return static_cast<sts_t>(osThreadSuspend(id_));
+    }
+
+    /// Resume execution of the thread.
+    /// \return status code that indicates the execution status of the function.
+    sts_t resume(void)
+    {
+        return static_cast<sts_t>(osThreadResume(id_));
+    }
+
+    /// Terminate execution of the thread.
+    /// \return status code that indicates the execution status of the function.
+    sts_t terminate(void)
+    {
+        return static_cast<sts_t>(osThreadTerminate(id_));
+    }
+};
+
 } // namespace os
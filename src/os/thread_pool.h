@@ -0,0 +1,422 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <tuple>
+#include <utility>
+
+#include "os.h"
+#include "config.h"
+#include "thread.h"
+#include "queue.h"
+#include "pool.h"
+#include "sem.h"
+
+#include "rtx_os.h"
+
+#ifndef OS_THREAD_POOL_FLAG
+    #define OS_THREAD_POOL_FLAG 0x40000000U ///< Thread flag that wakes a thread waiting in parallel_for
+#endif
+
+namespace os
+{
+
+/// Thread pool statistics.
+struct thread_pool_stats_t
+{
+    uint32_t batches;       ///< parallel_for calls.
+    uint32_t chunks;        ///< Ranges passed to the job function.
+    uint32_t splits;        ///< Ranges split into a job for other workers.
+    uint32_t steals;        ///< Jobs taken from the deque of another worker.
+    uint32_t inlined;       ///< Splits skipped because the job storage or the deque was full.
+    uint32_t wakeups;       ///< Idle worker wake-ups.
+};
+
+/// Work-stealing thread pool for batch jobs.
+/// @ref parallel_for splits an index range into jobs: a worker halves its range until it is at most
+/// the grain size, keeps the left half and pushes the right half to the bottom of its own deque
+/// (Chase-Lev: the owner pushes and pops at the bottom without locking, other workers steal from
+/// the top with one compare-and-swap). Idle workers steal the largest pending halves and sleep on
+/// a semaphore when every deque is empty. Jobs live in a static @ref pool; when it or a deque is
+/// full, the range is simply not split further.
+/// Workers are static threads of one priority, so pools of different priorities run batches at
+/// different levels. On the host the workers run in parallel; on RTX they share the CPU with
+/// round-robin (OS_ROBIN_ENABLE) among themselves and other threads of the same priority.
+/// The threads and stacks belong to the template instance, so only one pool may be defined per
+/// set of template arguments.
+/// \tparam N            number of worker threads.
+/// \tparam _prio        worker priority.
+/// \tparam _stack_size  worker stack size in bytes.
+/// \tparam _jobs        job storage in jobs (also the capacity of each deque).
+template <uint32_t N, priority _prio = priority::normal, uint32_t _stack_size = OS_STACK_SIZE, uint32_t _jobs = 16U * N>
+class thread_pool
+{
+    static_assert(N >= 1U && N <= 32U, "Thread pool size must be in range 1..32.");
+    static_assert(_jobs >= N, "Thread pool needs at least one job per worker.");
+
+private:
+    /// Batch of a parallel_for call (on the stack of the caller).
+    struct batch_t
+    {
+        void                  (*call)(void *_ctx, uint32_t _begin, uint32_t _end);
+        void                   *ctx;
+        uint32_t                grain;
+        std::atomic<uint32_t>   left;       ///< Indices not processed yet
+        osThreadId_t            waiter;     ///< Thread to wake (null - a worker that helps)
+    };
+
+    struct job_t
+    {
+        batch_t  *batch;
+        uint32_t  begin;
+        uint32_t  end;
+    };
+
+    /// Chase-Lev deque of jobs with a fixed capacity.
+    /// Indices run freely and wrap at 2^32; they are compared by their signed distance.
+    class deque
+    {
+    private:
+        static constexpr uint32_t size_ = std::bit_ceil(_jobs);
+        static constexpr uint32_t mask_ = size_ - 1U;
+
+        std::atomic<uint32_t> top_;
+        std::atomic<uint32_t> bottom_;
+        std::atomic<job_t *> buf_[size_];
+
+    public:
+        constexpr deque(): top_(0U), bottom_(0U), buf_() {}
+
+        /// Owner only.
+        bool push(job_t *_job)
+        {
+            const uint32_t b = bottom_.load(std::memory_order_relaxed);
+            const uint32_t t = top_.load(std::memory_order_acquire);
+            if (b - t >= size_)
+            {
+                return false;
+            }
+            buf_[b & mask_].store(_job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1U, std::memory_order_relaxed);
+            return true;
+        }
+
+        /// Owner only.
+        job_t *pop(void)
+        {
+            const uint32_t b = bottom_.load(std::memory_order_relaxed) - 1U;
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint32_t t = top_.load(std::memory_order_relaxed);
+            if (static_cast<int32_t>(b - t) < 0)
+            {
+                bottom_.store(b + 1U, std::memory_order_relaxed);
+                return nullptr;
+            }
+            job_t *job = buf_[b & mask_].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // Last job: race against thieves for it
+                if (!top_.compare_exchange_strong(t, t + 1U, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    job = nullptr;
+                }
+                bottom_.store(b + 1U, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        /// Any worker.
+        job_t *steal(void)
+        {
+            uint32_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const uint32_t b = bottom_.load(std::memory_order_acquire);
+            if (static_cast<int32_t>(b - t) <= 0)
+            {
+                return nullptr;
+            }
+            job_t *job = buf_[t & mask_].load(std::memory_order_relaxed);
+            return top_.compare_exchange_strong(t, t + 1U, std::memory_order_seq_cst, std::memory_order_relaxed) ? job : nullptr;
+        }
+    };
+
+    template <uint32_t _idx>
+    class worker: public thread<worker<_idx>, _stack_size, _prio>
+    {
+    public:
+        thread_pool *pool_ = nullptr;
+
+        void run(void)
+        {
+            pool_->work(_idx);
+        }
+    };
+
+    template <class>
+    struct worker_set;
+
+    template <uint32_t... _idx>
+    struct worker_set<std::integer_sequence<uint32_t, _idx...>>
+    {
+        std::tuple<worker<_idx>...> threads;
+
+        sts_t start(thread_pool *_pool, const char *_name)
+        {
+            sts_t sts = sts_t::OK;
+            ((std::get<_idx>(threads).pool_ = _pool,
+              sts = (sts == sts_t::OK) ? std::get<_idx>(threads).start(_name) : sts), ...);
+            return sts;
+        }
+
+        int32_t index_of(const osThreadId_t _thread) const
+        {
+            int32_t idx = -1;
+            ((idx = (std::get<_idx>(threads).get_id() == _thread) ? static_cast<int32_t>(_idx) : idx), ...);
+            return idx;
+        }
+    };
+
+    worker_set<std::make_integer_sequence<uint32_t, N>> workers_;
+    deque                                               deques_[N];
+    pool<job_t, _jobs>                                  jobs_;
+    queue<job_t *, _jobs>                               injected_;
+    semaphore<N>                                        wake_;
+    std::atomic<uint32_t>                               sleepers_;
+
+    std::atomic<uint32_t> batches_;
+    std::atomic<uint32_t> chunks_;
+    std::atomic<uint32_t> splits_;
+    std::atomic<uint32_t> steals_;
+    std::atomic<uint32_t> inlined_;
+    std::atomic<uint32_t> wakeups_;
+
+    template <class F>
+    static void invoke(void *_ctx, const uint32_t _begin, const uint32_t _end)
+    {
+        (*static_cast<F *>(_ctx))(_begin, _end);
+    }
+
+    /// Wake a sleeping worker for new work.
+    void notify(void)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) != 0U)
+        {
+            wake_.release();
+        }
+    }
+
+    /// Find a job: own deque, then submitted batches, then the deques of the others.
+    job_t *find(const uint32_t _idx)
+    {
+        job_t *job = deques_[_idx].pop();
+        if (job != nullptr || injected_.get(job, 0U) == sts_t::OK)
+        {
+            return job;
+        }
+        for (uint32_t i = 1U; i < N; i++)
+        {
+            job = deques_[(_idx + i) % N].steal();
+            if (job != nullptr)
+            {
+                steals_.fetch_add(1U, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Account processed indices and wake the caller when the batch is done.
+    static void finish(batch_t &_batch, const uint32_t _count)
+    {
+        // The batch is gone as soon as the caller sees it done, so read the waiter first
+        const osThreadId_t waiter = _batch.waiter;
+        if (_batch.left.fetch_sub(_count, std::memory_order_acq_rel) == _count && waiter != nullptr)
+        {
+            osThreadFlagsSet(waiter, OS_THREAD_POOL_FLAG);
+        }
+    }
+
+    void execute(const uint32_t _idx, job_t *_job)
+    {
+        batch_t &batch = *_job->batch;
+        const uint32_t begin = _job->begin;
+        uint32_t end = _job->end;
+        jobs_.free(_job);
+
+        while (end - begin > batch.grain)
+        {
+            const uint32_t mid = begin + (end - begin) / 2U;
+            job_t *right = jobs_.alloc();
+            if (right == nullptr)
+            {
+                inlined_.fetch_add(1U, std::memory_order_relaxed);
+                break;
+            }
+            *right = {&batch, mid, end};
+            if (!deques_[_idx].push(right))
+            {
+                jobs_.free(right);
+                inlined_.fetch_add(1U, std::memory_order_relaxed);
+                break;
+            }
+            splits_.fetch_add(1U, std::memory_order_relaxed);
+            notify();
+            end = mid;
+        }
+
+        batch.call(batch.ctx, begin, end);
+        chunks_.fetch_add(1U, std::memory_order_relaxed);
+        finish(batch, end - begin);
+    }
+
+    /// Worker thread function.
+    void work(const uint32_t _idx)
+    {
+        for (;;)
+        {
+            job_t *job = find(_idx);
+            if (job == nullptr)
+            {
+                // Announce the sleep before the last look, so a push either is seen or wakes us
+                sleepers_.fetch_add(1U, std::memory_order_seq_cst);
+                job = find(_idx);
+                if (job == nullptr)
+                {
+                    wake_.acquire();
+                    wakeups_.fetch_add(1U, std::memory_order_relaxed);
+                }
+                sleepers_.fetch_sub(1U, std::memory_order_relaxed);
+            }
+            if (job != nullptr)
+            {
+                execute(_idx, job);
+            }
+        }
+    }
+
+public:
+    static constexpr uint32_t size = N;
+
+    /// Kernel resources of the workers (see @ref config::check).
+    static constexpr config::usage_t usage = {.threads = N, .stack = N * _stack_size, .isr_fifo = 0U};
+
+    constexpr thread_pool():
+        workers_(), deques_(), jobs_(), injected_(), wake_(), sleepers_(0U),
+        batches_(0U), chunks_(0U), splits_(0U), steals_(0U), inlined_(0U), wakeups_(0U)
+    {
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /// Create the pool objects and start the workers (the kernel must be initialized).
+    /// \param[in]     name          name of the workers (null for none).
+    /// \return status code that indicates the execution status of the function.
+    sts_t start(const char *_name = nullptr)
+    {
+        if (injected_.create(_name) != sts_t::OK || wake_.create(_name) != sts_t::OK)
+        {
+            return sts_t::err;
+        }
+        return workers_.start(this, _name);
+    }
+
+    /// Run `f(begin, end)` over subranges of [begin, end) on the workers and wait until all are done.
+    /// Subranges are at most grain indices long (unless the job storage runs out) and do not
+    /// overlap. Called by a thread (not from interrupts); a worker of this pool may call it too and
+    /// then helps with the jobs instead of blocking. The calling thread must not use the thread
+    /// flag OS_THREAD_POOL_FLAG for anything else.
+    /// \param[in]     begin         first index.
+    /// \param[in]     end           index after the last one.
+    /// \param[in]     grain         largest subrange (0 is treated as 1).
+    /// \param[in]     f             callable `void(uint32_t begin, uint32_t end)`.
+    /// \return status code that indicates the execution status of the function.
+    template <class F>
+    sts_t parallel_for(const uint32_t _begin, const uint32_t _end, const uint32_t _grain, F &&_f)
+    {
+        if (_begin >= _end)
+        {
+            return sts_t::OK;
+        }
+        using func_t = std::remove_reference_t<F>;
+
+        const int32_t self = workers_.index_of(osThreadGetId());
+        batch_t batch =
+        {
+            .call   = invoke<func_t>,
+            .ctx    = const_cast<void *>(static_cast<const void *>(&_f)),
+            .grain  = (_grain != 0U) ? _grain : 1U,
+            .left   = _end - _begin,
+            .waiter = (self < 0) ? osThreadGetId() : nullptr,
+        };
+        batches_.fetch_add(1U, std::memory_order_relaxed);
+
+        job_t *root = jobs_.alloc();
+        if (root == nullptr)
+        {
+            inlined_.fetch_add(1U, std::memory_order_relaxed);
+            _f(_begin, _end);
+            return sts_t::OK;
+        }
+        *root = {&batch, _begin, _end};
+
+        if (self >= 0)
+        {
+            execute(static_cast<uint32_t>(self), root);
+            while (batch.left.load(std::memory_order_acquire) != 0U)
+            {
+                job_t *job = find(static_cast<uint32_t>(self));
+                if (job != nullptr)
+                {
+                    execute(static_cast<uint32_t>(self), job);
+                }
+                else
+                {
+                    osThreadYield();
+                }
+            }
+            return sts_t::OK;
+        }
+
+        if (injected_.put(root, 0U) != sts_t::OK)
+        {
+            jobs_.free(root);
+            inlined_.fetch_add(1U, std::memory_order_relaxed);
+            _f(_begin, _end);
+            return sts_t::OK;
+        }
+        notify();
+        while (batch.left.load(std::memory_order_acquire) != 0U)
+        {
+            osThreadFlagsWait(OS_THREAD_POOL_FLAG, osFlagsWaitAny, forever);
+        }
+        return sts_t::OK;
+    }
+
+    /// Run `f(begin, end)` over subranges of [begin, end), about four per worker.
+    template <class F>
+    sts_t parallel_for(const uint32_t _begin, const uint32_t _end, F &&_f)
+    {
+        const uint32_t grain = (_end > _begin) ? (_end - _begin + 4U * N - 1U) / (4U * N) : 1U;
+        return parallel_for(_begin, _end, grain, std::forward<F>(_f));
+    }
+
+    /// Get the statistics.
+    thread_pool_stats_t get_stats(void) const
+    {
+        return
+        {
+            .batches = batches_.load(std::memory_order_relaxed),
+            .chunks  = chunks_.load(std::memory_order_relaxed),
+            .splits  = splits_.load(std::memory_order_relaxed),
+            .steals  = steals_.load(std::memory_order_relaxed),
+            .inlined = inlined_.load(std::memory_order_relaxed),
+            .wakeups = wakeups_.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+} // namespace os
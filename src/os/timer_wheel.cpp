@@ -0,0 +1,341 @@
+#include <bit>
+
+#include "rtx_os.h"
+
+#include "thread.h"
+#include "mutex.h"
+#include "timer_wheel.h"
+
+namespace os
+{
+
+static_assert(timer_wheel::bits * (timer_wheel::levels - 1U) < 32U, "Timer wheel levels exceed the 32-bit tick range.");
+
+void timer_wheel::insert(wheel_timer_t &_timer)
+{
+    uint32_t delta = _timer.expiry - now_;
+    if (delta > range)
+    {
+        delta = range;
+    }
+    const uint32_t expiry = now_ + delta;
+
+    uint32_t level = 0U;
+    while (level + 1U < levels && (delta >> (bits * (level + 1U))) != 0U)
+    {
+        level++;
+    }
+    const uint32_t slot = (expiry >> (bits * level)) & mask;
+
+    wheel_timer_t **head = &slot_[level][slot];
+    _timer.next = *head;
+    if (*head != nullptr)
+    {
+        (*head)->pprev = &_timer.next;
+    }
+    *head = &_timer;
+    _timer.pprev = head;
+    _timer.level = static_cast<uint8_t>(level);
+    _timer.slot = static_cast<uint8_t>(slot);
+    used_[level] |= 1ULL << slot;
+}
+
+void timer_wheel::unlink(wheel_timer_t &_timer)
+{
+    *_timer.pprev = _timer.next;
+    if (_timer.next != nullptr)
+    {
+        _timer.next->pprev = _timer.pprev;
+    }
+    if (_timer.level < levels)
+    {
+        if (slot_[_timer.level][_timer.slot] == nullptr)
+        {
+            used_[_timer.level] &= ~(1ULL << _timer.slot);
+        }
+    }
+    else if (due_tail_ == &_timer.next)
+    {
+        due_tail_ = _timer.pprev;
+    }
+    _timer.next = nullptr;
+    _timer.pprev = nullptr;
+}
+
+/// Re-insert the timers of the current slot of a level, they move to lower levels.
+void timer_wheel::cascade(const uint32_t _level)
+{
+    const uint32_t slot = (now_ >> (bits * _level)) & mask;
+    wheel_timer_t *timer = slot_[_level][slot];
+    slot_[_level][slot] = nullptr;
+    used_[_level] &= ~(1ULL << slot);
+
+    while (timer != nullptr)
+    {
+        wheel_timer_t *next = timer->next;
+        insert(*timer);
+        timer = next;
+    }
+}
+
+void timer_wheel::reset(const uint32_t _now)
+{
+    now_ = _now;
+}
+
+void timer_wheel::start(wheel_timer_t &_timer, const uint32_t _expiry, const uint32_t _period)
+{
+    if (_timer.running())
+    {
+        unlink(_timer);
+    }
+    _timer.period = _period;
+    _timer.expiry = (static_cast<int32_t>(_expiry - now_) > 0) ? _expiry : now_ + 1U;
+    insert(_timer);
+}
+
+bool timer_wheel::stop(wheel_timer_t &_timer)
+{
+    if (!_timer.running())
+    {
+        return false;
+    }
+    unlink(_timer);
+    return true;
+}
+
+void timer_wheel::advance(const uint32_t _now)
+{
+    while (now_ != _now)
+    {
+        // Nothing is due before the next wrap of level 0
+        if (used_[0] == 0U)
+        {
+            const uint32_t wrap = (now_ | mask) + 1U;
+            if (_now - now_ < wrap - now_)
+            {
+                now_ = _now;
+                break;
+            }
+            now_ = wrap - 1U;
+        }
+        now_++;
+
+        if ((now_ & mask) == 0U)
+        {
+            uint32_t top = 1U;
+            while (top + 1U < levels && ((now_ >> (bits * top)) & mask) == 0U)
+            {
+                top++;
+            }
+            for (uint32_t level = top; level >= 1U && level < levels; level--)
+            {
+                cascade(level);
+            }
+        }
+
+        const uint32_t slot = now_ & mask;
+        wheel_timer_t *timer = slot_[0][slot];
+        slot_[0][slot] = nullptr;
+        used_[0] &= ~(1ULL << slot);
+        while (timer != nullptr)
+        {
+            wheel_timer_t *next = timer->next;
+            timer->next = nullptr;
+            timer->pprev = due_tail_;
+            timer->level = static_cast<uint8_t>(levels);
+            *due_tail_ = timer;
+            due_tail_ = &timer->next;
+            timer = next;
+        }
+    }
+}
+
+wheel_timer_t *timer_wheel::pop(void)
+{
+    wheel_timer_t *timer = due_;
+    if (timer == nullptr)
+    {
+        return nullptr;
+    }
+    unlink(*timer);
+    if (timer->period != 0U)
+    {
+        start(*timer, timer->expiry + timer->period, timer->period);
+    }
+    return timer;
+}
+
+uint32_t timer_wheel::next(void) const
+{
+    if (due_ != nullptr)
+    {
+        return 0U;
+    }
+
+    uint32_t best = forever;
+    for (uint32_t level = 0U; level < levels; level++)
+    {
+        if (used_[level] == 0U)
+        {
+            continue;
+        }
+        // First used slot after the current one (the current slot itself is one full turn away)
+        const uint32_t shift = bits * level;
+        const uint32_t from = (((now_ >> shift) & mask) + 1U) & mask;
+        uint64_t rot = used_[level];
+        if (from != 0U)
+        {
+            rot = (rot >> from) | (rot << (slots - from));
+        }
+        const uint32_t turns = static_cast<uint32_t>(std::countr_zero(rot)) + 1U;
+        const uint32_t ticks = (((now_ >> shift) + turns) << shift) - now_;
+        if (ticks < best)
+        {
+            best = ticks;
+        }
+    }
+    return best;
+}
+
+namespace timers
+{
+
+/// Thread flag that wakes the service.
+static constexpr uint32_t flag_wake = 1U;
+
+/// Protected by the mutex.
+static timer_wheel wheel;
+static uint32_t wake_at;
+static bool wait_forever = true;
+static stats_t stats;
+
+static mutex<> mtx __attribute__((section(".bss.os.mutex.cb")));
+
+class service: public thread<service, OS_TIMER_WHEEL_STACK_SIZE, priority::high>
+{
+public:
+    void run(void)
+    {
+        mtx.acquire();
+        for (;;)
+        {
+            wheel.advance(kernel::get_tick_count());
+
+            wheel_timer_t *timer = wheel.pop();
+            if (timer != nullptr)
+            {
+                const timer_func_t func = timer->func;
+                void *arg = timer->arg;
+                stats.expired++;
+                mtx.release();
+                func(arg);
+                mtx.acquire();
+                continue;
+            }
+
+            const uint32_t wait = wheel.next();
+            wait_forever = (wait == forever);
+            wake_at = wheel.get_now() + wait;
+            mtx.release();
+
+            osThreadFlagsWait(flag_wake, osFlagsWaitAny, wait);
+
+            mtx.acquire();
+            stats.wakeups++;
+        }
+    }
+};
+
+static_assert(config::usage_of<service>() == usage, "os::timers::usage does not match the service thread.");
+
+static service service_thread;
+
+sts_t start(void)
+{
+    if (service_thread.get_id() != nullptr)
+    {
+        return sts_t::OK;
+    }
+    if (mtx.create("timers") != sts_t::OK)
+    {
+        return sts_t::err;
+    }
+    wheel.reset(kernel::get_tick_count());
+    return service_thread.start("timers");
+}
+
+sts_t start(wheel_timer_t &_timer, const uint32_t _ticks, const uint32_t _period)
+{
+    if (_ticks == 0U || _timer.func == nullptr)
+    {
+        return sts_t::err_parameter;
+    }
+    const sts_t sts = mtx.acquire();
+    if (sts != sts_t::OK)
+    {
+        return sts;
+    }
+
+    const uint32_t expiry = kernel::get_tick_count() + _ticks;
+    wheel.start(_timer, expiry, _period);
+    stats.started++;
+    const bool wake = wait_forever || static_cast<int32_t>(expiry - wake_at) < 0;
+    if (wake)
+    {
+        // The service recalculates its timeout
+        wait_forever = false;
+        wake_at = expiry;
+    }
+
+    mtx.release();
+
+    if (wake)
+    {
+        osThreadFlagsSet(service_thread.get_id(), flag_wake);
+    }
+    return sts_t::OK;
+}
+
+sts_t stop(wheel_timer_t &_timer)
+{
+    const sts_t sts = mtx.acquire();
+    if (sts != sts_t::OK)
+    {
+        return sts;
+    }
+    const bool stopped = wheel.stop(_timer);
+    if (stopped)
+    {
+        stats.stopped++;
+    }
+    mtx.release();
+
+    return stopped ? sts_t::OK : sts_t::err_resource;
+}
+
+bool is_running(const wheel_timer_t &_timer)
+{
+    if (mtx.acquire() != sts_t::OK)
+    {
+        return false;
+    }
+    const bool running = _timer.running();
+    mtx.release();
+    return running;
+}
+
+stats_t get_stats(void)
+{
+    if (mtx.acquire() != sts_t::OK)
+    {
+        return stats_t{};
+    }
+    const stats_t result = stats;
+    mtx.release();
+    return result;
+}
+
+} // namespace timers
+
+} // namespace os
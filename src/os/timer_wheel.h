@@ -0,0 +1,178 @@
+#pragma once
+
+#include "os.h"
+#include "chrono.h"
+#include "config.h"
+
+#ifndef OS_TIMER_WHEEL_BITS
+    #define OS_TIMER_WHEEL_BITS 6           ///< Slots per level as a power of two (at most 6)
+#endif
+
+#ifndef OS_TIMER_WHEEL_LEVELS
+    #define OS_TIMER_WHEEL_LEVELS 4         ///< Number of levels (range 2^(BITS*LEVELS) ticks)
+#endif
+
+#ifndef OS_TIMER_WHEEL_STACK_SIZE
+    #define OS_TIMER_WHEEL_STACK_SIZE 512   ///< Stack size of the timer service thread in bytes
+#endif
+
+/// Software timers on a hierarchical timer wheel.
+/// A timer is an intrusive node in user storage, so the number of timers is not bounded by RTX
+/// timer objects, and start/stop are O(1) list operations. Level 0 holds timers due within
+/// 2^BITS ticks, each further level covers 2^BITS times the range of the previous one; timers
+/// move down a level (cascade) when the level below wraps. One service thread advances the wheel
+/// and runs the callbacks. It sleeps until the next due slot, so the tick can stay suspended in
+/// tickless idle.
+namespace os
+{
+
+/// Timer callback.
+using timer_func_t = void (*)(void *_arg);
+
+/// Timer of a @ref timer_wheel.
+struct wheel_timer_t
+{
+    wheel_timer_t  *next;       ///< Next timer in the slot (or in the due list).
+    wheel_timer_t **pprev;      ///< Link pointing to this timer (null - not running).
+    uint32_t        expiry;     ///< Absolute expiry tick.
+    uint32_t        period;     ///< Reload period in ticks (0 - one-shot).
+    timer_func_t    func;       ///< Callback.
+    void           *arg;        ///< Callback argument.
+    uint8_t         level;      ///< Wheel level (levels - due list).
+    uint8_t         slot;       ///< Slot within the level.
+
+    constexpr wheel_timer_t(const timer_func_t _func, void *_arg = nullptr):
+        next(nullptr), pprev(nullptr), expiry(0U), period(0U), func(_func), arg(_arg), level(0U), slot(0U)
+    {
+    }
+
+    wheel_timer_t(const wheel_timer_t &) = delete;
+    wheel_timer_t &operator=(const wheel_timer_t &) = delete;
+
+    /// \return true if the timer is started (or due and not yet called back).
+    bool running(void) const
+    {
+        return pprev != nullptr;
+    }
+};
+
+/// Hierarchical timer wheel (kernel independent and not thread safe, so it can be tested on a host).
+class timer_wheel
+{
+public:
+    static constexpr uint32_t bits = OS_TIMER_WHEEL_BITS;
+    static constexpr uint32_t levels = OS_TIMER_WHEEL_LEVELS;
+    static constexpr uint32_t slots = 1U << bits;
+    static constexpr uint32_t mask = slots - 1U;
+    static constexpr uint32_t range = (bits * levels < 32U) ? (1U << (bits * levels)) - 1U : 0xFFFFFFFFU;
+
+    static_assert(bits >= 1U && bits <= 6U, "Timer wheel slots must fit a 64-bit occupancy mask.");
+    static_assert(levels >= 1U && levels <= 255U, "Illegal number of timer wheel levels.");
+
+private:
+    wheel_timer_t *slot_[levels][slots];
+    uint64_t       used_[levels];
+    wheel_timer_t *due_;
+    wheel_timer_t **due_tail_;
+    uint32_t       now_;
+
+    void insert(wheel_timer_t &_timer);
+    void unlink(wheel_timer_t &_timer);
+    void cascade(const uint32_t _level);
+
+public:
+    constexpr timer_wheel(): slot_(), used_(), due_(nullptr), due_tail_(&due_), now_(0U) {}
+
+    timer_wheel(const timer_wheel &) = delete;
+    timer_wheel &operator=(const timer_wheel &) = delete;
+
+    /// Set the current tick of an empty wheel.
+    void reset(const uint32_t _now);
+
+    /// \return current tick of the wheel.
+    uint32_t get_now(void) const
+    {
+        return now_;
+    }
+
+    /// Start (or restart) a timer.
+    /// \param[in]     timer         timer.
+    /// \param[in]     expiry        absolute expiry tick (after the current tick).
+    /// \param[in]     period        reload period in ticks (0 - one-shot).
+    void start(wheel_timer_t &_timer, const uint32_t _expiry, const uint32_t _period = 0U);
+
+    /// Stop a timer.
+    /// \return false if the timer was not running.
+    bool stop(wheel_timer_t &_timer);
+
+    /// Advance the current tick and move the timers that expire on the way to the due list.
+    /// \param[in]     now           new current tick.
+    void advance(const uint32_t _now);
+
+    /// Take the first due timer. A periodic timer is started again for its next period.
+    /// \return timer or nullptr if none is due.
+    wheel_timer_t *pop(void);
+
+    /// \return ticks from the current tick to the next due slot or cascade (0 - timers are due,
+    /// @ref forever - the wheel is empty). The timers of that slot may still be later.
+    uint32_t next(void) const;
+};
+
+/// Timer service: a global @ref timer_wheel driven by a thread of @ref priority::high.
+/// Start and stop take the service mutex, so they may be called from threads and timer callbacks
+/// but not from interrupts, where they fail with @ref sts_t::err_ISR; defer to os::isr instead.
+namespace timers
+{
+
+/// Kernel resources of the timer service (see @ref config::check).
+constexpr config::usage_t usage = {.threads = 1U, .stack = OS_TIMER_WHEEL_STACK_SIZE, .isr_fifo = 0U};
+
+/// Timer service statistics.
+struct stats_t
+{
+    uint32_t started;       ///< Timer starts.
+    uint32_t stopped;       ///< Timer stops of running timers.
+    uint32_t expired;       ///< Callbacks.
+    uint32_t wakeups;       ///< Service thread wake-ups.
+};
+
+/// Start the service thread (the kernel must be initialized); nothing to do if it is running.
+/// \return status code that indicates the execution status of the function.
+sts_t start(void);
+
+/// Start (or restart) a timer.
+/// \param[in]     timer         timer.
+/// \param[in]     ticks         time to the first expiry in ticks (at least 1).
+/// \param[in]     period        reload period in ticks (0 - one-shot).
+/// \return status code that indicates the execution status of the function
+/// (@ref sts_t::err_ISR - called from an interrupt).
+sts_t start(wheel_timer_t &_timer, const uint32_t _ticks, const uint32_t _period = 0U);
+
+/// Start (or restart) a timer.
+/// \param[in]     timer         timer.
+/// \param[in]     time          time to the first expiry, rounded up to whole ticks.
+/// \param[in]     period        reload period (0 - one-shot).
+/// \return status code that indicates the execution status of the function.
+template <class _rep, class _period, class _rep2 = _rep, class _period2 = _period>
+inline sts_t start(wheel_timer_t &_timer, const std::chrono::duration<_rep, _period> &_time,
+                   const std::chrono::duration<_rep2, _period2> &_reload = std::chrono::duration<_rep2, _period2>::zero())
+{
+    return start(_timer, to_ticks(_time).count(), to_ticks(_reload).count());
+}
+
+/// Stop a timer. The callback is not called after the return, unless it is already running.
+/// \return status code that indicates the execution status of the function
+/// (@ref sts_t::err_resource - the timer was not running, @ref sts_t::err_ISR - called from an interrupt).
+sts_t stop(wheel_timer_t &_timer);
+
+/// Not interrupt safe.
+/// \return true if the timer is running, false also if called from an interrupt.
+bool is_running(const wheel_timer_t &_timer);
+
+/// Get timer service statistics. Not interrupt safe.
+/// \return statistics, all zero if called from an interrupt.
+stats_t get_stats(void);
+
+} // namespace timers
+
+} // namespace os
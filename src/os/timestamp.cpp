@@ -0,0 +1,41 @@
+#include "RTE_Components.h"
+#include CMSIS_device_header
+
+#include <atomic>
+
+#include "timestamp.h"
+
+namespace os::timestamp
+{
+
+/// Wrap extension state (see @ref advance).
+static std::atomic<uint32_t> state;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+void init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint64_t now(void)
+{
+    return extend(state, [] { return DWT->CYCCNT; });
+}
+
+uint32_t get_freq(void)
+{
+    return SystemCoreClock;
+}
+
+} // namespace os::timestamp
+
+/// OS Tick IRQ acknowledge (replaces the weak one of os_systick.c): keeps the extension state
+/// at most one tick old.
+extern "C" void OS_Tick_AcknowledgeIRQ(void);
+void OS_Tick_AcknowledgeIRQ(void)
+{
+    (void)SysTick->CTRL;
+    (void)os::timestamp::now();
+}
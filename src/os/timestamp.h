@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/// Monotonic 64-bit timestamps with sub-microsecond resolution.
+/// On the target the time base is the DWT cycle counter (core clock). Its 32-bit count is
+/// extended to 64 bits by a single atomic word that every read updates with one LDREX/STREX, so
+/// @ref now is lock-free and may be called from threads and interrupts of any priority. The
+/// extension needs a read at least once per half wrap (21 s at 100 MHz); the kernel tick does
+/// that (OS_Tick_AcknowledgeIRQ). The core clock stops in sleep: the idle thread adds the cycles
+/// slept from SysTick, in tickless sleep as well as when it waits for the next interrupt with the
+/// tick running. Sleeping elsewhere (WFI/WFE outside the idle thread) is not compensated. The host
+/// backend reads its 64-bit system timer.
+namespace os::timestamp
+{
+
+/// Advance the wrap extension state with a new 32-bit count.
+/// The state holds the wrap count (bits 31..1) and the MSB of the last count (bit 0); a count
+/// whose MSB falls from 1 to 0 has wrapped.
+/// \param[in]     state         current state.
+/// \param[in]     count         32-bit count read after the state.
+/// \return new state.
+constexpr uint32_t advance(const uint32_t _state, const uint32_t _count)
+{
+    const uint32_t msb = _count >> 31;
+    if (msb == (_state & 1U))
+    {
+        return _state;
+    }
+    const uint32_t wraps = (_state >> 1) + (_state & 1U);
+    return (wraps << 1) | msb;
+}
+
+/// \return 64-bit count of a state returned by @ref advance and the count passed to it.
+constexpr uint64_t value(const uint32_t _state, const uint32_t _count)
+{
+    return (static_cast<uint64_t>(_state >> 1) << 32) | _count;
+}
+
+/// Convert a count to nanoseconds (no intermediate overflow while the result fits in 64 bits).
+/// \param[in]     count         timestamp or difference of timestamps.
+/// \param[in]     freq          counts per second (@ref get_freq).
+/// \return nanoseconds.
+constexpr uint64_t to_ns(const uint64_t _count, const uint32_t _freq)
+{
+    return (_count / _freq) * 1000000000U + (_count % _freq) * 1000000000U / _freq;
+}
+
+/// Extend a 32-bit count with a shared state (the lock-free update of @ref now).
+/// A reader that is preempted between the state and the count reads an old state, which is valid
+/// as long as the count is less than half a wrap newer; if a preempting reader has stored a newer
+/// state meanwhile, the compare-exchange fails and the result is still computed from the own pair.
+/// \param[in,out] state         wrap extension state shared by all readers.
+/// \param[in]     read          reads the 32-bit count (called after the state is loaded).
+/// \return 64-bit count.
+template <class _reader>
+inline uint64_t extend(std::atomic<uint32_t> &_state, _reader &&_read)
+{
+    // The state must be read before the count: a newer state with an older count is not valid
+    uint32_t s = _state.load(std::memory_order_acquire);
+    const uint32_t count = _read();
+    const uint32_t next = advance(s, count);
+    if (next != s)
+    {
+        // A failure means that a preempting reader has stored the same or a newer state
+        _state.compare_exchange_strong(s, next, std::memory_order_release, std::memory_order_relaxed);
+    }
+    return value(next, count);
+}
+
+/// Walk a sequence of counts (each less than half a wrap after the previous one).
+/// \return true if the extended values strictly increase.
+template <uint32_t _n>
+constexpr bool increasing(const uint32_t (&_counts)[_n])
+{
+    uint32_t state = 0U;
+    uint64_t last = 0U;
+    for (uint32_t i = 0U; i < _n; i++)
+    {
+        state = advance(state, _counts[i]);
+        const uint64_t v = value(state, _counts[i]);
+        if (i != 0U && v <= last)
+        {
+            return false;
+        }
+        last = v;
+    }
+    return true;
+}
+
+static_assert(value(advance(0U, 0x7FFFFFFFU), 0x7FFFFFFFU) == 0x7FFFFFFFU);
+static_assert(value(advance(advance(0U, 0x80000000U), 0x00000001U), 0x00000001U) == 0x100000001U);
+static_assert(value(advance(advance(0U, 0xFFFFFFFFU), 0xFFFFFFFFU), 0xFFFFFFFFU) == 0xFFFFFFFFU);
+static_assert(increasing({0x00000000U, 0x7FFFFFFFU, 0x80000000U, 0xFFFFFFFFU, 0x00000000U, 0x40000000U,
+                          0xB0000000U, 0x20000000U, 0x90000000U, 0x0FFFFFFFU, 0x7FFFFFFFU, 0x80000001U}));
+static_assert(value(advance(advance(advance(advance(0U, 0x80000000U), 0x00000000U), 0x80000000U), 0x00000000U),
+                    0x00000000U) == 0x200000000U);
+static_assert(to_ns(100000000U, 100000000U) == 1000000000U);
+static_assert(to_ns(1ULL << 40, 100000000U) == 10995116277760ULL);
+static_assert(to_ns(3U, 96000000U) == 31U);
+
+/// Enable the time base (call once at startup, before the kernel starts).
+void init(void);
+
+/// \return current timestamp in counts of @ref get_freq (lock-free, callable from interrupts).
+uint64_t now(void);
+
+/// \return timestamp frequency in hertz.
+uint32_t get_freq(void);
+
+} // namespace os::timestamp
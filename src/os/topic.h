@@ -0,0 +1,422 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "os.h"
+#include "chrono.h"
+#include "queue.h"
+#include "pool.h"
+
+namespace os
+{
+
+/// What a subscriber does with a new message when its queue is full.
+enum class overflow : uint8_t
+{
+    drop_oldest,    ///< Discard the oldest queued message (latest data wins).
+    drop_newest,    ///< Discard the new message.
+    block,          ///< The publisher waits for space (up to its timeout, then the message is dropped).
+};
+
+/// Topic statistics.
+struct topic_stats_t
+{
+    uint32_t published;     ///< Messages published.
+    uint32_t exhausted;     ///< Loans that failed because every slot was in use.
+    uint32_t delivered;     ///< Messages queued to subscribers.
+};
+
+/// Subscriber statistics.
+struct subscriber_stats_t
+{
+    uint32_t received;      ///< Messages queued to the subscriber.
+    uint32_t dropped;       ///< Messages lost by the overflow policy.
+};
+
+/// Publish/subscribe topic with zero-copy fan-out.
+/// A message is written once into a slot of a static @ref pool and every subscriber queues a
+/// pointer to it, so delivering to N subscribers costs one copy and N pointer puts. The slot
+/// carries a reference count: the message is destroyed and the slot freed when the last
+/// subscriber drops its @ref handle. Each subscriber chooses an @ref overflow policy when it
+/// subscribes. Publishing with timeout 0 is callable from interrupts (a blocking subscriber then
+/// drops like @ref overflow::drop_newest).
+/// `static os::topic<frame_t, 8> frames; static decltype(frames)::subscriber sub;`
+/// `frames.subscribe(sub, os::overflow::drop_oldest); ... auto msg = sub.receive(); use(*msg);`
+/// \tparam T            message type.
+/// \tparam _slots       number of message slots (messages alive at the same time).
+/// \tparam _subs        maximum number of subscribers.
+/// \tparam _depth       queue depth of each subscriber in messages.
+template <class T, uint32_t _slots, uint32_t _subs = 8U, uint32_t _depth = 4U>
+class topic
+{
+private:
+    struct slot_t
+    {
+        alignas(T) uint8_t     data[sizeof(T)];     ///< Message (first, so a message pointer is the slot)
+        std::atomic<uint32_t>  refs;
+    };
+
+    static slot_t *slot_of(T *_msg)
+    {
+        return reinterpret_cast<slot_t *>(_msg);
+    }
+
+    static T *msg_of(slot_t *_slot)
+    {
+        return std::launder(reinterpret_cast<T *>(_slot->data));
+    }
+
+public:
+    class subscriber;
+
+    /// Received message. Move-only; drops its reference to the slot when destroyed.
+    class handle
+    {
+    private:
+        topic  *topic_;
+        slot_t *slot_;
+
+    public:
+        constexpr handle(): topic_(nullptr), slot_(nullptr) {}
+        constexpr handle(topic &_topic, slot_t *_slot): topic_(&_topic), slot_(_slot) {}
+
+        handle(handle &&_other): topic_(_other.topic_), slot_(std::exchange(_other.slot_, nullptr)) {}
+
+        handle &operator=(handle &&_other)
+        {
+            if (this != &_other)
+            {
+                reset();
+                topic_ = _other.topic_;
+                slot_ = std::exchange(_other.slot_, nullptr);
+            }
+            return *this;
+        }
+
+        handle(const handle &) = delete;
+        handle &operator=(const handle &) = delete;
+
+        ~handle()
+        {
+            reset();
+        }
+
+        /// Drop the reference now.
+        void reset(void)
+        {
+            if (slot_ != nullptr)
+            {
+                topic_->release(std::exchange(slot_, nullptr));
+            }
+        }
+
+        /// \return message or nullptr.
+        const T *get(void) const
+        {
+            return (slot_ != nullptr) ? msg_of(slot_) : nullptr;
+        }
+
+        const T *operator->(void) const
+        {
+            return msg_of(slot_);
+        }
+
+        const T &operator*(void) const
+        {
+            return *msg_of(slot_);
+        }
+
+        /// \return true if a message was received.
+        explicit operator bool(void) const
+        {
+            return slot_ != nullptr;
+        }
+    };
+
+    /// Subscriber: a queue of message references. Define it at namespace scope like a queue and
+    /// receive from one thread.
+    class subscriber
+    {
+    private:
+        friend class topic;
+
+        queue<slot_t *, _depth> queue_;
+        topic                  *topic_;
+        overflow                policy_;
+        bool                    created_;
+
+        std::atomic<uint32_t> busy_;        ///< Publishers delivering to the subscriber
+        std::atomic<uint32_t> received_;
+        std::atomic<uint32_t> dropped_;
+
+        /// Release every queued message.
+        void flush(void)
+        {
+            slot_t *slot;
+            while (queue_.get(slot, 0U) == sts_t::OK)
+            {
+                topic_->release(slot);
+            }
+        }
+
+        /// Queue a reference according to the policy (publisher side).
+        /// \return true if the reference was queued.
+        bool deliver(slot_t *_slot, const uint32_t _timeout)
+        {
+            bool queued;
+            if (policy_ == overflow::block)
+            {
+                queued = queue_.put(_slot, _timeout) == sts_t::OK;
+            }
+            else
+            {
+                queued = queue_.put(_slot, 0U) == sts_t::OK;
+                while (!queued && policy_ == overflow::drop_oldest)
+                {
+                    slot_t *oldest;
+                    if (queue_.get(oldest, 0U) == sts_t::OK)
+                    {
+                        topic_->release(oldest);
+                        dropped_.fetch_add(1U, std::memory_order_relaxed);
+                    }
+                    queued = queue_.put(_slot, 0U) == sts_t::OK;
+                }
+            }
+
+            if (queued)
+            {
+                received_.fetch_add(1U, std::memory_order_relaxed);
+            }
+            else
+            {
+                dropped_.fetch_add(1U, std::memory_order_relaxed);
+            }
+            return queued;
+        }
+
+    public:
+        constexpr subscriber():
+            queue_(), topic_(nullptr), policy_(overflow::drop_oldest), created_(false), busy_(0U), received_(0U), dropped_(0U)
+        {
+        }
+
+        subscriber(const subscriber &) = delete;
+        subscriber &operator=(const subscriber &) = delete;
+
+        /// Receive a message or timeout if none is published.
+        /// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+        /// \return handle of the message (empty on timeout).
+        handle receive(const uint32_t _timeout = forever)
+        {
+            slot_t *slot;
+            if (queue_.get(slot, _timeout) != sts_t::OK)
+            {
+                return handle();
+            }
+            return handle(*topic_, slot);
+        }
+
+        /// Receive a message or timeout if none is published.
+        /// \param[in]     timeout       timeout duration, rounded up to whole ticks.
+        /// \return handle of the message (empty on timeout).
+        template <class _rep, class _period>
+        handle receive(const std::chrono::duration<_rep, _period> &_timeout)
+        {
+            return receive(to_ticks(_timeout).count());
+        }
+
+        /// \return number of queued messages.
+        uint32_t get_count(void)
+        {
+            return queue_.get_count();
+        }
+
+        /// Get the statistics.
+        subscriber_stats_t get_stats(void) const
+        {
+            return
+            {
+                .received = received_.load(std::memory_order_relaxed),
+                .dropped  = dropped_.load(std::memory_order_relaxed),
+            };
+        }
+    };
+
+private:
+    pool<slot_t, _slots>        slots_;
+    std::atomic<subscriber *>   subs_[_subs];
+
+    std::atomic<uint32_t> published_;
+    std::atomic<uint32_t> exhausted_;
+    std::atomic<uint32_t> delivered_;
+
+    void release(slot_t *_slot)
+    {
+        if (_slot->refs.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+        {
+            msg_of(_slot)->~T();
+            slots_.free(_slot);
+        }
+    }
+
+public:
+    static constexpr uint32_t capacity = _slots;
+
+    constexpr topic(): slots_(), subs_(), published_(0U), exhausted_(0U), delivered_(0U) {}
+
+    topic(const topic &) = delete;
+    topic &operator=(const topic &) = delete;
+
+    /// Add a subscriber; it receives the messages published from now on.
+    /// Creates the queue of the subscriber on first use (the kernel must be initialized).
+    /// \param[in]     sub           subscriber.
+    /// \param[in]     policy        what to do when the queue of the subscriber is full.
+    /// \param[in]     name          name of the subscriber queue (null for none).
+    /// \return status code (@ref sts_t::err_resource - no free subscriber entry).
+    sts_t subscribe(subscriber &_sub, const overflow _policy = overflow::drop_oldest, const char *_name = nullptr)
+    {
+        if (!_sub.created_)
+        {
+            if (_sub.queue_.create(_name) != sts_t::OK)
+            {
+                return sts_t::err;
+            }
+            _sub.created_ = true;
+        }
+        _sub.topic_ = this;
+        _sub.policy_ = _policy;
+
+        for (std::atomic<subscriber *> &entry: subs_)
+        {
+            subscriber *empty = nullptr;
+            if (entry.compare_exchange_strong(empty, &_sub))
+            {
+                return sts_t::OK;
+            }
+        }
+        return sts_t::err_resource;
+    }
+
+    /// Remove a subscriber and release its queued messages (not from interrupts). Publishers
+    /// still delivering to it are waited for, so nothing is queued after the return; the queue is
+    /// drained meanwhile, so a publisher blocked on it by @ref overflow::block gets through.
+    /// Publishers delivering to other subscribers, even through the same entry, are not waited for.
+    /// \param[in]     sub           subscriber.
+    /// \return status code (@ref sts_t::err_parameter - not subscribed).
+    sts_t unsubscribe(subscriber &_sub)
+    {
+        for (uint32_t i = 0U; i < _subs; i++)
+        {
+            subscriber *expected = &_sub;
+            if (subs_[i].compare_exchange_strong(expected, nullptr))
+            {
+                _sub.flush();
+                while (_sub.busy_.load() != 0U)
+                {
+                    delay(1U);
+                    _sub.flush();
+                }
+                return sts_t::OK;
+            }
+        }
+        return sts_t::err_parameter;
+    }
+
+    /// Take a free slot and construct a message in it (lock-free, callable from interrupts).
+    /// \param[in]     args          constructor arguments of the message.
+    /// \return message to fill and pass to @ref publish (or @ref discard), nullptr if every slot is in use.
+    template <class... _args>
+    T *loan(_args &&..._arg)
+    {
+        slot_t *slot = slots_.alloc();
+        if (slot == nullptr)
+        {
+            exhausted_.fetch_add(1U, std::memory_order_relaxed);
+            return nullptr;
+        }
+        new (&slot->refs) std::atomic<uint32_t>(1U);
+        return new (slot->data) T(std::forward<_args>(_arg)...);
+    }
+
+    /// Return a loaned message without publishing it.
+    /// \param[in]     msg           message taken by @ref loan.
+    void discard(T *_msg)
+    {
+        release(slot_of(_msg));
+    }
+
+    /// Publish a loaned message to every subscriber; the loan ends with the call.
+    /// \param[in]     msg           message taken by @ref loan.
+    /// \param[in]     timeout       wait for subscribers of @ref overflow::block (\ref CMSIS_RTOS_TimeOutValue or 0).
+    /// \return number of subscribers that got the message.
+    uint32_t publish(T *_msg, const uint32_t _timeout = forever)
+    {
+        slot_t *slot = slot_of(_msg);
+        uint32_t count = 0U;
+        for (uint32_t i = 0U; i < _subs; i++)
+        {
+            subscriber *sub = subs_[i].load();
+            if (sub == nullptr)
+            {
+                continue;
+            }
+            // Marked busy before the entry is read again: unsubscribe either sees the mark or
+            // this publisher sees the entry changed (subscribers are static, so the mark of one
+            // just removed is harmless)
+            sub->busy_.fetch_add(1U);
+            if (subs_[i].load() == sub)
+            {
+                // Referenced before queueing, the subscriber may release it at once
+                slot->refs.fetch_add(1U, std::memory_order_relaxed);
+                if (sub->deliver(slot, _timeout))
+                {
+                    count++;
+                }
+                else
+                {
+                    release(slot);
+                }
+            }
+            sub->busy_.fetch_sub(1U, std::memory_order_release);
+        }
+        published_.fetch_add(1U, std::memory_order_relaxed);
+        delivered_.fetch_add(count, std::memory_order_relaxed);
+        release(slot);
+        return count;
+    }
+
+    /// Publish a loaned message to every subscriber; the loan ends with the call.
+    /// \param[in]     msg           message taken by @ref loan.
+    /// \param[in]     timeout       wait for subscribers of @ref overflow::block, rounded up to whole ticks.
+    /// \return number of subscribers that got the message.
+    template <class _rep, class _period>
+    uint32_t publish(T *_msg, const std::chrono::duration<_rep, _period> &_timeout)
+    {
+        return publish(_msg, to_ticks(_timeout).count());
+    }
+
+    /// Copy a message into a slot and publish it.
+    /// \param[in]     msg           message.
+    /// \param[in]     timeout       wait for subscribers of @ref overflow::block (\ref CMSIS_RTOS_TimeOutValue or 0).
+    /// \return number of subscribers that got the message (0 also if every slot is in use).
+    uint32_t publish(const T &_msg, const uint32_t _timeout = forever)
+    {
+        T *msg = loan(_msg);
+        return (msg != nullptr) ? publish(msg, _timeout) : 0U;
+    }
+
+    /// Get the statistics.
+    topic_stats_t get_stats(void) const
+    {
+        return
+        {
+            .published = published_.load(std::memory_order_relaxed),
+            .exhausted = exhausted_.load(std::memory_order_relaxed),
+            .delivered = delivered_.load(std::memory_order_relaxed),
+        };
+    }
+};
+
+} // namespace os
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+
+namespace os
+{
+
+class waiters;
+
+/// Waiter on a @ref waiters list: something that waits for a kernel object without blocking a
+/// thread (an awaiting coroutine of os::coro).
+struct waiter_t
+{
+    waiter_t *next;
+    waiter_t *prev;
+    waiters  *list;     ///< List waited on.
+
+    /// Called by @ref waiters::sweep after the object has changed: tries once and removes the
+    /// waiter from its list if that succeeded. The waiter must not be touched after it is done.
+    void (*wake)(waiter_t &_waiter);
+};
+
+/// Completion hook of @ref queue, @ref semaphore and @ref event_flags.
+/// The objects call @ref notify after every change that may let a waiter succeed (put, release,
+/// set, destroy). notify is lock-free and callable from interrupts: it only links the list into a
+/// global list of kicked lists and, if that was empty, calls the @ref kick handler. The handler
+/// (installed by os::coro) runs @ref sweep_all in a thread, which calls the waiters of the kicked
+/// lists. With nobody waiting notify is a single atomic load.
+/// The waiter side (@ref add, @ref remove and @ref sweep_all) is serialized by its user.
+/// Only changes made through the wrappers are seen; raw osXxx calls on the object bypass the hook.
+class waiters
+{
+private:
+    std::atomic<uint32_t> count_;
+    std::atomic<bool>     kicked_;
+    waiters              *next_kicked_;
+    waiter_t             *head_;
+
+    /// Lists kicked and not yet swept.
+    static inline std::atomic<waiters *> kicked_head_ = nullptr;
+
+    /// Call the waiters, each removes itself when done.
+    void sweep(void)
+    {
+        kicked_.store(false);
+        waiter_t *waiter = head_;
+        while (waiter != nullptr)
+        {
+            waiter_t *next = waiter->next;
+            waiter->wake(*waiter);
+            waiter = next;
+        }
+    }
+
+public:
+    /// Kick handler: called from the context of @ref notify when the first list is kicked.
+    static inline void (*kick)(void) = nullptr;
+
+    constexpr waiters(): count_(0U), kicked_(false), next_kicked_(nullptr), head_(nullptr) {}
+
+    waiters(const waiters &) = delete;
+    waiters &operator=(const waiters &) = delete;
+
+    /// Signal a change of the object (lock-free, callable from interrupts).
+    void notify(void)
+    {
+        // Pairs with add: either the waiter sees the change or the change sees the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (count_.load(std::memory_order_relaxed) == 0U || kicked_.exchange(true))
+        {
+            return;
+        }
+        waiters *head = kicked_head_.load(std::memory_order_relaxed);
+        do
+        {
+            next_kicked_ = head;
+        } while (!kicked_head_.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+        if (head == nullptr)
+        {
+            kick();
+        }
+    }
+
+    /// Add a waiter of this list. It must try once after adding, a change before would not wake it.
+    void add(waiter_t &_waiter)
+    {
+        _waiter.prev = nullptr;
+        _waiter.next = head_;
+        if (head_ != nullptr)
+        {
+            head_->prev = &_waiter;
+        }
+        head_ = &_waiter;
+        count_.fetch_add(1U, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /// Remove a waiter that was added.
+    void remove(waiter_t &_waiter)
+    {
+        if (_waiter.prev != nullptr)
+        {
+            _waiter.prev->next = _waiter.next;
+        }
+        else
+        {
+            head_ = _waiter.next;
+        }
+        if (_waiter.next != nullptr)
+        {
+            _waiter.next->prev = _waiter.prev;
+        }
+        count_.fetch_sub(1U, std::memory_order_relaxed);
+    }
+
+    /// \return number of waiters.
+    uint32_t get_count(void) const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /// Sweep every kicked list (waiter side, after a @ref kick).
+    static void sweep_all(void)
+    {
+        waiters *list = kicked_head_.exchange(nullptr, std::memory_order_acquire);
+        while (list != nullptr)
+        {
+            waiters *next = list->next_kicked_;
+            list->sweep();
+            list = next;
+        }
+    }
+};
+
+} // namespace os
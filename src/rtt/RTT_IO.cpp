@@ -23,6 +23,7 @@
 
 #if (USR_PUT_RTT == 1) && (USR_GET_RTT == 1)
     #include "SEGGER_RTT.h"
+    #include "RTT_reserve.h"
 #endif
 
 
@@ -38,6 +39,19 @@
 #endif
 
 
+#if (USR_PUT_RTT == 1) && (USR_GET_RTT == 1) && defined(RTE_CMSIS_RTOS2)
+/// Blocking RTT output (see @ref rtt::wait): a thread sleeps a tick so the host and preempted
+/// producers can run; interrupts and code before the kernel start keep spinning.
+void rtt::wait(void)
+{
+    if ((__get_IPSR() == 0U) && (osKernelGetState() == osKernelRunning))
+    {
+        osDelay(1U);
+    }
+}
+#endif
+
+
 #if defined(RTE_Compiler_IO_TTY) || defined(RTE_Compiler_IO_STDOUT) || defined(RTE_Compiler_IO_STDERR)
 #if defined(RTE_Compiler_IO_TTY_User) || defined(RTE_Compiler_IO_STDOUT_User) || defined(RTE_Compiler_IO_STDERR_User)
 
@@ -81,7 +95,8 @@ int usr_put_char(int ch)
         int result = -1;
         
         #if (USR_PUT_RTT != 0)
-            result = static_cast<int>(SEGGER_RTT_PutChar(0, static_cast<char>(ch)));
+            const char c = static_cast<char>(ch);
+            result = (rtt::write(0, &c, 1) != 0) ? ch : -1;
         #endif
         
         #if (USR_PUT_ITM != 0)
@@ -107,7 +122,7 @@ void usr_put_str(const unsigned char *_buf, uint32_t _len)
     #else
         
         #if (USR_PUT_RTT != 0)
-            SEGGER_RTT_Write(0, _buf, _len);
+            rtt::write(0, _buf, _len);
         #endif
         
         #if (USR_PUT_ITM != 0)
@@ -0,0 +1,157 @@
+#include <string.h>
+#include <atomic>
+
+#include "SEGGER_RTT.h"
+#include "RTT_reserve.h"
+
+namespace rtt
+{
+
+/// Producer state of an up-buffer.
+struct claim_t
+{
+    uint32_t off;       ///< End of the claimed (reserved, not yet published) region
+    uint32_t pending;   ///< Number of outstanding reservations
+};
+
+static claim_t claim[SEGGER_RTT_MAX_NUM_UP_BUFFERS];
+
+static SEGGER_RTT_BUFFER_UP *ring(const uint32_t _ch)
+{
+    return reinterpret_cast<SEGGER_RTT_BUFFER_UP *>(reinterpret_cast<char *>(&_SEGGER_RTT.aUp[_ch]) + SEGGER_RTT_UNCACHED_OFF);
+}
+
+void reservation_t::write(uint32_t _off, const void *_data, uint32_t _size)
+{
+    const char *src = static_cast<const char *>(_data);
+
+    if (_off < len[0])
+    {
+        const uint32_t n = (_size < len[0] - _off) ? _size : len[0] - _off;
+        memcpy(ptr[0] + _off, src, n);
+        src += n;
+        _size -= n;
+        _off = len[0];
+    }
+    if (_size != 0U)
+    {
+        memcpy(ptr[1] + (_off - len[0]), src, _size);
+    }
+}
+
+uint32_t reserve(reservation_t &_res, const uint32_t _ch, const uint32_t _size, const bool _partial)
+{
+    _res = {{nullptr, nullptr}, {0U, 0U}, _ch};
+
+    if (_SEGGER_RTT.acID[0] == '\0')
+    {
+        SEGGER_RTT_Init();
+    }
+    if (_ch >= static_cast<uint32_t>(_SEGGER_RTT.MaxNumUpBuffers) || _size == 0U)
+    {
+        return 0U;
+    }
+
+    SEGGER_RTT_BUFFER_UP *rng = ring(_ch);
+    if (rng->SizeOfBuffer == 0U)
+    {
+        return 0U;
+    }
+    uint32_t n = 0U;
+
+    SEGGER_RTT_LOCK();
+    {
+        claim_t &clm = claim[_ch];
+        if (clm.pending == 0U)
+        {
+            clm.off = rng->WrOff;
+        }
+
+        const uint32_t rd = rng->RdOff;
+        const uint32_t wr = clm.off;
+        const uint32_t avail = (rd <= wr) ? rng->SizeOfBuffer - 1U - wr + rd : rd - wr - 1U;
+
+        n = (_size <= avail) ? _size : (_partial ? avail : 0U);
+        if (n != 0U)
+        {
+            const uint32_t tail = rng->SizeOfBuffer - wr;
+
+            _res.ptr[0] = rng->pBuffer + wr;
+            _res.len[0] = (n < tail) ? n : tail;
+            _res.ptr[1] = rng->pBuffer;
+            _res.len[1] = n - _res.len[0];
+
+            clm.off = (n < tail) ? wr + n : n - tail;
+            clm.pending++;
+        }
+    }
+    SEGGER_RTT_UNLOCK();
+
+    return n;
+}
+
+void commit(const reservation_t &_res)
+{
+    SEGGER_RTT_BUFFER_UP *rng = ring(_res.ch);
+
+    SEGGER_RTT_LOCK();
+    {
+        claim_t &clm = claim[_res.ch];
+        if (--clm.pending == 0U)
+        {
+            std::atomic_thread_fence(std::memory_order_release);
+            rng->WrOff = clm.off;
+        }
+    }
+    SEGGER_RTT_UNLOCK();
+}
+
+uint32_t write(const uint32_t _ch, const void *_data, const uint32_t _size)
+{
+    if (_SEGGER_RTT.acID[0] == '\0')
+    {
+        SEGGER_RTT_Init();
+    }
+    if (_ch >= static_cast<uint32_t>(_SEGGER_RTT.MaxNumUpBuffers))
+    {
+        return 0U;
+    }
+
+    const char *src = static_cast<const char *>(_data);
+    const uint32_t mode = ring(_ch)->Flags & SEGGER_RTT_MODE_MASK;
+    uint32_t done = 0U;
+    reservation_t res;
+
+    if (mode == SEGGER_RTT_MODE_NO_BLOCK_SKIP || mode == SEGGER_RTT_MODE_NO_BLOCK_TRIM)
+    {
+        const uint32_t n = reserve(res, _ch, _size, mode == SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        if (n != 0U)
+        {
+            res.write(0U, src, n);
+            commit(res);
+        }
+        return n;
+    }
+
+    while (done < _size)
+    {
+        const uint32_t n = reserve(res, _ch, _size - done, true);
+        if (n != 0U)
+        {
+            res.write(0U, src + done, n);
+            commit(res);
+            done += n;
+        }
+        else
+        {
+            wait();
+        }
+    }
+    return done;
+}
+
+__attribute__((weak)) void wait(void)
+{
+}
+
+} // namespace rtt
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+/// Zero-copy write access to the RTT up-buffers.
+/// A producer reserves space in the ring, fills it in place and commits it. Space is claimed under
+/// SEGGER_RTT_LOCK for a few instructions only; the data becomes visible to the host with a single
+/// WrOff store once every outstanding reservation of the channel is committed, so concurrent
+/// producers (threads, ISRs) keep their order of reservation.
+/// \warning Do not mix with SEGGER_RTT_Write* on the same channel while reservations are pending.
+namespace rtt
+{
+
+/// Reserved region of an up-buffer. It wraps at the end of the ring, so it consists of up to two spans.
+struct reservation_t
+{
+    char     *ptr[2];   ///< Start of span
+    uint32_t  len[2];   ///< Length of span in bytes
+    uint32_t  ch;       ///< Up-buffer index
+
+    /// \return reserved size in bytes.
+    uint32_t size(void) const
+    {
+        return len[0] + len[1];
+    }
+
+    /// Byte access across the wrap.
+    char &operator[](const uint32_t _idx)
+    {
+        return (_idx < len[0]) ? ptr[0][_idx] : ptr[1][_idx - len[0]];
+    }
+
+    /// Copy data into the reservation.
+    /// \param[in]     off           offset in the reservation.
+    /// \param[in]     data          source.
+    /// \param[in]     size          number of bytes (off + size must not exceed @ref size).
+    void write(uint32_t _off, const void *_data, uint32_t _size);
+};
+
+/// Reserve space in an up-buffer.
+/// \param[out]    res           reservation.
+/// \param[in]     ch            up-buffer index.
+/// \param[in]     size          number of bytes.
+/// \param[in]     partial       reserve as much as fits (true) or all-or-nothing (false).
+/// \return reserved size in bytes (0 - no space).
+uint32_t reserve(reservation_t &_res, const uint32_t _ch, const uint32_t _size, const bool _partial = false);
+
+/// Publish a reservation to the host.
+/// \param[in]     res           reservation obtained by @ref reserve with non-zero size.
+void commit(const reservation_t &_res);
+
+/// Write data through a reservation, honouring the channel mode (skip, trim or block if FIFO full).
+/// Blocking calls @ref wait between attempts; do not use the blocking mode from ISRs.
+/// \param[in]     ch            up-buffer index.
+/// \param[in]     data          source.
+/// \param[in]     size          number of bytes.
+/// \return number of bytes written.
+uint32_t write(const uint32_t _ch, const void *_data, const uint32_t _size);
+
+/// Called by a blocking @ref write while the up-buffer is full. The space is freed by the host
+/// and, since WrOff moves only when every reservation of the channel is committed, by producers
+/// holding a reservation; a writer of higher priority that spins starves both of them.
+/// The default (weak) spins; an RTOS application overrides it to sleep, e.g. osDelay(1).
+void wait(void);
+
+} // namespace rtt
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Host test check: report the failed condition and end the test with exit code 1.
+/// Tests run in os threads, so they end with exit() rather than by returning from main.
+#define CHECK(_cond)                                                                    \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(_cond))                                                                   \
+        {                                                                               \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #_cond);            \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+/// Host test wait: poll the condition once per tick and fail as CHECK if it does not hold within
+/// five seconds. The real-time backend gives no guarantee that another thread has run (or blocked)
+/// after a fixed delay, so a test waits for what it needs instead of sleeping.
+#define CHECK_SOON(_cond)                                                               \
+    do                                                                                  \
+    {                                                                                   \
+        for (uint32_t _tick = 0U; !(_cond) && _tick < 5U * OS_TICK_FREQ; _tick++)       \
+        {                                                                               \
+            os::delay(1U);                                                              \
+        }                                                                               \
+        CHECK(_cond);                                                                   \
+    } while (0)
@@ -0,0 +1,75 @@
+/// Host test of the std::chrono tick types (src/os/chrono.h) against the kernel tick count.
+/// Runs on the simulator backend, where the tick advances only when every thread blocks, so a
+/// delay ends exactly on the tick it asked for.
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "chrono.h"
+
+namespace
+{
+
+using namespace std::chrono_literals;
+
+static_assert(os::clock::is_steady);
+static_assert(std::is_same_v<os::clock::duration, os::ticks>);
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        // now() is the tick count
+        CHECK(os::clock::now().time_since_epoch().count() == os::kernel::get_tick_count());
+        os::delay(7U);
+        CHECK(os::clock::now().time_since_epoch().count() == os::kernel::get_tick_count());
+
+        // delay(duration) waits for the duration rounded up to whole ticks
+        os::clock::time_point t = os::clock::now();
+        CHECK(os::delay(20ms) == os::sts_t::OK);
+        CHECK(os::clock::now() - t == os::to_ticks(20ms));
+        t = os::clock::now();
+        CHECK(os::delay(1500us) == os::sts_t::OK);
+        CHECK(os::clock::now() - t == os::to_ticks(1500us));
+        CHECK(os::clock::now() - t >= 1500us);
+        t = os::clock::now();
+        CHECK(os::delay(std::chrono::duration<double>(0.25)) == os::sts_t::OK);
+        CHECK(os::clock::now() - t == os::to_ticks(250ms));
+
+        // delay_until(time_point) wakes exactly at the time point, so a periodic loop keeps its
+        // phase however long each round runs
+        os::clock::time_point next = os::clock::now();
+        for (uint32_t i = 0U; i < 10U; i++)
+        {
+            next += os::to_ticks(10ms);
+            if ((i & 1U) != 0U)
+            {
+                os::delay(3U);
+            }
+            CHECK(os::delay_until(next) == os::sts_t::OK);
+            CHECK(os::clock::now() == next);
+        }
+
+        // A time point in the past is not waited for
+        const os::clock::time_point before = os::clock::now();
+        CHECK(os::delay_until(before - os::ticks(5)) != os::sts_t::OK);
+        CHECK(os::clock::now() == before);
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,81 @@
+/// Host test of the run-time usage accounting of os::config (src/os/config.h): thread classes
+/// and modules add their usage on the first start, a start beyond the budget fails.
+
+#include "check.h"
+
+#include "os.h"
+#include "config.h"
+#include "thread.h"
+#include "isr.h"
+
+namespace
+{
+
+class sleeper: public os::thread<sleeper, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+/// Larger than the stack budget of the host build.
+class big: public os::thread<big, OS_CONFIG_STACK_BUDGET + 1024U, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+    }
+};
+
+sleeper sleeper_thread;
+big big_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        const os::config::usage_t base = main_thread::usage;
+        CHECK(os::config::get_usage() == base);
+
+        // A thread class counts once, however often it is started
+        CHECK(sleeper_thread.start("sleeper") == os::sts_t::OK);
+        CHECK(os::config::get_usage() == base + sleeper::usage);
+        CHECK(sleeper_thread.terminate() == os::sts_t::OK);
+        while (sleeper_thread.get_state() != os::tsts_t::err)
+        {
+            os::delay(1U);
+        }
+        CHECK(sleeper_thread.start("sleeper") == os::sts_t::OK);
+        CHECK(os::config::get_usage() == base + sleeper::usage);
+
+        // Modules add what their threads do not: the ISR FIFO entry of the deferred worker
+        CHECK(os::isr::start() == os::sts_t::OK);
+        CHECK(os::config::get_usage() == base + sleeper::usage + os::isr::usage);
+
+        // Beyond the budget: the start fails and nothing is added
+        CHECK(!os::config::fits(os::config::get_usage() + big::usage));
+        CHECK(big_thread.start("big") == os::sts_t::err_nomem);
+        CHECK(big_thread.get_id() == nullptr);
+        CHECK(os::config::get_usage() == base + sleeper::usage + os::isr::usage);
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,181 @@
+/// Host test of the hard fault record layout (src/os/crash.h) and of tools/crash/crash_decode.
+/// usage: crash_test <dir>
+/// Builds a synthetic record as the fault handler would, checks its validation, and writes the
+/// files decoded by the crash_decode tests of CMakeLists.txt: a minimal ELF image with two
+/// functions (crash.elf), the record as printed by os::crash::report (crash.txt), as raw
+/// `.bss.noinit` content (crash.bin) and with one word corrupted (crash_bad.txt).
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "check.h"
+
+#include "crash.h"
+
+namespace
+{
+
+/// Functions of the synthetic image (Thumb addresses).
+constexpr uint32_t fault_here = 0x08000121U;
+constexpr uint32_t caller = 0x08000201U;
+
+void put16(std::vector<uint8_t> &_img, const uint32_t _val)
+{
+    _img.push_back(static_cast<uint8_t>(_val));
+    _img.push_back(static_cast<uint8_t>(_val >> 8));
+}
+
+void put32(std::vector<uint8_t> &_img, const uint32_t _val)
+{
+    put16(_img, _val & 0xFFFFU);
+    put16(_img, _val >> 16);
+}
+
+/// 32-bit little endian ELF image with a symbol table and its string table only.
+std::vector<uint8_t> make_elf(void)
+{
+    static const char strtab[] = "\0fault_here\0caller";
+    constexpr uint32_t ehsize = 52U, symsize = 16U, shentsize = 40U;
+    constexpr uint32_t str_off = ehsize, sym_off = str_off + 20U, sh_off = sym_off + 3U * symsize;
+
+    std::vector<uint8_t> img = {0x7F, 'E', 'L', 'F', 1U, 1U, 1U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
+    put16(img, 2U);             // ET_EXEC
+    put16(img, 40U);            // EM_ARM
+    put32(img, 1U);
+    put32(img, fault_here);     // Entry
+    put32(img, 0U);             // No program headers
+    put32(img, sh_off);
+    put32(img, 0x05000000U);    // EABI version 5
+    put16(img, ehsize);
+    put16(img, 32U);
+    put16(img, 0U);
+    put16(img, shentsize);
+    put16(img, 3U);
+    put16(img, 0U);
+
+    img.insert(img.end(), strtab, strtab + sizeof(strtab));
+    img.resize(sym_off, 0U);
+
+    // Null symbol, then two global functions
+    img.resize(sym_off + symsize, 0U);
+    const struct { uint32_t name, addr, size; } funcs[] = {{1U, fault_here, 0x20U}, {12U, caller, 0x40U}};
+    for (const auto &f : funcs)
+    {
+        put32(img, f.name);
+        put32(img, f.addr);
+        put32(img, f.size);
+        img.push_back(0x12U);   // STB_GLOBAL, STT_FUNC
+        img.push_back(0U);
+        put16(img, 1U);
+    }
+
+    // Section headers: null, .symtab linked to .strtab
+    img.resize(sh_off + shentsize, 0U);
+    const uint32_t symtab[] = {0U, 2U, 0U, 0U, sym_off, 3U * symsize, 2U, 1U, 4U, symsize};
+    const uint32_t strtab_sh[] = {0U, 3U, 0U, 0U, str_off, sizeof(strtab), 0U, 0U, 1U, 0U};
+    for (const uint32_t val : symtab)
+    {
+        put32(img, val);
+    }
+    for (const uint32_t val : strtab_sh)
+    {
+        put32(img, val);
+    }
+    return img;
+}
+
+/// Record of a division by zero in fault_here, called from caller, in thread mode.
+os::crash::record_t make_record(void)
+{
+    os::crash::record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = os::crash::magic;
+    rec.version = os::crash::version;
+    rec.size = sizeof(rec);
+    for (uint32_t i = 0U; i < 13U; i++)
+    {
+        rec.r[i] = 0x10101010U * i;
+    }
+    rec.sp = 0x20001F00U;
+    rec.lr = caller + 0x10U;
+    rec.pc = (fault_here & ~1U) + 0x4U;
+    rec.psr = 0x01000000U;
+    rec.exc_return = 0xFFFFFFFDU;
+    rec.msp = 0x10000F80U;
+    rec.psp = rec.sp - 32U;
+    rec.cfsr = 1U << 25;
+    rec.hfsr = 1U << 30;
+    rec.thread_id = 0x20000400U;
+    strcpy(rec.thread_name, "worker");
+    rec.stack_words = 4U;
+    rec.stack[0] = 0x12345678U;
+    rec.stack[1] = caller + 0x20U;
+    rec.stack[2] = 0x20001F40U;
+    rec.stack[3] = 0xCCCCCCCCU;
+    rec.checksum = os::crash::checksum(rec);
+    return rec;
+}
+
+/// Text lines of os::crash::report.
+std::string to_text(const os::crash::record_t &_rec)
+{
+    std::string text = "Hard fault before the last reset.\n";
+    const uint32_t *words = reinterpret_cast<const uint32_t *>(&_rec);
+    for (uint32_t i = 0U; i < sizeof(_rec) / sizeof(uint32_t); i += 8U)
+    {
+        text += "CRSH";
+        for (uint32_t j = i; j < i + 8U && j < sizeof(_rec) / sizeof(uint32_t); j++)
+        {
+            char word[16];
+            snprintf(word, sizeof(word), " %08x", words[j]);
+            text += word;
+        }
+        text += "\r\n";
+    }
+    return text;
+}
+
+void write(const std::string &_path, const void *_data, const size_t _size)
+{
+    FILE *f = fopen(_path.c_str(), "wb");
+    CHECK(f != nullptr);
+    CHECK(fwrite(_data, 1U, _size, f) == _size);
+    CHECK(fclose(f) == 0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::string dir = (argc > 1) ? std::string(argv[1]) + "/" : std::string();
+
+    // A complete record is valid; any changed word, a foreign layout or an overlong stack is not
+    os::crash::record_t rec = make_record();
+    CHECK(os::crash::valid(rec));
+    os::crash::record_t bad = rec;
+    bad.pc ^= 0x100U;
+    CHECK(!os::crash::valid(bad));
+    bad = rec;
+    bad.version = os::crash::version + 1U;
+    bad.checksum = os::crash::checksum(bad);
+    CHECK(!os::crash::valid(bad));
+    bad = rec;
+    bad.stack_words = OS_CRASH_STACK_WORDS + 1U;
+    bad.checksum = os::crash::checksum(bad);
+    CHECK(!os::crash::valid(bad));
+
+    const std::vector<uint8_t> elf = make_elf();
+    write(dir + "crash.elf", elf.data(), elf.size());
+    const std::string text = to_text(rec);
+    write(dir + "crash.txt", text.data(), text.size());
+    write(dir + "crash.bin", &rec, sizeof(rec));
+
+    bad = rec;
+    bad.lr ^= 0x100U;
+    const std::string bad_text = to_text(bad);
+    write(dir + "crash_bad.txt", bad_text.data(), bad_text.size());
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/// Host test of the dropped record accounting of the deferred logger (src/dlog/dlog.h).
+
+#include <string.h>
+
+#include "check.h"
+
+#include "os.h"
+#include "SEGGER_RTT.h"
+#include "dlog.h"
+
+namespace
+{
+
+constexpr uint32_t id_test = 100U;
+
+uint8_t drained[4096];
+
+/// Read the whole up-buffer, as the host does.
+uint32_t drain(void)
+{
+    return SEGGER_RTT_ReadUpBufferNoLock(dlog::channel, drained, sizeof(drained));
+}
+
+/// \return word of a drained record.
+uint32_t word(const uint32_t _record, const uint32_t _idx)
+{
+    uint32_t val;
+    memcpy(&val, drained + _record + _idx * sizeof(uint32_t), sizeof(val));
+    return val;
+}
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    SEGGER_RTT_Init();
+    dlog::init();
+    CHECK(drain() == 3U * sizeof(uint32_t));
+    CHECK(word(0U, 0U) == dlog::id_sync);
+
+    // Fill the buffer: every record that does not fit is counted
+    uint32_t written = 0U;
+    while (dlog::write(id_test, written))
+    {
+        written++;
+    }
+    CHECK(written > 0U);
+    CHECK(dlog::dropped.load() == 1U);
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        CHECK(!dlog::write(id_test, i));
+    }
+    CHECK(dlog::dropped.load() == 5U);
+
+    // The dropped record does not fit either: the count is kept, not lost or increased
+    dlog::flush_dropped();
+    CHECK(dlog::dropped.load() == 5U);
+
+    CHECK(drain() == written * 3U * sizeof(uint32_t));
+    for (uint32_t i = 0U; i < written; i++)
+    {
+        CHECK(word(i * 3U * sizeof(uint32_t), 0U) == id_test);
+        CHECK(word(i * 3U * sizeof(uint32_t), 2U) == i);
+    }
+
+    // The next record is preceded by the dropped record with the whole count
+    CHECK(dlog::write(id_test, 7U));
+    CHECK(dlog::dropped.load() == 0U);
+    CHECK(drain() == 2U * 3U * sizeof(uint32_t));
+    CHECK(word(0U, 0U) == dlog::id_dropped);
+    CHECK(word(0U, 2U) == 5U);
+    CHECK(word(12U, 0U) == id_test);
+    CHECK(word(12U, 2U) == 7U);
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/// Host test of os::flags and os::event_flags (src/os/event_flags.h).
+/// The typed calls must give exactly what the raw osEventFlagsXxx calls give for the same masks,
+/// and the wrappers must add nothing to what is passed: a flags value is a plain 32-bit word
+/// and the event flags object is the control block plus the completion hook.
+
+#include <type_traits>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "event_flags.h"
+
+namespace
+{
+
+enum class ev: uint32_t { rx, tx, error, count };
+enum class wide: uint32_t { first, last = 30, count };
+enum plain { plain_a, plain_count };
+enum class no_count: uint32_t { a, b };
+
+using ev_flags = os::flags<ev>;
+
+// Only scoped enums with a count are flag enums; 31 flags use every bit below the error bit
+static_assert(os::flag_enum<ev> && os::flag_enum<wide>);
+static_assert(!os::flag_enum<plain> && !os::flag_enum<no_count> && !os::flag_enum<uint32_t>);
+static_assert(os::flags<wide>::all == 0x7FFFFFFFU);
+
+// Zero overhead: a flags value is passed like the raw mask, the object is the control block and
+// the completion hook
+static_assert(sizeof(ev_flags) == sizeof(uint32_t) && std::is_trivially_copyable_v<ev_flags>);
+static_assert(sizeof(os::event_flags<ev>) == sizeof(osRtxEventFlags_t) + sizeof(os::waiters));
+
+// Mask building and errors at compile time
+static_assert(ev_flags::all == 0x7U);
+static_assert((ev_flags(ev::rx) | ev::error).raw() == 0x5U);
+static_assert(((ev_flags(ev::rx) | ev::tx) & ev::tx) == ev::tx);
+static_assert(ev_flags().empty() && !ev_flags(ev::rx).empty());
+static_assert(ev_flags::from_raw(osFlagsErrorTimeout).status() == os::sts_t::err_timeout);
+static_assert(!ev_flags::from_raw(osFlagsErrorTimeout).has(ev::rx));
+static_assert(ev_flags::from_raw(0x3U).status() == os::sts_t::OK);
+
+os::event_flags<ev> events;
+osEventFlagsId_t raw_events;
+
+volatile uint32_t woken_all;
+
+/// Waits for rx and tx together.
+class waiter: public os::thread<waiter, 1024, os::priority::above_normal>
+{
+public:
+    void run(void)
+    {
+        const ev_flags got = events.wait_all(ev_flags(ev::rx) | ev::tx);
+        CHECK(got.status() == os::sts_t::OK && got.has(ev::rx) && got.has(ev::tx));
+        woken_all = got.raw();
+
+        // Woken by destroy
+        const ev_flags err = events.wait_any(ev::error);
+        CHECK(err.is_error() && err.status() == os::sts_t::err_resource);
+        woken_all = 0U;
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+waiter waiter_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        CHECK(events.create("events") == os::sts_t::OK);
+        CHECK(events.get_id() != nullptr && events.get_name() != nullptr);
+        raw_events = osEventFlagsNew(nullptr);
+        CHECK(raw_events != nullptr);
+
+        // The same results as the raw calls with the same masks and options
+        CHECK(events.set(ev::rx).raw() == osEventFlagsSet(raw_events, 0x1U));
+        CHECK(events.set(ev::error).raw() == osEventFlagsSet(raw_events, 0x4U));
+        CHECK(events.get().raw() == osEventFlagsGet(raw_events));
+        CHECK(events.wait_any(ev_flags(ev::tx) | ev::error, 0U, false).raw() ==
+              osEventFlagsWait(raw_events, 0x6U, osFlagsWaitAny | osFlagsNoClear, 0U));
+        CHECK(events.wait_all(ev_flags(ev::rx) | ev::tx, 0U).raw() == osEventFlagsWait(raw_events, 0x3U, osFlagsWaitAll, 0U));
+        CHECK(events.wait_any(ev::rx, 0U).raw() == osEventFlagsWait(raw_events, 0x1U, osFlagsWaitAny, 0U));
+        CHECK(events.get().raw() == osEventFlagsGet(raw_events) && events.get() == ev::error);
+        CHECK(events.clear(ev::error).raw() == osEventFlagsClear(raw_events, 0x4U));
+        CHECK(events.get().empty());
+
+        // Errors come back as status, never as flags
+        const ev_flags none = events.wait_any(ev::rx, 0U);
+        CHECK(none.is_error() && none.status() == os::sts_t::err_resource && !none.has(ev::rx));
+        CHECK(events.wait_any(ev::rx, std::chrono::milliseconds(3)).status() == os::sts_t::err_timeout);
+
+        // A waiting thread wakes only when all of its flags are set, and they are cleared
+        CHECK(waiter_thread.start("waiter") == os::sts_t::OK);
+        CHECK_SOON(waiter_thread.get_state() == os::tsts_t::blocked);
+        events.set(ev::rx);
+        os::delay(2U);
+        CHECK(woken_all == 0U);
+        events.set(ev::tx);
+        CHECK_SOON(woken_all == 0x3U);
+        CHECK(events.get().empty());
+
+        // Deleting wakes the waiters with an error
+        CHECK_SOON(waiter_thread.get_state() == os::tsts_t::blocked);
+        CHECK(events.destroy() == os::sts_t::OK);
+        CHECK_SOON(woken_all == 0U);
+        CHECK(osEventFlagsDelete(raw_events) == osOK);
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
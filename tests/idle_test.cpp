@@ -0,0 +1,64 @@
+/// Host test of the tickless idle arithmetic (src/os/idle.h) against a model of SysTick.
+/// Sleeps start at a random phase of a tick and wake up early at a random time or at the
+/// programmed end; the kernel tick count and the next tick must stay on the real time tick grid.
+
+#include <stdint.h>
+#include <random>
+
+#include "check.h"
+
+#include "idle.h"
+
+int main(void)
+{
+    constexpr uint32_t reload = 168000U;        // 168 MHz core clock, 1 kHz tick
+    constexpr uint32_t range = 1U << 24;
+
+    std::mt19937 rng(1U);
+    uint64_t time = 0U;     // real time in counts, at a tick boundary
+    uint64_t ticks = 0U;    // kernel tick count
+    uint32_t early = 0U;
+
+    for (uint32_t i = 0U; i < 100000U; i++)
+    {
+        // The idle thread suspends the kernel somewhere in the current tick
+        const uint32_t phase = rng() % reload;
+        const uint32_t timeout = 1U + rng() % 300U;
+        const uint32_t sleep = os::idle::sleep_ticks(timeout, reload, range);
+        if (sleep == 0U)
+        {
+            CHECK(timeout < os::idle::min_sleep_ticks);
+            time += reload;
+            ticks++;
+            continue;
+        }
+        CHECK(sleep <= timeout && sleep * reload <= range);
+
+        // Wake-up timer as programmed by idle.cpp: down-counter from load - 1
+        const uint32_t load = sleep * reload - phase;
+        const bool expired = (rng() % 4U) == 0U;
+        const uint32_t elapsed = expired ? load + rng() % 64U : rng() % load;
+        const uint32_t val = expired ? (load - 1U) - (elapsed - load) : (load - 1U) - elapsed;
+
+        const uint32_t counts = phase + os::idle::slept_counts(load, val, expired);
+        CHECK(counts == phase + elapsed);
+
+        const uint32_t slept = os::idle::slept_ticks(counts, reload);
+        const uint32_t first = os::idle::first_tick_counts(counts, reload);
+        CHECK(slept <= sleep + 1U);
+        CHECK(first >= reload / 4U && first <= reload + reload / 4U);
+
+        // The next tick lands on the grid: nothing of the partial ticks is lost
+        const uint64_t wake = time + counts;
+        ticks += slept;
+        CHECK(wake + first == (ticks + 1U) * reload);
+        early += expired ? 0U : 1U;
+
+        // The first tick and a few more while running
+        ticks += 1U + rng() % 3U;
+        time = ticks * reload;
+    }
+
+    CHECK(early > 0U);
+    return 0;
+}
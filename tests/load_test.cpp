@@ -0,0 +1,67 @@
+/// Host test of the per-thread time accounting of the CPU load statistics (src/os/load.h).
+
+#include "check.h"
+
+#include "load.h"
+
+namespace
+{
+
+/// Thread IDs: only the addresses matter.
+int ids[4];
+
+} // namespace
+
+int main(void)
+{
+    os::load::accounting<3> acc;
+
+    // Nothing is charged before the first switch
+    acc.update(100U);
+    CHECK(acc.total() == 0U);
+
+    acc.switched(&ids[0], 1000U);
+    acc.switched(&ids[1], 1300U);
+    acc.switched(&ids[0], 1400U);
+    acc.update(1500U);
+    CHECK(acc[0].id == &ids[0] && acc[0].time == 400U && acc[0].switches == 2U);
+    CHECK(acc[1].id == &ids[1] && acc[1].time == 100U && acc[1].switches == 1U);
+    CHECK(acc[2].id == nullptr && acc[2].time == 0U);
+
+    // The timer wraps around between two switches
+    acc.switched(&ids[2], 0xFFFFFF00U);
+    CHECK(acc[0].time == 400U + (0xFFFFFF00U - 1500U));
+    acc.switched(nullptr, 0x00000100U);
+    CHECK(acc[2].id == &ids[2] && acc[2].time == 0x200U);
+
+    // No thread running: charged to idle
+    acc.switched(&ids[1], 0x00000500U);
+    CHECK(acc.idle().time == 0x400U && acc.idle().switches == 1U);
+
+    // The table is full: further threads are summed up in other
+    acc.switched(&ids[3], 0x00000600U);
+    acc.switched(&ids[0], 0x00000680U);
+    CHECK(acc.other().time == 0x80U && acc.other().switches == 1U);
+    CHECK(acc[1].time == 100U + 0x100U);
+
+    const uint64_t total = acc[0].time + acc[1].time + acc[2].time + acc.other().time + acc.idle().time;
+    CHECK(acc.total() == total);
+    CHECK(acc.total() == 0x100000000U + 0x680U - 1000U);
+
+    // Reset keeps the table and restarts the times from now
+    acc.reset(0x1000U);
+    CHECK(acc.total() == 0U && acc[0].switches == 0U && acc.idle().switches == 0U);
+    CHECK(acc[0].id == &ids[0] && acc[1].id == &ids[1] && acc[2].id == &ids[2]);
+    acc.update(0x1010U);
+    CHECK(acc[0].time == 0x10U);
+
+    // Shares of a snapshot
+    os::load::snapshot_t snap = {};
+    snap.threads.switched(&ids[0], 0U);
+    snap.threads.switched(&ids[1], 750U);
+    snap.threads.update(1000U);
+    snap.total = snap.threads.total();
+    CHECK(snap.permille(0U) == 750U && snap.permille(1U) == 250U && snap.permille(2U) == 0U);
+
+    return 0;
+}
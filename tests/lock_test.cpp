@@ -0,0 +1,143 @@
+/// Host test of the kernel lock of the real-time POSIX backend (src/os/posix).
+/// The lock is a mutual exclusion between the host threads that take it: a thread that does not
+/// take it keeps delaying normally, another locker waits until the holder restores the lock, and
+/// one thread's unlock does not release the lock of another.
+
+#include <atomic>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+
+namespace
+{
+
+/// Ticks a bounded wait may take before the test fails.
+constexpr uint32_t limit = 1000U;
+
+std::atomic<uint32_t> rounds;
+std::atomic<uint32_t> failures;
+std::atomic<bool> locker_go;
+std::atomic<bool> locker_holds;
+std::atomic<bool> locker_release;
+std::atomic<bool> locker_released;
+
+/// Spin without blocking for a number of ticks or until a condition holds.
+template <typename F>
+bool spin_until(F _cond, const uint32_t _ticks = limit)
+{
+    const uint32_t start = os::kernel::get_tick_count();
+    while (!_cond())
+    {
+        if (os::kernel::get_tick_count() - start >= _ticks)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Delays one tick at a time and counts the results.
+class delayer: public os::thread<delayer, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            if (os::delay(1U) == os::sts_t::OK)
+            {
+                rounds++;
+            }
+            else
+            {
+                failures++;
+            }
+        }
+    }
+};
+
+/// Takes the lock on request and holds it until told to restore it.
+class locker: public os::thread<locker, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        while (!locker_go)
+        {
+            os::delay(1U);
+        }
+        const os::sts_t lock = os::kernel::lock();
+        CHECK(lock == os::sts_t::not_locked);
+        CHECK(osKernelGetState() == osKernelLocked);
+        locker_holds = true;
+        CHECK(spin_until([] { return locker_release.load(); }, 10U * limit));
+        locker_released = true;
+        CHECK(os::kernel::restore_lock(lock) == os::sts_t::not_locked);
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+delayer delayer_thread;
+locker locker_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        CHECK(delayer_thread.start("delayer") == os::sts_t::OK);
+        CHECK(locker_thread.start("locker") == os::sts_t::OK);
+        while (rounds == 0U)
+        {
+            os::delay(1U);
+        }
+
+        // The holder sees the kernel locked, nests, and may not block
+        const os::sts_t lock = os::kernel::lock();
+        CHECK(lock == os::sts_t::not_locked);
+        CHECK(osKernelGetState() == osKernelLocked);
+        CHECK(os::kernel::lock() == os::sts_t::locked);
+        CHECK(os::delay(1U) == os::sts_t::err);
+
+        // Another thread keeps delaying while the lock is held
+        const uint32_t held_rounds = rounds;
+        CHECK(spin_until([held_rounds] { return rounds >= held_rounds + 5U; }));
+        CHECK(failures == 0U);
+
+        // Another locker waits until the lock is restored
+        locker_go = true;
+        CHECK(!spin_until([] { return locker_holds.load(); }, 20U));
+        CHECK(os::kernel::restore_lock(lock) == os::sts_t::not_locked);
+        CHECK(osKernelGetState() == osKernelRunning);
+        CHECK(spin_until([] { return locker_holds.load(); }));
+
+        // Unlocking here does not release the lock of the other thread
+        CHECK(os::kernel::unlock() == os::sts_t::not_locked);
+        CHECK(os::kernel::restore_lock(os::sts_t::not_locked) == os::sts_t::not_locked);
+        locker_release = true;
+        CHECK(os::kernel::lock() == os::sts_t::not_locked);
+        CHECK(locker_released);
+        CHECK(os::kernel::unlock() == os::sts_t::locked);
+
+        CHECK(failures == 0U);
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
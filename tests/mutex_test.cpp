@@ -0,0 +1,166 @@
+/// Host test of os::mutex and os::lock_guard (src/os/mutex.h).
+
+#include <chrono>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "mutex.h"
+
+namespace
+{
+
+constexpr uint32_t rounds = 1000U;
+
+os::mutex<> mtx;
+os::mutex<os::mutex_attr::recursive> rmtx;
+os::mutex<os::mutex_attr::robust | os::mutex_attr::prio_inherit> holder_mtx;
+
+uint32_t counter;
+bool inside;
+
+/// Increments the counter under the lock, yielding inside the critical section.
+template <uint32_t _idx>
+class worker: public os::thread<worker<_idx>, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            os::lock_guard lock(mtx);
+            CHECK(lock.status() == os::sts_t::OK);
+            CHECK(!inside);
+            inside = true;
+            const uint32_t val = counter;
+            osThreadYield();
+            counter = val + 1U;
+            inside = false;
+        }
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+worker<0> worker0;
+worker<1> worker1;
+worker<2> worker2;
+worker<3> worker3;
+
+/// Low priority owner of the robust mutex.
+class holder: public os::thread<holder, 1024, os::priority::low>
+{
+public:
+    void run(void)
+    {
+        CHECK(holder_mtx.acquire() == os::sts_t::OK);
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+holder holder_thread;
+
+/// High priority thread blocking on the mutex of the holder.
+class contender: public os::thread<contender, 1024, os::priority::high>
+{
+public:
+    void run(void)
+    {
+        os::lock_guard lock(holder_mtx);
+        CHECK(lock);
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+contender contender_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        CHECK(mtx.create("mtx") == os::sts_t::OK);
+        CHECK(rmtx.create("rmtx") == os::sts_t::OK);
+        CHECK(holder_mtx.create("holder") == os::sts_t::OK);
+
+        // Mutual exclusion
+        CHECK(worker0.start() == os::sts_t::OK);
+        CHECK(worker1.start() == os::sts_t::OK);
+        CHECK(worker2.start() == os::sts_t::OK);
+        CHECK(worker3.start() == os::sts_t::OK);
+        while (counter < 4U * rounds)
+        {
+            os::delay(1U);
+        }
+        os::delay(1U);
+        CHECK(counter == 4U * rounds);
+        CHECK(mtx.get_owner() == nullptr);
+
+        // The guard releases at the end of the scope; the owner cannot take the mutex twice
+        {
+            os::lock_guard lock(mtx);
+            CHECK(mtx.get_owner() == osThreadGetId());
+            CHECK(mtx.acquire(0U) == os::sts_t::err_resource);
+        }
+        CHECK(mtx.get_owner() == nullptr);
+
+        // A guard that failed to acquire does not release the mutex of another owner
+        CHECK(holder_thread.start("holder") == os::sts_t::OK);
+        while (holder_mtx.get_owner() == nullptr)
+        {
+            os::delay(1U);
+        }
+        {
+            os::lock_guard lock(holder_mtx, 0U);
+            CHECK(!lock);
+            CHECK(lock.status() == os::sts_t::err_resource);
+        }
+        CHECK(holder_mtx.get_owner() == holder_thread.get_id());
+        CHECK(holder_mtx.acquire(std::chrono::milliseconds(3)) == os::sts_t::err_timeout);
+        CHECK(holder_mtx.get_owner() == holder_thread.get_id());
+
+        // Priority inheritance: the owner runs at the priority of the waiting thread
+        CHECK(contender_thread.start("contender") == os::sts_t::OK);
+        CHECK_SOON(contender_thread.get_state() == os::tsts_t::blocked);
+        CHECK(holder_thread.get_priority() == os::priority::high);
+
+        // Robust: the mutex is released when the owner terminates, the waiting thread gets it
+        CHECK(holder_thread.terminate() == os::sts_t::OK);
+        CHECK_SOON(holder_mtx.get_owner() == contender_thread.get_id());
+
+        // Recursive
+        CHECK(rmtx.acquire() == os::sts_t::OK);
+        {
+            os::lock_guard lock(rmtx, 0U);
+            CHECK(lock);
+        }
+        CHECK(rmtx.get_owner() == osThreadGetId());
+        CHECK(rmtx.release() == os::sts_t::OK);
+        CHECK(rmtx.get_owner() == nullptr);
+        CHECK(rmtx.release() == os::sts_t::err_resource);
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
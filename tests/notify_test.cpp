@@ -0,0 +1,106 @@
+/// Host test of the counting and value notifications (src/os/notify.h).
+/// Notifications sent before the receiver binds are kept, a counter counts every give, a mailbox
+/// keeps only the latest value, and a receiver sleeping on the thread flag is woken by a sender.
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "notify.h"
+
+namespace
+{
+
+enum class mode: uint32_t { idle, one, two, five };
+
+os::notify::counter<0> early;
+os::notify::counter<1> counts;
+os::notify::mailbox<mode, 2> box;
+os::notify::mailbox<uint32_t, 3> values;
+
+/// Gives and posts to the main thread while it sleeps.
+class sender: public os::thread<sender, 1024, os::priority::above_normal>
+{
+public:
+    void run(void)
+    {
+        os::delay(5U);
+        counts.give();
+        os::delay(5U);
+        box.post(mode::two);
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+sender sender_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        // Sent before any receiver is bound: kept, not lost
+        early.give();
+        early.give();
+        early.give();
+        CHECK(early.get_count() == 3U);
+        CHECK(early.take(0U) == os::sts_t::OK);
+        CHECK(early.take_all(0U) == 2U);
+        CHECK(early.take_all(0U) == 0U);
+        CHECK(early.take(0U) == os::sts_t::err_resource);
+        CHECK(early.take(3U) == os::sts_t::err_timeout);
+
+        // A post overwrites a value not yet received, try_post does not
+        CHECK(box.post(mode::one) == os::sts_t::OK);
+        CHECK(box.post(mode::five) == os::sts_t::OK);
+        CHECK(box.try_post(mode::idle) == os::sts_t::err_resource);
+        CHECK(box.is_pending());
+        mode m = mode::idle;
+        CHECK(box.receive(m, 0U) == os::sts_t::OK && m == mode::five);
+        CHECK(!box.is_pending());
+        CHECK(box.receive(m, 0U) == os::sts_t::err_resource);
+        CHECK(box.try_post(mode::one) == os::sts_t::OK);
+        CHECK(box.receive(m, 0U) == os::sts_t::OK && m == mode::one);
+
+        // Values are limited to 31 bits, and zero is a value like any other
+        uint32_t v = 1U;
+        CHECK(values.post(values.max_value + 1U) == os::sts_t::err_parameter);
+        CHECK(values.try_post(values.max_value + 1U) == os::sts_t::err_parameter);
+        CHECK(!values.is_pending());
+        CHECK(values.post(0U) == os::sts_t::OK);
+        CHECK(values.receive(v, 0U) == os::sts_t::OK && v == 0U);
+        CHECK(values.post(values.max_value) == os::sts_t::OK);
+        CHECK(values.receive(v, std::chrono::milliseconds(1)) == os::sts_t::OK && v == values.max_value);
+        CHECK(values.receive(v, std::chrono::milliseconds(3)) == os::sts_t::err_timeout);
+
+        // A sleeping receiver is woken by the sender; a leftover flag from a consumed
+        // notification does not end the wait
+        counts.bind(get_id());
+        counts.give();
+        CHECK(counts.take(0U) == os::sts_t::OK);
+        CHECK(sender_thread.start("sender") == os::sts_t::OK);
+        const uint32_t start = os::kernel::get_tick_count();
+        CHECK(counts.take_all(100U) == 1U);
+        CHECK(os::kernel::get_tick_count() - start < 100U);
+        CHECK(box.receive(m, 100U) == os::sts_t::OK && m == mode::two);
+        CHECK(os::kernel::get_tick_count() - start < 100U);
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,162 @@
+/// Host stress test of the lock-free block pool (src/os/pool.h).
+/// Host threads allocate and free blocks at random, directly and through per-thread caches, and
+/// mark each block they own; a block handed out twice or freed twice is caught by the marks.
+/// Afterwards every block must still be there exactly once. The pmr adapter is checked alone.
+/// On a single host core the threads only interleave where they yield or are preempted, which
+/// rarely hits the few instructions of a compare-and-swap loop: run it on several cores.
+
+#include <list>
+#include <random>
+#include <thread>
+
+#include "check.h"
+
+#include "pool.h"
+
+namespace
+{
+
+constexpr uint32_t blocks = 64U;
+constexpr uint32_t workers = 4U;
+constexpr uint32_t rounds = 2000000U;
+
+struct block_t
+{
+    uint32_t owner;
+    uint32_t seq;
+    uint8_t  data[24];
+};
+
+os::pool<block_t, blocks> blk_pool;
+
+/// Block ownership: 0 - free, else worker index + 1.
+std::atomic<uint32_t> owner[blocks];
+
+/// Lowest block of the pool.
+const block_t *first;
+
+uint32_t index_of(const block_t *_block)
+{
+    CHECK(blk_pool.owns(_block));
+    return static_cast<uint32_t>(_block - first);
+}
+
+template <class _alloc>
+void work(const uint32_t _idx, _alloc &_from)
+{
+    std::minstd_rand rng(_idx + 1U);
+    block_t *held[8];
+    uint32_t count = 0U;
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        if (count < 8U && (count == 0U || (rng() & 1U) != 0U))
+        {
+            block_t *block = _from.alloc();
+            if (block == nullptr)
+            {
+                continue;
+            }
+            CHECK(owner[index_of(block)].exchange(_idx + 1U) == 0U);
+            block->owner = _idx;
+            block->seq = i;
+            held[count++] = block;
+        }
+        else
+        {
+            const uint32_t pos = rng() % count;
+            block_t *block = held[pos];
+            held[pos] = held[--count];
+            CHECK(block->owner == _idx);
+            CHECK(owner[index_of(block)].exchange(0U) == _idx + 1U);
+            _from.free(block);
+        }
+        if ((rng() % 1024U) == 0U)
+        {
+            std::this_thread::yield();
+        }
+    }
+    while (count != 0U)
+    {
+        block_t *block = held[--count];
+        CHECK(owner[index_of(block)].exchange(0U) == _idx + 1U);
+        _from.free(block);
+    }
+}
+
+void direct(const uint32_t _idx)
+{
+    work(_idx, blk_pool);
+}
+
+void cached(const uint32_t _idx)
+{
+    os::pool<block_t, blocks>::cache<4> cache(blk_pool);
+    work(_idx, cache);
+}
+
+} // namespace
+
+int main(void)
+{
+    // The first fresh block is the lowest one
+    CHECK(blk_pool.get_untouched() == blocks);
+    block_t *block = blk_pool.alloc();
+    first = block;
+    blk_pool.free(block);
+    CHECK(blk_pool.get_untouched() == blocks - 1U);
+
+    std::thread threads[workers];
+    for (uint32_t i = 0U; i < workers; i++)
+    {
+        threads[i] = std::thread((i % 2U) == 0U ? direct : cached, i);
+    }
+    for (std::thread &thread: threads)
+    {
+        thread.join();
+    }
+
+    // Every block is free exactly once: all come back, then the pool is exhausted
+    bool seen[blocks] = {};
+    for (uint32_t i = 0U; i < blocks; i++)
+    {
+        block = blk_pool.alloc();
+        CHECK(block != nullptr);
+        const uint32_t idx = index_of(block);
+        CHECK(!seen[idx]);
+        seen[idx] = true;
+    }
+    CHECK(blk_pool.alloc() == nullptr);
+    CHECK(blk_pool.get_untouched() == 0U);
+
+    // Standard containers through the pmr adapter, with upstream for what does not fit
+    struct alignas(8) node_t
+    {
+        uint8_t data[32];
+    };
+    static os::pool<node_t, 8> node_pool;
+    os::pool_resource<decltype(node_pool)> res(node_pool, std::pmr::new_delete_resource());
+    {
+        std::pmr::list<uint32_t> list(&res);
+        for (uint32_t i = 0U; i < 20U; i++)
+        {
+            list.push_back(i);
+        }
+        CHECK(node_pool.alloc() == nullptr);
+        uint32_t expected = 0U;
+        for (const uint32_t val: list)
+        {
+            CHECK(val == expected++);
+        }
+        void *large = res.allocate(256U, 8U);
+        CHECK(large != nullptr && !node_pool.owns(large));
+        res.deallocate(large, 256U, 8U);
+    }
+    uint32_t free_nodes = 0U;
+    while (node_pool.alloc() != nullptr)
+    {
+        free_nodes++;
+    }
+    CHECK(free_nodes == 8U);
+
+    return 0;
+}
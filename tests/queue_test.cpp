@@ -0,0 +1,159 @@
+/// Host test of os::queue and os::borrow_queue (src/os/queue.h).
+
+#include <string.h>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "queue.h"
+
+namespace
+{
+
+constexpr uint32_t rounds = 10000U;
+
+struct frame_t
+{
+    uint32_t seq;
+    uint8_t  data[60];
+    uint32_t check;
+};
+
+/// Message with a life time to count (not trivially copyable).
+struct tracked_t
+{
+    static inline int alive = 0;
+
+    uint32_t val;
+
+    explicit tracked_t(const uint32_t _val): val(_val)
+    {
+        alive++;
+    }
+    ~tracked_t()
+    {
+        alive--;
+    }
+    tracked_t(const tracked_t &) = delete;
+};
+
+os::queue<frame_t, 4> frames;
+os::queue<uint32_t, 4> prios;
+os::borrow_queue<tracked_t, 4> borrowed;
+
+volatile uint32_t produced;
+
+/// Sends a numbered sequence through both queues, blocking while they are full.
+class producer: public os::thread<producer, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            frame_t frame;
+            frame.seq = i;
+            memset(frame.data, static_cast<int>(i), sizeof(frame.data));
+            frame.check = ~i;
+            CHECK(frames.put(frame) == os::sts_t::OK);
+            CHECK(borrowed.emplace(os::forever, i) == os::sts_t::OK);
+        }
+        produced = rounds;
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+producer producer_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        CHECK(frames.create("frames") == os::sts_t::OK);
+        CHECK(prios.create("prios") == os::sts_t::OK);
+        CHECK(borrowed.create("borrowed") == os::sts_t::OK);
+        CHECK(borrowed.get_space() == borrowed.capacity && borrowed.get_count() == 0U);
+
+        // Copy and zero-copy transfer in order, with the producer blocking on full queues
+        CHECK(producer_thread.start("producer") == os::sts_t::OK);
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            frame_t frame;
+            CHECK(frames.get(frame) == os::sts_t::OK);
+            CHECK(frame.seq == i && frame.check == ~i);
+            CHECK(frame.data[0] == static_cast<uint8_t>(i) && frame.data[sizeof(frame.data) - 1U] == static_cast<uint8_t>(i));
+
+            os::borrow_queue<tracked_t, 4>::handle msg = borrowed.receive();
+            CHECK(msg && msg->val == i);
+        }
+        CHECK_SOON(produced == rounds);
+        CHECK(frames.get_count() == 0U && borrowed.get_count() == 0U);
+
+        // Timeouts and priorities
+        frame_t frame = {};
+        CHECK(frames.get(frame, 0U) == os::sts_t::err_resource);
+        CHECK(frames.get(frame, std::chrono::milliseconds(2)) == os::sts_t::err_timeout);
+        CHECK(prios.put(1U, 0U, 0U) == os::sts_t::OK);
+        CHECK(prios.put(2U, 0U, 5U) == os::sts_t::OK);
+        CHECK(prios.put(3U, 0U, 0U) == os::sts_t::OK);
+        CHECK(prios.put(4U, 0U, 0U) == os::sts_t::OK);
+        CHECK(prios.put(5U, 0U, 0U) == os::sts_t::err_resource);
+        CHECK(prios.get_space() == 0U);
+        uint32_t val;
+        CHECK(prios.get(val) == os::sts_t::OK && val == 2U);
+        CHECK(prios.get(val) == os::sts_t::OK && val == 1U);
+        CHECK(prios.reset() == os::sts_t::OK && prios.get_count() == 0U);
+
+        // Borrowed slots: destroyed when the handle goes, also when moved or released by hand
+        CHECK(producer_thread.terminate() == os::sts_t::OK);
+        CHECK_SOON(producer_thread.get_state() != os::tsts_t::blocked);
+        CHECK(tracked_t::alive == 0);
+        tracked_t *slots[4];
+        for (tracked_t *&slot: slots)
+        {
+            slot = borrowed.alloc(0U, 7U);
+            CHECK(slot != nullptr);
+        }
+        CHECK(borrowed.alloc(0U, 0U) == nullptr);
+        CHECK(borrowed.emplace(0U, 0U) == os::sts_t::err_resource);
+        CHECK(tracked_t::alive == 4 && borrowed.get_space() == 0U);
+        borrowed.release(slots[3]);
+        CHECK(borrowed.send(slots[0]) == os::sts_t::OK);
+        CHECK(borrowed.send(slots[1], 1U) == os::sts_t::OK);
+        CHECK(borrowed.send(slots[2]) == os::sts_t::OK);
+        {
+            os::borrow_queue<tracked_t, 4>::handle first = borrowed.receive(0U);
+            CHECK(first.get() == slots[1]);
+            os::borrow_queue<tracked_t, 4>::handle moved = std::move(first);
+            CHECK(!first && moved.get() == slots[1]);
+            os::borrow_queue<tracked_t, 4>::handle kept = borrowed.receive(0U);
+            CHECK(kept.release() == slots[0] && !kept);
+            borrowed.release(slots[0]);
+            CHECK(tracked_t::alive == 2);
+        }
+        CHECK(tracked_t::alive == 1 && borrowed.get_count() == 1U);
+        borrowed.receive(0U).reset();
+        CHECK(tracked_t::alive == 0 && borrowed.get_space() == borrowed.capacity);
+        CHECK(!borrowed.receive(0U));
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
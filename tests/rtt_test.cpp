@@ -0,0 +1,144 @@
+/// Host test of the RTT reserve/commit API (src/rtt/RTT_reserve.h) with a simulated host reader.
+/// Runs on the simulator backend: priorities are enforced and a thread that spins without kernel
+/// calls keeps the CPU, like on the target.
+
+#include <string.h>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "SEGGER_RTT.h"
+#include "RTT_reserve.h"
+
+/// Blocking writes sleep a tick, as RTT_IO.cpp does on the target.
+void rtt::wait(void)
+{
+    os::delay(1U);
+}
+
+namespace
+{
+
+constexpr uint32_t channel = 1U;
+constexpr uint32_t ring_size = 32U;
+constexpr uint32_t claim_size = 8U;
+constexpr uint32_t write_size = 200U;
+
+char ring[ring_size];
+
+char captured[512];
+uint32_t captured_len;
+bool claimed;
+
+/// The debug probe: drains the up-buffer every tick.
+class reader: public os::thread<reader, 1024, os::priority::realtime>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            captured_len += SEGGER_RTT_ReadUpBufferNoLock(channel, captured + captured_len, sizeof(captured) - captured_len);
+            os::delay(1U);
+        }
+    }
+};
+
+/// Low priority producer: holds a reservation across a preemption.
+class producer: public os::thread<producer, 1024, os::priority::low>
+{
+public:
+    void run(void)
+    {
+        rtt::reservation_t res;
+        CHECK(rtt::reserve(res, channel, claim_size) == claim_size);
+        claimed = true;
+        os::delay(5U);
+        for (uint32_t i = 0U; i < claim_size; i++)
+        {
+            res[i] = 'P';
+        }
+        rtt::commit(res);
+    }
+};
+
+reader reader_thread;
+producer producer_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::high>
+{
+public:
+    void run(void)
+    {
+        // Reservation across the end of the ring: two spans, read back in order
+        char pattern[ring_size - 1U];
+        for (uint32_t i = 0U; i < sizeof(pattern); i++)
+        {
+            pattern[i] = static_cast<char>('a' + i % 26U);
+        }
+        CHECK(rtt::write(channel, pattern, 20U) == 20U);
+        os::delay(2U);
+        CHECK(captured_len == 20U);
+
+        rtt::reservation_t res;
+        CHECK(rtt::reserve(res, channel, 20U) == 20U);
+        CHECK(res.len[0] == ring_size - 20U && res.len[1] == 8U);
+        res.write(0U, pattern + 5U, 20U);
+        rtt::commit(res);
+        os::delay(2U);
+        CHECK(captured_len == 40U);
+        CHECK(memcmp(captured + 20U, pattern + 5U, 20U) == 0);
+
+        // Skip and trim modes do not wait for space
+        SEGGER_RTT_SetFlagsUpBuffer(channel, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        CHECK(rtt::write(channel, pattern, ring_size) == 0U);
+        SEGGER_RTT_SetFlagsUpBuffer(channel, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        CHECK(rtt::write(channel, pattern, ring_size) == ring_size - 1U);
+        os::delay(2U);
+        CHECK(captured_len == 40U + ring_size - 1U);
+        captured_len = 0U;
+
+        // A blocking writer of higher priority than a preempted producer holding a reservation:
+        // WrOff does not move until the producer commits, so the writer must let it run
+        SEGGER_RTT_SetFlagsUpBuffer(channel, SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+        CHECK(producer_thread.start("producer") == os::sts_t::OK);
+        while (!claimed)
+        {
+            os::delay(1U);
+        }
+
+        char data[write_size];
+        for (uint32_t i = 0U; i < write_size; i++)
+        {
+            data[i] = static_cast<char>('A' + i % 26U);
+        }
+        CHECK(rtt::write(channel, data, write_size) == write_size);
+        os::delay(2U);
+
+        CHECK(captured_len == claim_size + write_size);
+        for (uint32_t i = 0U; i < claim_size; i++)
+        {
+            CHECK(captured[i] == 'P');
+        }
+        CHECK(memcmp(captured + claim_size, data, write_size) == 0);
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    SEGGER_RTT_Init();
+    SEGGER_RTT_ConfigUpBuffer(channel, "test", ring, ring_size, SEGGER_RTT_MODE_BLOCK_IF_FIFO_FULL);
+
+    os::kernel::initialize();
+    reader_thread.start("reader");
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,141 @@
+/// Host test of the counting semaphore (src/os/sem.h).
+/// The token count must stay exact whatever happens to a waiter: a wait that times out withdraws
+/// from the waiters unless a release has handed it a token, a release never exceeds the maximum,
+/// and deleting the semaphore wakes its waiters with an error. The race of timeouts against
+/// releases is run many times with both falling on tick boundaries.
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "sem.h"
+
+namespace
+{
+
+constexpr uint32_t rounds = 500U;
+
+os::semaphore<2U, 1U> limited;
+os::binary_semaphore handover;
+os::binary_semaphore doomed;
+os::semaphore<rounds> racy;
+
+volatile int32_t handed_sts = 1;
+volatile int32_t woken_sts = 1;
+volatile uint32_t acquired;
+volatile bool racer_done;
+
+/// Waits for a hand-over, then on a semaphore that gets deleted.
+class waiter: public os::thread<waiter, 1024, os::priority::above_normal>
+{
+public:
+    void run(void)
+    {
+        handed_sts = static_cast<int32_t>(handover.acquire());
+        woken_sts = static_cast<int32_t>(doomed.acquire());
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+/// Acquires with a one tick timeout against the releases of the main thread.
+class racer: public os::thread<racer, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t i = 0U; i < 2U * rounds; i++)
+        {
+            const os::sts_t sts = racy.acquire(1U);
+            CHECK(sts == os::sts_t::OK || sts == os::sts_t::err_timeout);
+            if (sts == os::sts_t::OK)
+            {
+                acquired = acquired + 1U;
+            }
+        }
+        racer_done = true;
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+waiter waiter_thread;
+racer racer_thread;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        CHECK(limited.create("limited") == os::sts_t::OK);
+        CHECK(handover.create("handover") == os::sts_t::OK);
+        CHECK(doomed.create("doomed") == os::sts_t::OK);
+        CHECK(racy.create("racy") == os::sts_t::OK);
+
+        // The maximum count limits release, not only the initial count
+        CHECK(limited.get_count() == 1U);
+        CHECK(limited.release() == os::sts_t::OK);
+        CHECK(limited.release() == os::sts_t::err_resource);
+        CHECK(limited.get_count() == 2U);
+        CHECK(limited.acquire(0U) == os::sts_t::OK);
+        CHECK(limited.acquire(os::forever) == os::sts_t::OK);
+        CHECK(limited.acquire(0U) == os::sts_t::err_resource);
+
+        // A timed-out wait withdraws: the next release is a token again, not a hand-over
+        CHECK(limited.acquire(3U) == os::sts_t::err_timeout);
+        CHECK(limited.acquire(std::chrono::milliseconds(2)) == os::sts_t::err_timeout);
+        CHECK(limited.get_count() == 0U);
+        CHECK(limited.release() == os::sts_t::OK);
+        CHECK(limited.get_count() == 1U);
+        CHECK(limited.acquire(0U) == os::sts_t::OK);
+
+        // A release with a waiter hands the token over without counting it
+        CHECK(waiter_thread.start("waiter") == os::sts_t::OK);
+        CHECK_SOON(waiter_thread.get_state() == os::tsts_t::blocked);
+        CHECK(handed_sts == 1);
+        CHECK(handover.release() == os::sts_t::OK);
+        CHECK_SOON(handed_sts == static_cast<int32_t>(os::sts_t::OK));
+        CHECK(handover.get_count() == 0U);
+        CHECK(handover.acquire(0U) == os::sts_t::err_resource);
+
+        // Deleting wakes the waiter with an error and leaves no waiter counted
+        CHECK_SOON(waiter_thread.get_state() == os::tsts_t::blocked);
+        CHECK(woken_sts == 1);
+        CHECK(doomed.destroy() == os::sts_t::OK);
+        CHECK_SOON(woken_sts == static_cast<int32_t>(os::sts_t::err_resource));
+        CHECK(doomed.get_count() == 0U);
+
+        // Releases on tick boundaries race with timeouts on tick boundaries: every token is
+        // either acquired or still counted, none is lost to a withdrawing waiter
+        CHECK(racer_thread.start("racer") == os::sts_t::OK);
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            os::delay(((i & 1U) != 0U) ? 1U : 2U);
+            CHECK(racy.release() == os::sts_t::OK);
+        }
+        while (!racer_done)
+        {
+            os::delay(1U);
+        }
+        CHECK(acquired + racy.get_count() == rounds);
+
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,172 @@
+/// Host test of the virtual-time simulator (src/os/posix, OS_POSIX_SIM=1).
+/// Threads of different priorities delay for ten virtual minutes in irregular steps and record
+/// the tick of every wake-up. The tick must not move while a thread runs without blocking, every
+/// delay must end exactly on its tick, the whole run must take a fraction of the virtual time,
+/// and two runs (in child processes, as the kernel cannot be started twice) must record the same
+/// trace word for word.
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <vector>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+
+namespace
+{
+
+constexpr uint32_t minutes = 10U;
+constexpr uint32_t end_tick = minutes * 60U * OS_TICK_FREQ;
+constexpr uint32_t trace_max = 4096U;
+
+/// Wall-clock limit of one run in seconds.
+constexpr uint32_t wall_max = 20U;
+
+struct entry_t
+{
+    uint32_t tick;
+    uint32_t who;
+};
+
+entry_t trace[trace_max];
+uint32_t trace_len;
+uint32_t done;
+
+void record(const uint32_t _who)
+{
+    CHECK(trace_len < trace_max);
+    trace[trace_len++] = {os::kernel::get_tick_count(), _who};
+}
+
+/// Delays in pseudo-random steps of up to a few seconds until the end tick.
+template <uint32_t _idx, os::priority _prio>
+class sleeper: public os::thread<sleeper<_idx, _prio>, 1024, _prio>
+{
+public:
+    void run(void)
+    {
+        uint32_t seed = _idx + 1U;
+        for (;;)
+        {
+            seed = seed * 1103515245U + 12345U;
+            const uint32_t step = 1U + (seed >> 8) % (5U * OS_TICK_FREQ);
+            const uint32_t start = os::kernel::get_tick_count();
+            if (start >= end_tick)
+            {
+                break;
+            }
+            CHECK(os::delay(step) == os::sts_t::OK);
+            CHECK(os::kernel::get_tick_count() - start == step);
+            record(_idx);
+        }
+        done++;
+        for (;;)
+        {
+            os::delay(end_tick);
+        }
+    }
+};
+
+sleeper<0, os::priority::high> sleeper0;
+sleeper<1, os::priority::normal> sleeper1;
+sleeper<2, os::priority::normal> sleeper2;
+sleeper<3, os::priority::low> sleeper3;
+
+uint64_t wall_ns(void)
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000U + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+int out_fd;
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::below_normal>
+{
+public:
+    void run(void)
+    {
+        sleeper0.start("sleeper0");
+        sleeper1.start("sleeper1");
+        sleeper2.start("sleeper2");
+        sleeper3.start("sleeper3");
+
+        // A running thread holds virtual time still, however long it runs on the host
+        const uint32_t tick = os::kernel::get_tick_count();
+        const uint64_t wall = wall_ns();
+        while (wall_ns() - wall < 20000000U)
+        {
+        }
+        CHECK(os::kernel::get_tick_count() == tick);
+
+        while (done < 4U)
+        {
+            os::delay(OS_TICK_FREQ);
+        }
+        CHECK(trace_len > 4U * minutes * 60U / 5U);
+
+        const size_t size = trace_len * sizeof(entry_t);
+        CHECK(write(out_fd, trace, size) == static_cast<ssize_t>(size));
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+/// Run the scenario in a child process.
+/// \return trace of the run.
+std::vector<entry_t> run_child(void)
+{
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    const uint64_t wall = wall_ns();
+    const pid_t pid = fork();
+    CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        close(fds[0]);
+        out_fd = fds[1];
+        os::kernel::initialize();
+        main_thread_obj.start("main");
+        os::kernel::start();
+        _exit(1);
+    }
+    close(fds[1]);
+
+    std::vector<entry_t> result;
+    entry_t buf[256];
+    size_t have = 0U;
+    ssize_t n;
+    while ((n = read(fds[0], reinterpret_cast<uint8_t *>(buf) + have, sizeof(buf) - have)) > 0)
+    {
+        have += static_cast<size_t>(n);
+        const size_t cnt = have / sizeof(entry_t);
+        result.insert(result.end(), buf, buf + cnt);
+        have -= cnt * sizeof(entry_t);
+        memmove(buf, buf + cnt, have);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    CHECK(have == 0U);
+    CHECK(wall_ns() - wall < wall_max * 1000000000ULL);
+    return result;
+}
+
+} // namespace
+
+int main(void)
+{
+    const std::vector<entry_t> first = run_child();
+    const std::vector<entry_t> second = run_child();
+    CHECK(!first.empty() && first.size() == second.size());
+    CHECK(memcmp(first.data(), second.data(), first.size() * sizeof(entry_t)) == 0);
+    CHECK(first.back().tick >= end_tick);
+    return 0;
+}
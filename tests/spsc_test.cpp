@@ -0,0 +1,131 @@
+/// Host stress test of the SPSC ring buffer (src/os/spsc_ring.h).
+/// A producer and a consumer host thread move a numbered sequence through a small ring with
+/// every mix of single, span and peek/consume operations; the consumer checks order and content.
+
+#include <random>
+#include <thread>
+
+#include "check.h"
+
+#include "spsc_ring.h"
+
+namespace
+{
+
+constexpr uint32_t items = 2000000U;
+
+struct item_t
+{
+    uint32_t seq;
+    uint32_t inv;   ///< ~seq: detects an element read before it was completely written
+};
+
+os::spsc_ring<item_t, 64> ring;
+
+void produce(void)
+{
+    std::minstd_rand rng(1U);
+    item_t batch[24];
+    uint32_t seq = 0U;
+    while (seq < items)
+    {
+        if ((rng() & 1U) != 0U)
+        {
+            if (ring.push(item_t{seq, ~seq}))
+            {
+                seq++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        const uint32_t left = items - seq;
+        const uint32_t cnt = 1U + rng() % 24U;
+        const uint32_t n = (cnt < left) ? cnt : left;
+        for (uint32_t i = 0U; i < n; i++)
+        {
+            batch[i] = {seq + i, ~(seq + i)};
+        }
+        const uint32_t pushed = ring.push(std::span<const item_t>(batch, n));
+        CHECK(pushed <= n);
+        seq += pushed;
+        if (pushed == 0U)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void check(const item_t &_item, uint32_t &_seq)
+{
+    CHECK(_item.seq == _seq);
+    CHECK(_item.inv == ~_seq);
+    _seq++;
+}
+
+void consume(void)
+{
+    std::minstd_rand rng(2U);
+    item_t batch[24];
+    uint32_t seq = 0U;
+    while (seq < items)
+    {
+        uint32_t got = 0U;
+        switch (rng() % 3U)
+        {
+            case 0U:
+            {
+                item_t item;
+                if (ring.pop(item))
+                {
+                    check(item, seq);
+                    got = 1U;
+                }
+            }
+            break;
+            case 1U:
+            {
+                got = ring.pop(std::span<item_t>(batch, 1U + rng() % 24U));
+                for (uint32_t i = 0U; i < got; i++)
+                {
+                    check(batch[i], seq);
+                }
+            }
+            break;
+            default:
+            {
+                const std::span<const item_t> part = ring.peek();
+                got = static_cast<uint32_t>(part.size());
+                for (const item_t &item: part)
+                {
+                    check(item, seq);
+                }
+                ring.consume(got);
+            }
+            break;
+        }
+        CHECK(ring.size() <= ring.capacity);
+        if (got == 0U)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+int main(void)
+{
+    std::thread producer(produce);
+    std::thread consumer(consume);
+    producer.join();
+    consumer.join();
+
+    CHECK(ring.empty());
+    item_t item;
+    CHECK(!ring.pop(item));
+    return 0;
+}
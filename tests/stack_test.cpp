@@ -0,0 +1,68 @@
+/// Host test of the incremental stack watermark scan (src/os/stack.h).
+
+#include "check.h"
+
+#include "stack.h"
+
+namespace
+{
+
+constexpr uint32_t words = 64U;
+
+uint32_t mem[words];
+
+/// Run steps of `cnt` words until a round ends.
+/// \return number of steps.
+uint32_t round(os::stack::scan_t &_scan, const uint32_t _cnt)
+{
+    uint32_t steps = 1U;
+    while (!_scan.step(_cnt))
+    {
+        steps++;
+    }
+    return steps;
+}
+
+} // namespace
+
+int main(void)
+{
+    mem[0] = osRtxStackMagicWord;
+    for (uint32_t i = 1U; i < words; i++)
+    {
+        mem[i] = os::stack::fill_pattern;
+    }
+
+    os::stack::scan_t scan(mem, words);
+    CHECK(scan.size() == words * sizeof(uint32_t));
+    CHECK(scan.peak() == 0U);
+
+    // Unused stack: a round walks every word but the magic word
+    CHECK(round(scan, 16U) == 4U);
+    CHECK(scan.peak() == 0U);
+
+    // The stack grows down from the top; a word that keeps the pattern above the mark is ignored
+    for (uint32_t i = 40U; i < words; i++)
+    {
+        mem[i] = (i == 50U) ? os::stack::fill_pattern : i;
+    }
+    CHECK(round(scan, 16U) == 3U);
+    CHECK(scan.peak() == (words - 40U) * sizeof(uint32_t));
+
+    // Nothing deeper: a round ends at the known mark, the peak is kept
+    CHECK(round(scan, 16U) == 3U);
+    CHECK(scan.peak() == (words - 40U) * sizeof(uint32_t));
+
+    // Deeper use found in the middle of a round
+    CHECK(!scan.step(8U));
+    mem[20U] = 0U;
+    CHECK(round(scan, 8U) == 2U);
+    CHECK(scan.peak() == (words - 20U) * sizeof(uint32_t));
+
+    // Overflow into the lowest word
+    mem[1U] = 0U;
+    CHECK(round(scan, 1U) == 1U);
+    CHECK(scan.peak() == (words - 1U) * sizeof(uint32_t));
+
+    return 0;
+}
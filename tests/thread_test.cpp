@@ -0,0 +1,66 @@
+/// Host test of os::thread (src/os/thread.h) and thread termination in the POSIX backend.
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+
+namespace
+{
+
+class sleeper: public os::thread<sleeper, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+sleeper sleeper_thread;
+sleeper sleeper_twin;
+
+/// Whether the thread still holds its control block, so that start refuses it.
+bool is_alive(const sleeper &_thread)
+{
+    const os::tsts_t state = _thread.get_state();
+    return state == os::tsts_t::ready || state == os::tsts_t::running || state == os::tsts_t::blocked;
+}
+
+class main_thread: public os::thread<main_thread, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t i = 0U; i < 20U; i++)
+        {
+            CHECK(sleeper_thread.start("sleeper") == os::sts_t::OK);
+            CHECK_SOON(sleeper_thread.get_state() == os::tsts_t::blocked);
+
+            // One thread per class: a second object must not reuse the live control block
+            CHECK(sleeper_twin.start("twin") == os::sts_t::err_resource);
+            CHECK(sleeper_twin.get_id() == sleeper_thread.get_id());
+
+            // Terminate while it sleeps in osDelay, holding the kernel lock in its call
+            CHECK(sleeper_thread.terminate() == os::sts_t::OK);
+            CHECK_SOON(!is_alive(sleeper_thread));
+        }
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
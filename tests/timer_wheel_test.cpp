@@ -0,0 +1,208 @@
+/// Host test of the hierarchical timer wheel (src/os/timer_wheel.h) against a model.
+/// Timers on every level are started, restarted and stopped at random while the wheel advances
+/// in steps of one tick, in random jumps and as far as next() allows, across the 32-bit wrap
+/// of the tick. Every timer must come out exactly in the step that passes its expiry.
+
+#include <random>
+
+#include "check.h"
+
+#include "timer_wheel.h"
+
+namespace
+{
+
+constexpr uint32_t count = 200U;
+
+os::timer_wheel wheel;
+
+void expired(void *)
+{
+}
+
+struct model_t
+{
+    bool     running;
+    uint32_t expiry;
+    uint32_t period;
+};
+
+os::wheel_timer_t *timers[count];
+model_t model[count];
+
+/// \return index of a timer.
+uint32_t index_of(const os::wheel_timer_t *_timer)
+{
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (timers[i] == _timer)
+        {
+            return i;
+        }
+    }
+    CHECK(false);
+    return 0U;
+}
+
+/// Advance the wheel and check the due timers against the model.
+void advance(const uint32_t _now)
+{
+    const uint32_t before = wheel.get_now();
+    wheel.advance(_now);
+    CHECK(wheel.get_now() == _now);
+
+    for (os::wheel_timer_t *timer = wheel.pop(); timer != nullptr; timer = wheel.pop())
+    {
+        const uint32_t idx = index_of(timer);
+        model_t &m = model[idx];
+        CHECK(m.running);
+
+        // Expired in this step: after the previous tick, not later than now
+        CHECK(m.expiry - before - 1U < _now - before);
+        if (m.period != 0U)
+        {
+            // The next period starts from the expiry; if that has passed too, at the next tick
+            m.expiry += m.period;
+            if (static_cast<int32_t>(m.expiry - _now) <= 0)
+            {
+                m.expiry = _now + 1U;
+            }
+            CHECK(timer->running());
+        }
+        else
+        {
+            m.running = false;
+            CHECK(!timer->running());
+        }
+    }
+
+    // Nothing that expired is left behind
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (model[i].running)
+        {
+            CHECK(timers[i]->running());
+            CHECK(static_cast<int32_t>(model[i].expiry - _now) > 0);
+        }
+    }
+}
+
+/// \return ticks to the earliest expiry of the model (forever - none).
+uint32_t model_next(void)
+{
+    uint32_t best = os::forever;
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (model[i].running && model[i].expiry - wheel.get_now() < best)
+        {
+            best = model[i].expiry - wheel.get_now();
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main(void)
+{
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        timers[i] = new os::wheel_timer_t(expired);
+    }
+
+    // Insert and expire on level 0 and after a cascade from every level
+    wheel.reset(1000U);
+    for (uint32_t level = 0U; level < os::timer_wheel::levels; level++)
+    {
+        const uint32_t ticks = (1U << (os::timer_wheel::bits * level)) + 5U;
+        wheel.start(*timers[0], wheel.get_now() + ticks);
+        CHECK(timers[0]->running() && timers[0]->level == level);
+        CHECK(wheel.next() != 0U && wheel.next() <= ticks);
+        wheel.advance(wheel.get_now() + ticks - 1U);
+        CHECK(wheel.pop() == nullptr && timers[0]->running());
+        wheel.advance(wheel.get_now() + 1U);
+        CHECK(wheel.pop() == timers[0] && !timers[0]->running());
+        CHECK(wheel.next() == os::forever);
+    }
+
+    // A stopped timer does not expire; restart moves a timer
+    wheel.start(*timers[0], wheel.get_now() + 10U);
+    wheel.start(*timers[1], wheel.get_now() + 10U);
+    CHECK(wheel.stop(*timers[0]) && !wheel.stop(*timers[0]));
+    wheel.start(*timers[1], wheel.get_now() + 300U);
+    wheel.advance(wheel.get_now() + 299U);
+    CHECK(wheel.pop() == nullptr);
+    wheel.advance(wheel.get_now() + 1U);
+    CHECK(wheel.pop() == timers[1] && wheel.pop() == nullptr);
+
+    // A past expiry is due at the next tick
+    wheel.start(*timers[0], wheel.get_now() - 5U);
+    wheel.advance(wheel.get_now() + 1U);
+    CHECK(wheel.pop() == timers[0]);
+
+    // Random operations across the wrap of the tick
+    std::mt19937 rng(1U);
+    wheel.reset(0xFFFF0000U);
+    bool wrapped = false;
+    for (uint32_t round = 0U; round < 200000U; round++)
+    {
+        const uint32_t idx = rng() % count;
+        switch (rng() % 8U)
+        {
+            case 0U:
+            case 1U:
+            {
+                // Timeouts of every level, also beyond the range of the wheel
+                const uint32_t shift = rng() % (os::timer_wheel::bits * os::timer_wheel::levels + 2U);
+                const uint32_t ticks = 1U + (rng() & ((1U << shift) - 1U));
+                const uint32_t period = ((rng() % 4U) == 0U) ? 1U + rng() % 200U : 0U;
+                wheel.start(*timers[idx], wheel.get_now() + ticks, period);
+                model[idx] = {true, wheel.get_now() + ticks, period};
+            }
+            break;
+            case 2U:
+                CHECK(wheel.stop(*timers[idx]) == model[idx].running);
+                model[idx].running = false;
+            break;
+            case 3U:
+            {
+                // Like the service thread: sleep as long as next() allows
+                const uint32_t next = wheel.next();
+                CHECK(next <= model_next());
+                if (next != os::forever)
+                {
+                    advance(wheel.get_now() + next);
+                }
+            }
+            break;
+            case 4U:
+                advance(wheel.get_now() + rng() % 5000U);
+            break;
+            default:
+                advance(wheel.get_now() + 1U);
+            break;
+        }
+        wrapped = wrapped || wheel.get_now() < 0x80000000U;
+    }
+    CHECK(wrapped);
+
+    // Timers beyond the range expire in time after any number of cascades
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        if (model[i].running)
+        {
+            CHECK(wheel.stop(*timers[i]));
+            model[i].running = false;
+        }
+    }
+    wheel.start(*timers[0], wheel.get_now() + 3U * os::timer_wheel::range);
+    model[0] = {true, wheel.get_now() + 3U * os::timer_wheel::range, 0U};
+    while (model[0].running)
+    {
+        const uint32_t next = wheel.next();
+        CHECK(next != os::forever && next <= model_next());
+        advance(wheel.get_now() + next);
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/// Host test of the lock-free 64-bit extension of the timestamp counter (src/os/timestamp.h)
+/// under concurrent readers. A simulated 32-bit counter wraps every few thousand reads. Readers
+/// of equal priority yield before and after reading the count, i.e. on both sides of the state
+/// load, and a high priority thread (the tick hook of the target) reads in between. Runs on the
+/// simulator backend, where switches happen only at kernel calls, so the interleavings repeat.
+
+#include <random>
+
+#include "check.h"
+
+#include "os.h"
+#include "thread.h"
+#include "timestamp.h"
+
+namespace
+{
+
+constexpr uint32_t reads = 50000U;
+constexpr uint32_t step_max = 1U << 20;
+
+std::atomic<uint32_t> state;
+uint64_t clock64;       ///< True time; the readers see its lower 32 bits
+uint32_t done;
+
+/// Reader: advances the clock and checks the extended value against it.
+template <uint32_t _idx>
+class reader: public os::thread<reader<_idx>, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        std::minstd_rand rng(_idx + 1U);
+        uint64_t last = 0U;
+        for (uint32_t i = 0U; i < reads; i++)
+        {
+            uint64_t now = 0U;
+            const uint64_t val = os::timestamp::extend(state, [&]
+            {
+                if ((rng() & 1U) != 0U)
+                {
+                    osThreadYield();
+                }
+                if ((rng() & 63U) == 0U)
+                {
+                    os::delay(1U);
+                }
+                clock64 += 1U + rng() % step_max;
+                now = clock64;
+                if ((rng() & 1U) != 0U)
+                {
+                    osThreadYield();
+                }
+                return static_cast<uint32_t>(now);
+            });
+            CHECK(val == now);
+            CHECK(val > last);
+            last = val;
+        }
+        done++;
+        for (;;)
+        {
+            os::delay(1000U);
+        }
+    }
+};
+
+reader<0> reader0;
+reader<1> reader1;
+reader<2> reader2;
+reader<3> reader3;
+
+/// Tick hook: reads without advancing the clock whenever a tick passes.
+class ticker: public os::thread<ticker, 1024, os::priority::high>
+{
+public:
+    uint32_t reads_;
+
+    void run(void)
+    {
+        for (;;)
+        {
+            os::delay(1U);
+            const uint64_t now = clock64;
+            CHECK(os::timestamp::extend(state, [] { return static_cast<uint32_t>(clock64); }) == now);
+            reads_++;
+        }
+    }
+};
+
+ticker ticker_thread;
+
+class main_thread: public os::thread<main_thread, 1024, os::priority::low>
+{
+public:
+    void run(void)
+    {
+        while (done < 4U)
+        {
+            os::delay(10U);
+        }
+        // Dozens of wraps, with reads of the tick hook in between
+        CHECK((clock64 >> 32) >= 20U);
+        CHECK(ticker_thread.reads_ > 100U);
+        exit(0);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(void)
+{
+    os::kernel::initialize();
+    reader0.start("reader0");
+    reader1.start("reader1");
+    reader2.start("reader2");
+    reader3.start("reader3");
+    ticker_thread.start("ticker");
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
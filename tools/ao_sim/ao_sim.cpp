@@ -0,0 +1,156 @@
+/// Host simulation of active objects (src/os/active.h).
+/// usage: ao_sim [samples] [queue timeout in ticks]
+/// A producer thread posts samples to a filter object, which sums blocks of 8 samples and posts
+/// each block to a logger object of lower priority. With timeout 0 the producer never waits and
+/// full queues drop events; otherwise it waits for space. The statistics show throughput, queue
+/// high-water marks and on_event times of both objects (times in virtual time for the
+/// simulator build, where the rate is not meaningful).
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "os.h"
+#include "thread.h"
+#include "active.h"
+
+namespace
+{
+
+uint32_t samples = 100000U;
+uint32_t timeout = os::forever;
+
+struct block_t
+{
+    uint32_t seq;
+    uint32_t sum;
+};
+
+std::atomic<uint32_t> logged;
+std::atomic<uint64_t> checksum;
+
+class logger: public os::active_object<logger, block_t, 16, os::priority::below_normal>
+{
+private:
+    uint32_t next_ = 0U;
+    uint32_t gaps_ = 0U;
+
+public:
+    void on_event(const block_t &_block)
+    {
+        if (_block.seq != next_)
+        {
+            gaps_++;
+        }
+        next_ = _block.seq + 1U;
+        checksum.fetch_add(_block.sum, std::memory_order_relaxed);
+        logged.fetch_add(1U, std::memory_order_release);
+    }
+
+    uint32_t get_gaps(void) const
+    {
+        return gaps_;
+    }
+};
+
+logger logger_object;
+
+class filter: public os::active_object<filter, uint32_t, 32, os::priority::above_normal>
+{
+private:
+    block_t block_ = {};
+    uint32_t fill_ = 0U;
+
+public:
+    void on_start(void)
+    {
+        printf("filter started\n");
+    }
+
+    void on_event(const uint32_t &_sample)
+    {
+        block_.sum += _sample;
+        if (++fill_ == 8U)
+        {
+            logger_object.post(block_, timeout);
+            block_.seq++;
+            block_.sum = 0U;
+            fill_ = 0U;
+        }
+    }
+};
+
+filter filter_object;
+
+void print(const char *_name, const os::active_stats_t &_stats, const double _us)
+{
+    printf("%-8s posted %u, dropped %u, dispatched %u, depth max %u, on_event avg %.2f us, max %.2f us\n", _name,
+           _stats.posted, _stats.dropped, _stats.dispatched, _stats.depth_max,
+           (_stats.dispatched != 0U) ? _stats.time_sum * _us / _stats.dispatched : 0.0, _stats.time_max * _us);
+}
+
+class producer: public os::thread<producer, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        const uint32_t start = os::kernel::get_sys_timer_count();
+        uint64_t expected = 0U;
+        for (uint32_t n = 1U; n <= samples; n++)
+        {
+            if (filter_object.post(n, timeout) == os::sts_t::OK && n <= samples / 8U * 8U)
+            {
+                expected += n;
+            }
+        }
+
+        // Posting is done when the filter has taken everything and the logger caught up
+        while (filter_object.get_count() != 0U || logger_object.get_count() != 0U)
+        {
+            os::delay(1U);
+        }
+        os::delay(2U);
+        const uint32_t time = os::kernel::get_sys_timer_count() - start;
+
+        const double us = 1e6 / os::kernel::get_sys_timer_freq();
+        const os::active_stats_t fs = filter_object.get_stats();
+        const os::active_stats_t ls = logger_object.get_stats();
+        printf("samples  %u, timeout %d\n", samples, static_cast<int32_t>(timeout));
+        print("filter", fs, us);
+        print("logger", ls, us);
+        printf("rate     %.0f events/s (filter and logger events over %.1f ms)\n",
+               (fs.dispatched + ls.dispatched) / (time * us * 1e-6), time * us * 1e-3);
+
+        const bool lossless = fs.dropped == 0U && ls.dropped == 0U;
+        if (lossless && (logged.load() != samples / 8U || checksum.load() != expected || logger_object.get_gaps() != 0U))
+        {
+            printf("Error: %u blocks logged, checksum %llu (expected %llu).\n", logged.load(),
+                   static_cast<unsigned long long>(checksum.load()), static_cast<unsigned long long>(expected));
+            exit(1);
+        }
+        exit(0);
+    }
+};
+
+producer producer_thread;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        samples = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (argc > 2)
+    {
+        timeout = static_cast<uint32_t>(atoi(argv[2]));
+    }
+
+    os::kernel::initialize();
+    logger_object.start("logger");
+    filter_object.start("filter");
+    producer_thread.start("producer");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,172 @@
+/// Host simulation of coroutine tasks (src/os/coro.h).
+/// usage: coro_sim [tasks] [rounds]
+/// Each task runs rounds of: a delay, a child task, a message from a queue, a semaphore token
+/// and an event flag wait with timeout. A producer thread feeds the queue, the semaphore and the
+/// flags. The statistics show how many coroutines shared the few worker threads and frames.
+/// Last, a coroutine waits for a semaphore without a timeout: the timer service must stay asleep.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "os.h"
+#include "thread.h"
+#include "timer_wheel.h"
+#include "coro.h"
+
+namespace
+{
+
+uint32_t tasks = 12U;
+uint32_t rounds = 50U;
+
+enum class ev: uint32_t { tick, count };
+
+os::queue<uint32_t, 8> values __attribute__((section(".bss.os.msgqueue.cb")));
+os::semaphore<64U> tokens;
+os::event_flags<ev> events __attribute__((section(".bss.os.evflags.cb")));
+
+std::atomic<uint32_t> checksum;
+std::atomic<uint32_t> flag_hits;
+std::atomic<uint32_t> flag_timeouts;
+std::atomic<uint32_t> errors;
+
+os::task<uint32_t> square(const uint32_t _x)
+{
+    co_await os::coro::yield();
+    co_return _x * _x;
+}
+
+os::task<void> worker(const uint32_t _id)
+{
+    for (uint32_t r = 0U; r < rounds; r++)
+    {
+        co_await os::coro::delay(1U + (_id + r) % 3U);
+
+        os::task<uint32_t> child = square(r);
+        if (!child || co_await std::move(child) != r * r)
+        {
+            errors.fetch_add(1U);
+        }
+
+        uint32_t value;
+        if (co_await os::coro::get(values, value) != os::sts_t::OK)
+        {
+            errors.fetch_add(1U);
+        }
+        checksum.fetch_add(value, std::memory_order_relaxed);
+
+        if (co_await os::coro::acquire(tokens) != os::sts_t::OK)
+        {
+            errors.fetch_add(1U);
+        }
+
+        const os::flags<ev> f = co_await os::coro::wait_any(events, ev::tick, 2U);
+        (f.has(ev::tick) ? flag_hits : flag_timeouts).fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+
+os::semaphore<1U> idle_sem;
+std::atomic<bool> idle_done;
+
+/// Waits without a timeout: nothing may run until the semaphore is released.
+os::task<void> idle_waiter(void)
+{
+    idle_done.store(co_await os::coro::acquire(idle_sem) == os::sts_t::OK);
+}
+
+class producer: public os::thread<producer, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t n = 1U; n <= tasks * rounds; n++)
+        {
+            values.put(n);
+            while (tokens.release() != os::sts_t::OK)
+            {
+                os::delay(1U);
+            }
+            if (n % 4U == 0U)
+            {
+                events.set(ev::tick);
+            }
+        }
+
+        os::coro::stats_t stats = os::coro::get_stats();
+        while (stats.finished != stats.spawned)
+        {
+            os::delay(1U);
+            stats = os::coro::get_stats();
+        }
+
+        // An idle waiting coroutine does not wake the timer service
+        os::coro::spawn(idle_waiter());
+        os::delay(5U);
+        const uint32_t wakeups = os::timers::get_stats().wakeups;
+        os::delay(50U);
+        const uint32_t idle_wakeups = os::timers::get_stats().wakeups - wakeups;
+        idle_sem.release();
+        stats = os::coro::get_stats();
+        for (uint32_t tick = 0U; stats.finished != stats.spawned && tick < OS_TICK_FREQ; tick++)
+        {
+            os::delay(1U);
+            stats = os::coro::get_stats();
+        }
+
+        const uint32_t total = tasks * rounds;
+        const uint32_t expected = static_cast<uint32_t>(static_cast<uint64_t>(total) * (total + 1U) / 2U);
+        printf("tasks %u x %u rounds on %u workers\n", tasks, rounds, OS_CORO_WORKERS);
+        printf("spawned  %u, finished %u, resumed %u\n", stats.spawned, stats.finished, stats.resumed);
+        printf("frames   %u used, max %u of %u (%u bytes), failed %u\n", stats.frames_used, stats.frames_max,
+               OS_CORO_FRAME_NUM, static_cast<uint32_t>(OS_CORO_FRAME_SIZE), stats.frames_failed);
+        printf("flags    %u hits, %u timeouts\n", flag_hits.load(), flag_timeouts.load());
+        printf("idle     %u timer wake-ups in 50 ticks of waiting\n", idle_wakeups);
+        if (errors.load() != 0U || checksum.load() != expected || stats.frames_used != 0U || idle_wakeups != 0U || !idle_done.load())
+        {
+            printf("Error: %u errors, checksum %u (expected %u), idle waiter %s.\n", errors.load(), checksum.load(), expected,
+                   idle_done.load() ? "done" : "not done");
+            exit(1);
+        }
+        exit(0);
+    }
+};
+
+producer producer_thread;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        tasks = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (argc > 2)
+    {
+        rounds = static_cast<uint32_t>(atoi(argv[2]));
+    }
+    if (tasks == 0U || tasks * 2U > OS_CORO_FRAME_NUM)
+    {
+        fprintf(stderr, "usage: %s [tasks (1-%u)] [rounds]\n", argv[0], OS_CORO_FRAME_NUM / 2U);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    values.create("values");
+    tokens.create("tokens");
+    idle_sem.create("idle");
+    events.create("events");
+    os::coro::start();
+    for (uint32_t i = 0U; i < tasks; i++)
+    {
+        if (os::coro::spawn(worker(i)) != os::sts_t::OK)
+        {
+            fprintf(stderr, "Error: no frame for task %u.\n", i);
+            return 1;
+        }
+    }
+    producer_thread.start("producer");
+    os::kernel::start();
+
+    return 1;
+}
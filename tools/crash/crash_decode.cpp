@@ -0,0 +1,283 @@
+/// Host decoder of hard fault records (src/os/crash.h).
+/// usage: crash_decode <firmware.axf> [record]
+/// The record is either the raw `.bss.noinit` content (e.g. saved with J-Link `savebin`) or the
+/// text printed by os::crash::report (lines starting with "CRSH"), read from stdin when no file is
+/// given. Code addresses are resolved against the function symbols of the ELF image.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "crash.h"
+
+namespace
+{
+
+struct symbol_t
+{
+    uint32_t    addr;
+    uint32_t    size;
+    std::string name;
+};
+
+/// Function symbols of a 32-bit little endian ELF image.
+class elf_t
+{
+    std::vector<uint8_t>  img_;
+    std::vector<symbol_t> sym_;
+
+    uint32_t u16(const uint32_t _off) const
+    {
+        return static_cast<uint32_t>(img_[_off] | (img_[_off + 1U] << 8));
+    }
+    uint32_t u32(const uint32_t _off) const
+    {
+        return u16(_off) | (u16(_off + 2U) << 16);
+    }
+
+public:
+    bool load(const char *_path)
+    {
+        FILE *f = fopen(_path, "rb");
+        if (f == nullptr)
+        {
+            return false;
+        }
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1U, sizeof(chunk), f)) != 0U)
+        {
+            img_.insert(img_.end(), chunk, chunk + n);
+        }
+        fclose(f);
+
+        // ELFCLASS32, ELFDATA2LSB
+        if (img_.size() < 52U || memcmp(img_.data(), "\177ELF", 4U) != 0 || img_[4] != 1U || img_[5] != 1U)
+        {
+            return false;
+        }
+
+        const uint32_t shoff = u32(32U);
+        const uint32_t shentsize = u16(46U);
+        const uint32_t shnum = u16(48U);
+        if (shoff + shnum * shentsize > img_.size())
+        {
+            return false;
+        }
+        for (uint32_t i = 0U; i < shnum; i++)
+        {
+            const uint32_t sh = shoff + i * shentsize;
+            // SHT_SYMTAB, linked to its string table
+            if (u32(sh + 4U) != 2U)
+            {
+                continue;
+            }
+            const uint32_t off = u32(sh + 16U);
+            const uint32_t size = u32(sh + 20U);
+            const uint32_t str = shoff + u32(sh + 24U) * shentsize;
+            const uint32_t str_off = u32(str + 16U);
+            const uint32_t str_size = u32(str + 20U);
+            if (off + size > img_.size() || str_off + str_size > img_.size())
+            {
+                return false;
+            }
+            for (uint32_t s = off; s + 16U <= off + size; s += 16U)
+            {
+                // STT_FUNC
+                if ((img_[s + 12U] & 0x0FU) != 2U || u32(s) >= str_size)
+                {
+                    continue;
+                }
+                const char *name = reinterpret_cast<const char *>(img_.data() + str_off + u32(s));
+                sym_.push_back({u32(s + 4U) & ~1U, u32(s + 8U), std::string(name, strnlen(name, str_size - u32(s)))});
+            }
+        }
+        return true;
+    }
+
+    /// \return "function+offset" or an empty string if the address is not in a function.
+    std::string resolve(const uint32_t _addr) const
+    {
+        const uint32_t addr = _addr & ~1U;
+        for (const symbol_t &s : sym_)
+        {
+            if (addr >= s.addr && addr - s.addr < ((s.size != 0U) ? s.size : 1U))
+            {
+                char off[16];
+                snprintf(off, sizeof(off), "+%#x", addr - s.addr);
+                return s.name + off;
+            }
+        }
+        return std::string();
+    }
+};
+
+/// Read the record from raw binary or from "CRSH" text lines.
+bool read_record(FILE *_f, os::crash::record_t &_rec)
+{
+    std::vector<uint8_t> data;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1U, sizeof(chunk), _f)) != 0U)
+    {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+
+    std::vector<uint32_t> words;
+    if (data.size() >= sizeof(uint32_t) && memcmp(data.data(), &os::crash::magic, sizeof(uint32_t)) == 0)
+    {
+        for (size_t i = 0U; i + 4U <= data.size(); i += 4U)
+        {
+            words.push_back(static_cast<uint32_t>(data[i] | (data[i + 1U] << 8) | (data[i + 2U] << 16) |
+                                                  (static_cast<uint32_t>(data[i + 3U]) << 24)));
+        }
+    }
+    else
+    {
+        data.push_back('\0');
+        const char *line = reinterpret_cast<const char *>(data.data());
+        while ((line = strstr(line, "CRSH")) != nullptr)
+        {
+            char *p = const_cast<char *>(line) + 4;
+            for (;;)
+            {
+                char *end;
+                const unsigned long val = strtoul(p, &end, 16);
+                if (end == p || (*end != ' ' && *end != '\r' && *end != '\n' && *end != '\0'))
+                {
+                    break;
+                }
+                words.push_back(static_cast<uint32_t>(val));
+                p = end;
+            }
+            line = p;
+        }
+    }
+
+    if (words.size() * sizeof(uint32_t) < sizeof(_rec))
+    {
+        return false;
+    }
+    memcpy(&_rec, words.data(), sizeof(_rec));
+    return true;
+}
+
+void print_faults(const os::crash::record_t &_rec)
+{
+    static const struct
+    {
+        uint32_t    mask;
+        const char *text;
+    } cfsr[] =
+    {
+        {1U << 0,  "MemManage: instruction access violation"},
+        {1U << 1,  "MemManage: data access violation"},
+        {1U << 3,  "MemManage: fault on exception return unstacking"},
+        {1U << 4,  "MemManage: fault on exception entry stacking"},
+        {1U << 5,  "MemManage: fault during FP lazy state preservation"},
+        {1U << 8,  "BusFault: instruction bus error"},
+        {1U << 9,  "BusFault: precise data bus error"},
+        {1U << 10, "BusFault: imprecise data bus error"},
+        {1U << 11, "BusFault: fault on exception return unstacking"},
+        {1U << 12, "BusFault: fault on exception entry stacking"},
+        {1U << 13, "BusFault: fault during FP lazy state preservation"},
+        {1U << 16, "UsageFault: undefined instruction"},
+        {1U << 17, "UsageFault: invalid state (Thumb bit / EPSR)"},
+        {1U << 18, "UsageFault: invalid PC load on exception return"},
+        {1U << 19, "UsageFault: no coprocessor"},
+        {1U << 24, "UsageFault: unaligned access"},
+        {1U << 25, "UsageFault: divide by zero"},
+    };
+
+    if ((_rec.hfsr & (1U << 1)) != 0U)
+    {
+        printf("  HardFault: vector table read error\n");
+    }
+    if ((_rec.hfsr & (1U << 30)) != 0U)
+    {
+        printf("  HardFault: escalated from a configurable fault\n");
+    }
+    for (const auto &c : cfsr)
+    {
+        if ((_rec.cfsr & c.mask) != 0U)
+        {
+            printf("  %s\n", c.text);
+        }
+    }
+    if ((_rec.cfsr & (1U << 7)) != 0U)
+    {
+        printf("  MMFAR = 0x%08x\n", _rec.mmfar);
+    }
+    if ((_rec.cfsr & (1U << 15)) != 0U)
+    {
+        printf("  BFAR  = 0x%08x\n", _rec.bfar);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <firmware.axf> [record]\n", argv[0]);
+        return 2;
+    }
+
+    elf_t elf;
+    if (!elf.load(argv[1]))
+    {
+        fprintf(stderr, "Error: '%s' is not a 32-bit little endian ELF file.\n", argv[1]);
+        return 1;
+    }
+
+    FILE *f = (argc > 2) ? fopen(argv[2], "rb") : stdin;
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Error: cannot open '%s'.\n", argv[2]);
+        return 1;
+    }
+
+    os::crash::record_t rec;
+    if (!read_record(f, rec))
+    {
+        fprintf(stderr, "Error: incomplete crash record.\n");
+        return 1;
+    }
+    if (!os::crash::valid(rec))
+    {
+        fprintf(stderr, "Error: invalid crash record (magic 0x%08x, version %u, size %u, checksum 0x%08x/0x%08x).\n",
+                rec.magic, rec.version, rec.size, rec.checksum, os::crash::checksum(rec));
+        return 1;
+    }
+
+    rec.thread_name[sizeof(rec.thread_name) - 1U] = '\0';
+    printf("Hard fault in %s\n", (rec.exc_return & 0x04U) != 0U ? "thread mode (PSP)" : "handler mode or main stack (MSP)");
+    printf("  thread  0x%08x '%s'\n", rec.thread_id, rec.thread_name);
+    printf("  pc      0x%08x %s\n", rec.pc, elf.resolve(rec.pc).c_str());
+    printf("  lr      0x%08x %s\n", rec.lr, elf.resolve(rec.lr).c_str());
+    printf("  sp      0x%08x\n", rec.sp);
+    printf("  psr     0x%08x\n", rec.psr);
+    for (uint32_t i = 0U; i < 13U; i++)
+    {
+        printf("  r%-2u     0x%08x\n", i, rec.r[i]);
+    }
+    printf("  EXC_RETURN 0x%08x, MSP 0x%08x, PSP 0x%08x\n", rec.exc_return, rec.msp, rec.psp);
+    printf("  CFSR 0x%08x, HFSR 0x%08x\n", rec.cfsr, rec.hfsr);
+    print_faults(rec);
+
+    printf("Stack (%u words), code addresses resolved:\n", rec.stack_words);
+    for (uint32_t i = 0U; i < rec.stack_words; i++)
+    {
+        const std::string sym = elf.resolve(rec.stack[i]);
+        if (!sym.empty())
+        {
+            printf("  [sp+%#05x] 0x%08x %s\n", i * 4U, rec.stack[i], sym.c_str());
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/// Host benchmark of the deferred logger (src/dlog/dlog.h) against formatted output.
+/// usage: dlog_bench [records]
+/// Logs the same record with dlog_printf and with snprintf followed by an RTT write (what printf
+/// retargeted to RTT does) and prints the time and the RTT bytes per record of each. Both write to
+/// the dlog up-buffer, which a simulated host drains every few records, so nothing is dropped.
+/// The time is host wall clock time: it compares the two paths, the absolute numbers do not carry
+/// over to the target (and a pointer argument takes two words on a 64-bit host).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "os.h"
+#include "SEGGER_RTT.h"
+#include "RTT_reserve.h"
+#include "dlog.h"
+
+namespace
+{
+
+constexpr uint32_t drain_every = 16U;
+
+uint32_t records = 1000000U;
+
+char sink[4096];
+
+/// Read the up-buffer, as the host does.
+uint32_t drain(void)
+{
+    return SEGGER_RTT_ReadUpBufferNoLock(dlog::channel, sink, sizeof(sink));
+}
+
+const char *const states[] = {"idle", "run", "fault"};
+
+struct result_t
+{
+    double   ns;        ///< Time per record
+    uint64_t bytes;     ///< RTT bytes written
+};
+
+result_t bench_dlog(void)
+{
+    uint64_t bytes = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < records; i++)
+    {
+        dlog_printf("adc %u: %d mV, %s\n", i & 7U, static_cast<int32_t>(i % 3300U), states[i % 3U]);
+        if (i % drain_every == drain_every - 1U)
+        {
+            bytes += drain();
+        }
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+    bytes += drain();
+    return {std::chrono::duration<double, std::nano>(time).count() / records, bytes};
+}
+
+result_t bench_printf(void)
+{
+    uint64_t bytes = 0U;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < records; i++)
+    {
+        char line[64];
+        const int len = snprintf(line, sizeof(line), "adc %u: %d mV, %s\n", i & 7U, static_cast<int32_t>(i % 3300U), states[i % 3U]);
+        rtt::write(dlog::channel, line, static_cast<uint32_t>(len));
+        if (i % drain_every == drain_every - 1U)
+        {
+            bytes += drain();
+        }
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+    bytes += drain();
+    return {std::chrono::duration<double, std::nano>(time).count() / records, bytes};
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        records = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (records == 0U)
+    {
+        fprintf(stderr, "usage: %s [records]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    SEGGER_RTT_Init();
+    dlog::init();
+    drain();
+
+    const result_t text = bench_printf();
+    const result_t bin = bench_dlog();
+
+    printf("%u records\n", records);
+    printf("snprintf + RTT: %7.1f ns/record, %5.1f bytes/record\n", text.ns, static_cast<double>(text.bytes) / records);
+    printf("dlog_printf:    %7.1f ns/record, %5.1f bytes/record, speedup %.1f\n", bin.ns,
+           static_cast<double>(bin.bytes) / records, text.ns / bin.ns);
+
+    constexpr uint32_t record_size = 2U * sizeof(uint32_t) + dlog::arg_size<uint32_t>() + dlog::arg_size<int32_t>() + dlog::arg_size<const char *>();
+    if (dlog::dropped.load() != 0U || bin.bytes != static_cast<uint64_t>(records) * record_size)
+    {
+        printf("Error: %u records dropped.\n", dlog::dropped.load());
+        return 1;
+    }
+    return 0;
+}
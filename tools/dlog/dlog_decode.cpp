@@ -0,0 +1,341 @@
+/// Host decoder of the deferred binary log (src/dlog/dlog.h).
+/// usage: dlog_decode <firmware.axf> [capture.bin]
+/// The capture is the raw content of RTT up-buffer 1 (e.g. JLinkRTTLogger -RTTChannel 1), read from
+/// stdin when no file is given. Format strings and `%s` arguments are looked up in the ELF image.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+enum : uint32_t
+{
+    id_dropped  = 0U,
+    id_sync     = 1U,
+};
+
+/// Loadable section of a 32-bit little endian ELF image.
+struct section_t
+{
+    uint32_t addr;
+    uint32_t size;
+    uint32_t offset;
+};
+
+class elf_t
+{
+    std::vector<uint8_t>   img_;
+    std::vector<section_t> sect_;
+
+    uint32_t u16(const uint32_t _off) const
+    {
+        return static_cast<uint32_t>(img_[_off] | (img_[_off + 1U] << 8));
+    }
+    uint32_t u32(const uint32_t _off) const
+    {
+        return u16(_off) | (u16(_off + 2U) << 16);
+    }
+
+public:
+    bool load(const char *_path)
+    {
+        FILE *f = fopen(_path, "rb");
+        if (f == nullptr)
+        {
+            return false;
+        }
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1U, sizeof(chunk), f)) != 0U)
+        {
+            img_.insert(img_.end(), chunk, chunk + n);
+        }
+        fclose(f);
+
+        // ELFCLASS32, ELFDATA2LSB
+        if (img_.size() < 52U || memcmp(img_.data(), "\177ELF", 4U) != 0 || img_[4] != 1U || img_[5] != 1U)
+        {
+            return false;
+        }
+
+        const uint32_t shoff = u32(32U);
+        const uint32_t shentsize = u16(46U);
+        const uint32_t shnum = u16(48U);
+        for (uint32_t i = 0U; i < shnum; i++)
+        {
+            const uint32_t sh = shoff + i * shentsize;
+            if (sh + 40U > img_.size())
+            {
+                return false;
+            }
+            const uint32_t type = u32(sh + 4U);
+            const uint32_t flags = u32(sh + 8U);
+            // SHT_PROGBITS with SHF_ALLOC
+            if (type == 1U && (flags & 2U) != 0U)
+            {
+                sect_.push_back({u32(sh + 12U), u32(sh + 20U), u32(sh + 16U)});
+            }
+        }
+        return true;
+    }
+
+    /// \return null-terminated string at a target address or nullptr.
+    const char *str(const uint32_t _addr) const
+    {
+        for (const section_t &s : sect_)
+        {
+            if (_addr >= s.addr && _addr - s.addr < s.size)
+            {
+                const uint32_t off = s.offset + (_addr - s.addr);
+                if (memchr(img_.data() + off, '\0', s.size - (_addr - s.addr)) != nullptr)
+                {
+                    return reinterpret_cast<const char *>(img_.data() + off);
+                }
+            }
+        }
+        return nullptr;
+    }
+};
+
+class stream_t
+{
+    FILE *f_;
+
+public:
+    explicit stream_t(FILE *_f): f_(_f) {}
+
+    bool u32(uint32_t &_val)
+    {
+        uint8_t b[4];
+        if (fread(b, 1U, sizeof(b), f_) != sizeof(b))
+        {
+            return false;
+        }
+        _val = static_cast<uint32_t>(b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24));
+        return true;
+    }
+
+    bool u64(uint64_t &_val)
+    {
+        uint32_t lo, hi;
+        if (!u32(lo) || !u32(hi))
+        {
+            return false;
+        }
+        _val = (static_cast<uint64_t>(hi) << 32) | lo;
+        return true;
+    }
+};
+
+/// Rebuild the text of one record. Argument sizes follow from the conversion specifiers
+/// (ILP32 target: `ll`/`j` and floating point take 8 bytes, everything else 4 bytes).
+bool format(const elf_t &_elf, const char *_fmt, stream_t &_in, std::string &_out)
+{
+    const char *p = _fmt;
+    while (*p != '\0')
+    {
+        if (*p != '%')
+        {
+            _out += *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            _out += '%';
+            p += 2;
+            continue;
+        }
+
+        std::string spec = "%";
+        p++;
+        while (*p != '\0' && strchr("-+ #0", *p) != nullptr)
+        {
+            spec += *p++;
+        }
+        for (int part = 0; part < 2; part++)
+        {
+            if (part == 1)
+            {
+                if (*p != '.')
+                {
+                    break;
+                }
+                spec += *p++;
+            }
+            if (*p == '*')
+            {
+                uint32_t val;
+                if (!_in.u32(val))
+                {
+                    return false;
+                }
+                spec += std::to_string(static_cast<int32_t>(val));
+                p++;
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                spec += *p++;
+            }
+        }
+
+        bool wide = false;
+        while (*p != '\0' && strchr("hljztL", *p) != nullptr)
+        {
+            wide = wide || *p == 'j' || (p[0] == 'l' && p[1] == 'l');
+            p += (p[0] == 'l' && p[1] == 'l') ? 2 : 1;
+        }
+
+        const char conv = *p;
+        if (conv == '\0')
+        {
+            break;
+        }
+        p++;
+
+        char txt[256];
+        if (strchr("fFeEgGaA", conv) != nullptr)
+        {
+            uint64_t raw;
+            double val;
+            if (!_in.u64(raw))
+            {
+                return false;
+            }
+            memcpy(&val, &raw, sizeof(val));
+            snprintf(txt, sizeof(txt), (spec + conv).c_str(), val);
+        }
+        else if (wide)
+        {
+            uint64_t val;
+            if (!_in.u64(val))
+            {
+                return false;
+            }
+            snprintf(txt, sizeof(txt), (spec + "ll" + conv).c_str(), static_cast<unsigned long long>(val));
+        }
+        else
+        {
+            uint32_t val;
+            if (!_in.u32(val))
+            {
+                return false;
+            }
+            if (conv == 's')
+            {
+                const char *s = _elf.str(val);
+                if (s != nullptr)
+                {
+                    snprintf(txt, sizeof(txt), (spec + 's').c_str(), s);
+                }
+                else
+                {
+                    snprintf(txt, sizeof(txt), "<%#010x>", val);
+                }
+            }
+            else if (conv == 'p')
+            {
+                snprintf(txt, sizeof(txt), "%#010x", val);
+            }
+            else if (conv == 'c' || conv == 'd' || conv == 'i')
+            {
+                snprintf(txt, sizeof(txt), (spec + conv).c_str(), static_cast<int32_t>(val));
+            }
+            else
+            {
+                snprintf(txt, sizeof(txt), (spec + conv).c_str(), val);
+            }
+        }
+        _out += txt;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <firmware.axf> [capture.bin]\n", argv[0]);
+        return 2;
+    }
+
+    elf_t elf;
+    if (!elf.load(argv[1]))
+    {
+        fprintf(stderr, "Error: '%s' is not a 32-bit little endian ELF file.\n", argv[1]);
+        return 1;
+    }
+
+    FILE *f = (argc > 2) ? fopen(argv[2], "rb") : stdin;
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Error: cannot open '%s'.\n", argv[2]);
+        return 1;
+    }
+
+    stream_t in(f);
+    uint32_t freq = 0U;
+    uint32_t ts_prev = 0U;
+    uint64_t ts_ext = 0U;
+    uint32_t id, ts;
+
+    while (in.u32(id) && in.u32(ts))
+    {
+        ts_ext += static_cast<uint32_t>(ts - ts_prev);
+        ts_prev = ts;
+
+        std::string text;
+        if (id == id_sync)
+        {
+            if (!in.u32(freq))
+            {
+                break;
+            }
+            ts_ext = 0U;
+            text = "-- sync, system timer " + std::to_string(freq) + " Hz --";
+        }
+        else if (id == id_dropped)
+        {
+            uint32_t cnt;
+            if (!in.u32(cnt))
+            {
+                break;
+            }
+            text = "-- " + std::to_string(cnt) + " record(s) dropped --";
+        }
+        else
+        {
+            const char *fmt = elf.str(id);
+            if (fmt == nullptr)
+            {
+                fprintf(stderr, "Error: unknown format string address %#010x, stream out of sync.\n", id);
+                return 1;
+            }
+            if (!format(elf, fmt, in, text))
+            {
+                break;
+            }
+        }
+
+        if (freq != 0U)
+        {
+            printf("[%12.6f] ", static_cast<double>(ts_ext) / freq);
+        }
+        else
+        {
+            printf("[%12u] ", ts);
+        }
+        fputs(text.c_str(), stdout);
+        if (text.empty() || text.back() != '\n')
+        {
+            putchar('\n');
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/// Host simulation of deferred interrupt handling (src/os/isr.h).
+/// usage: isr_sim [bursts] [burst size] [sources]
+/// Each interrupt source is a host thread that posts bursts of work items back to back, as
+/// nested or chained interrupt handlers would, then pauses. The deferred work thread runs on the
+/// POSIX backend; the statistics show queue depth, drops, batching and post-to-run latency.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <atomic>
+
+#include "os.h"
+#include "thread.h"
+#include "isr.h"
+
+namespace
+{
+
+uint32_t bursts = 100U;
+uint32_t burst_size = 32U;
+uint32_t sources = 2U;
+
+std::atomic<uint32_t> done;
+std::atomic<uint32_t> checksum;
+
+void work(const uint32_t _arg)
+{
+    checksum.fetch_add(_arg, std::memory_order_relaxed);
+    done.fetch_add(1U, std::memory_order_relaxed);
+}
+
+/// Interrupt source: not an RTX thread, so it runs in "interrupt context" for the backend.
+void *irq_source(void *_arg)
+{
+    const uint32_t src = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_arg));
+    unsigned int seed = src + 1U;
+
+    for (uint32_t b = 0U; b < bursts; b++)
+    {
+        for (uint32_t i = 0U; i < burst_size; i++)
+        {
+            os::isr::post(work, src * 1000000U + b * burst_size + i);
+        }
+        const timespec pause = {0, static_cast<long>(200000 + rand_r(&seed) % 800000)};
+        nanosleep(&pause, nullptr);
+    }
+    return nullptr;
+}
+
+class monitor: public os::thread<monitor, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        pthread_t irq[8];
+        for (uint32_t i = 0U; i < sources; i++)
+        {
+            pthread_create(&irq[i], nullptr, irq_source, reinterpret_cast<void *>(static_cast<uintptr_t>(i)));
+        }
+        for (uint32_t i = 0U; i < sources; i++)
+        {
+            pthread_join(irq[i], nullptr);
+        }
+
+        os::isr::stats_t stats = os::isr::get_stats();
+        while (done.load() != stats.posted)
+        {
+            os::delay(1U);
+            stats = os::isr::get_stats();
+        }
+
+        uint64_t expected = 0U;
+        for (uint32_t s = 0U; s < sources; s++)
+        {
+            for (uint32_t n = 0U; n < bursts * burst_size; n++)
+            {
+                expected += s * 1000000U + n;
+            }
+        }
+
+        const double us = 1e6 / os::kernel::get_sys_timer_freq();
+        printf("sources %u, bursts %u x %u items, queue %u\n", sources, bursts, burst_size, OS_ISR_DEFERRED_QUEUE_SIZE);
+        printf("posted   %u\n", stats.posted);
+        printf("dropped  %u\n", stats.dropped);
+        printf("executed %u in %u batches (%.1f per batch)\n", stats.executed, stats.batches,
+               (stats.batches != 0U) ? static_cast<double>(stats.executed) / stats.batches : 0.0);
+        printf("depth    max %u\n", stats.depth_max);
+        printf("latency  avg %.1f us, max %.1f us\n", stats.latency_avg() * us, stats.latency_max * us);
+        if (stats.dropped == 0U && static_cast<uint32_t>(expected) != checksum.load())
+        {
+            printf("Error: checksum mismatch.\n");
+            exit(1);
+        }
+        exit(0);
+    }
+};
+
+monitor monitor_thread;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        bursts = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (argc > 2)
+    {
+        burst_size = static_cast<uint32_t>(atoi(argv[2]));
+    }
+    if (argc > 3)
+    {
+        sources = static_cast<uint32_t>(atoi(argv[3]));
+    }
+    if (sources == 0U || sources > 8U)
+    {
+        fprintf(stderr, "usage: %s [bursts] [burst size] [sources (1-8)]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    os::isr::start();
+    monitor_thread.start("monitor");
+    os::kernel::start();
+
+    return 1;
+}
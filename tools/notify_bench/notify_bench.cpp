@@ -0,0 +1,276 @@
+/// Host wake-up latency of direct-to-thread notifications (src/os/notify.h) against semaphores.
+/// usage: notify_bench [rounds]
+/// Two threads wake each other in turns (ping-pong): typed thread flags, a notify::counter, the
+/// lock-free os::semaphore and a plain RTX semaphore object. Prints the time per wake-up from the
+/// round trips, and the percentiles of the one-way latency from the give until the woken thread
+/// runs. The woken thread has the higher priority, so each wake-up is a context switch. Last, one
+/// thread gives and takes in turns, which shows the cost of the calls without the switch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "os.h"
+#include "thread.h"
+#include "sem.h"
+#include "notify.h"
+
+namespace
+{
+
+uint32_t rounds = 100000U;
+
+using host_clock = std::chrono::steady_clock;
+
+/// Time of the last give, read by the woken thread.
+volatile host_clock::rep given;
+
+/// One-way latencies in ns, taken by the woken thread.
+std::vector<double> latencies;
+
+enum class ev: uint32_t { ping, count };
+
+/// Ping side and pong side of the measurement (the pong thread runs the pong side).
+void (*pong)(void);
+
+class ponger: public os::thread<ponger, 2048, os::priority::above_normal>
+{
+public:
+    void run(void)
+    {
+        pong();
+    }
+};
+
+ponger ponger_thread;
+
+void stamp(void)
+{
+    given = host_clock::now().time_since_epoch().count();
+}
+
+void took(void)
+{
+    const host_clock::rep now = host_clock::now().time_since_epoch().count();
+    latencies.push_back(std::chrono::duration<double, std::nano>(host_clock::duration(now - given)).count());
+}
+
+struct flags_path
+{
+    static constexpr const char *name = "flags";
+    static inline osThreadId_t pinger;
+
+    static os::sts_t prepare(void)
+    {
+        pinger = osThreadGetId();
+        return os::sts_t::OK;
+    }
+
+    static void ping(void)
+    {
+        stamp();
+        os::notify::signal(ponger_thread.get_id(), os::flags<ev>(ev::ping));
+        os::notify::wait_any(os::flags<ev>(ev::ping));
+    }
+
+    static void pong(void)
+    {
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            os::notify::wait_any(os::flags<ev>(ev::ping));
+            took();
+            os::notify::signal(pinger, os::flags<ev>(ev::ping));
+        }
+    }
+
+    static bool alone(void)
+    {
+        os::notify::signal(pinger, os::flags<ev>(ev::ping));
+        return os::notify::wait_any(os::flags<ev>(ev::ping), 0U).has(ev::ping);
+    }
+};
+
+template <class _derived>
+struct pair_path
+{
+    static void ping(void)
+    {
+        stamp();
+        _derived::give(_derived::to_pong);
+        _derived::take(_derived::to_ping);
+    }
+
+    static void pong(void)
+    {
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            _derived::take(_derived::to_pong);
+            took();
+            _derived::give(_derived::to_ping);
+        }
+    }
+
+    static bool alone(void)
+    {
+        _derived::give(_derived::to_ping);
+        return _derived::take(_derived::to_ping, 0U);
+    }
+};
+
+struct counter_path: pair_path<counter_path>
+{
+    static constexpr const char *name = "counter";
+    static inline os::notify::counter<1> to_pong;
+    static inline os::notify::counter<1> to_ping;
+
+    static os::sts_t prepare(void)
+    {
+        to_ping.bind(osThreadGetId());
+        to_pong.bind(ponger_thread.get_id());
+        return os::sts_t::OK;
+    }
+
+    static void give(os::notify::counter<1> &_counter)
+    {
+        _counter.give();
+    }
+
+    static bool take(os::notify::counter<1> &_counter, const uint32_t _timeout = os::forever)
+    {
+        return _counter.take(_timeout) == os::sts_t::OK;
+    }
+};
+
+struct semaphore_path: pair_path<semaphore_path>
+{
+    static constexpr const char *name = "semaphore";
+    static inline os::binary_semaphore to_pong;
+    static inline os::binary_semaphore to_ping;
+
+    static os::sts_t prepare(void)
+    {
+        return (to_pong.create("to_pong") == os::sts_t::OK) ? to_ping.create("to_ping") : os::sts_t::err;
+    }
+
+    static void give(os::binary_semaphore &_sem)
+    {
+        _sem.release();
+    }
+
+    static bool take(os::binary_semaphore &_sem, const uint32_t _timeout = os::forever)
+    {
+        return _sem.acquire(_timeout) == os::sts_t::OK;
+    }
+};
+
+struct rtx_path: pair_path<rtx_path>
+{
+    static constexpr const char *name = "osSemaphore";
+    static inline osSemaphoreId_t to_pong;
+    static inline osSemaphoreId_t to_ping;
+
+    static os::sts_t prepare(void)
+    {
+        to_pong = osSemaphoreNew(1U, 0U, nullptr);
+        to_ping = osSemaphoreNew(1U, 0U, nullptr);
+        return (to_pong != nullptr && to_ping != nullptr) ? os::sts_t::OK : os::sts_t::err;
+    }
+
+    static void give(const osSemaphoreId_t _sem)
+    {
+        osSemaphoreRelease(_sem);
+    }
+
+    static bool take(const osSemaphoreId_t _sem, const uint32_t _timeout = os::forever)
+    {
+        return osSemaphoreAcquire(_sem, _timeout) == osOK;
+    }
+};
+
+/// \return false if the path could not be set up.
+template <class P>
+bool measure(void)
+{
+    if (P::prepare() != os::sts_t::OK)
+    {
+        printf("Error: %s not created.\n", P::name);
+        return false;
+    }
+    latencies.clear();
+    latencies.reserve(rounds);
+    pong = P::pong;
+    if (ponger_thread.start("ponger") != os::sts_t::OK)
+    {
+        printf("Error: ponger not started (%s).\n", P::name);
+        return false;
+    }
+    os::delay(1U);
+
+    const auto start = host_clock::now();
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        P::ping();
+    }
+    const double wake = std::chrono::duration<double, std::nano>(host_clock::now() - start).count() / (2U * rounds);
+
+    // The ponger is done once it has answered the last ping; wait until it has ended
+    while (ponger_thread.get_state() != os::tsts_t::err)
+    {
+        os::delay(1U);
+    }
+
+    // Give and take in the same thread: the cost of the calls without a context switch
+    bool ok = latencies.size() == rounds;
+    const auto alone = host_clock::now();
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        ok = P::alone() && ok;
+    }
+    const double pair = std::chrono::duration<double, std::nano>(host_clock::now() - alone).count() / rounds;
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto pct = [](const double _p) { return latencies[static_cast<size_t>(_p * (latencies.size() - 1U))]; };
+    printf("%-11s %9.1f %9.1f %9.1f %10.1f %9.1f\n", P::name, wake, pct(0.5), pct(0.99), latencies.back(), pair);
+    if (!ok)
+    {
+        printf("Error: wake-up lost (%s).\n", P::name);
+    }
+    return ok;
+}
+
+class main_thread: public os::thread<main_thread, 4096, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        printf("%u round trips; times in ns\n", rounds);
+        printf("              wake-up   one-way p50       p99        max  give+take\n");
+        const bool ok = measure<flags_path>() && measure<counter_path>() && measure<semaphore_path>() && measure<rtx_path>();
+        exit(ok ? 0 : 1);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        rounds = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (rounds == 0U)
+    {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,203 @@
+/// Host allocation latency of the block pool (src/os/pool.h) against malloc.
+/// usage: pool_bench [rounds]
+/// Blocks of 64 bytes are allocated and freed by the pool, by the pool through a per-thread cache
+/// of 16 blocks and by malloc/free: as alloc-free pairs, in bursts of 64 blocks freed in random
+/// order, and as pairs from 4 threads at once. For the bursts every allocation is timed alone;
+/// the percentiles include the clock reading (printed as "clock").
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "pool.h"
+
+namespace
+{
+
+constexpr uint32_t burst = 64U;
+constexpr uint32_t threads = 4U;
+
+uint32_t rounds = 200000U;
+
+struct block_t
+{
+    uint8_t data[64];
+};
+
+os::pool<block_t, burst * threads> blk_pool;
+
+struct pool_alloc
+{
+    static constexpr const char *name = "pool";
+
+    void *alloc(void)
+    {
+        return blk_pool.alloc();
+    }
+
+    void free(void *_block)
+    {
+        blk_pool.free(_block);
+    }
+};
+
+struct cache_alloc
+{
+    static constexpr const char *name = "pool+cache";
+
+    os::pool<block_t, burst * threads>::cache<16> cache{blk_pool};
+
+    void *alloc(void)
+    {
+        return cache.alloc();
+    }
+
+    void free(void *_block)
+    {
+        cache.free(_block);
+    }
+};
+
+struct malloc_alloc
+{
+    static constexpr const char *name = "malloc";
+
+    void *alloc(void)
+    {
+        return malloc(sizeof(block_t));
+    }
+
+    void free(void *_block)
+    {
+        ::free(_block);
+    }
+};
+
+using host_clock = std::chrono::steady_clock;
+
+/// Keeps the compiler from dropping an alloc-free pair (it may for malloc).
+void *volatile sink;
+
+double ns_since(const host_clock::time_point _start)
+{
+    return std::chrono::duration<double, std::nano>(host_clock::now() - _start).count();
+}
+
+/// \return ns per alloc-free pair.
+template <class A>
+double pairs(A &_alloc)
+{
+    const auto start = host_clock::now();
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        void *block = _alloc.alloc();
+        static_cast<block_t *>(block)->data[0] = static_cast<uint8_t>(i);
+        sink = block;
+        _alloc.free(block);
+    }
+    return ns_since(start) / rounds;
+}
+
+/// Bursts: every allocation timed alone.
+/// \return sorted allocation times in ns.
+template <class A>
+std::vector<double> bursts(A &_alloc)
+{
+    std::mt19937 rng(1U);
+    std::vector<double> times;
+    times.reserve(rounds);
+    void *held[burst];
+    for (uint32_t i = 0U; i < rounds / burst; i++)
+    {
+        for (void *&block: held)
+        {
+            const auto start = host_clock::now();
+            block = _alloc.alloc();
+            times.push_back(ns_since(start));
+        }
+        std::shuffle(held, held + burst, rng);
+        for (void *block: held)
+        {
+            _alloc.free(block);
+        }
+    }
+    std::sort(times.begin(), times.end());
+    return times;
+}
+
+/// \return host time per alloc-free pair, with all threads allocating at once.
+template <class A>
+double contended(void)
+{
+    const auto start = host_clock::now();
+    std::thread pool[threads];
+    for (std::thread &thread: pool)
+    {
+        thread = std::thread([] { A alloc; pairs(alloc); });
+    }
+    for (std::thread &thread: pool)
+    {
+        thread.join();
+    }
+    return ns_since(start) / (rounds * threads);
+}
+
+template <class A>
+void measure(void)
+{
+    A alloc;
+    const double pair = pairs(alloc);
+    const std::vector<double> times = bursts(alloc);
+    const double shared = contended<A>();
+
+    const auto pct = [&times](const double _p) { return times[static_cast<size_t>(_p * (times.size() - 1U))]; };
+    printf("%-10s %8.1f %8.1f %8.1f %8.1f %10.1f\n", A::name, pair, pct(0.5), pct(0.99), times.back(), shared);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        rounds = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (rounds < burst)
+    {
+        fprintf(stderr, "usage: %s [rounds >= %u]\n", argv[0], burst);
+        return 2;
+    }
+
+    // Clock reading alone
+    std::vector<double> clock(rounds / burst);
+    for (double &time: clock)
+    {
+        const auto start = host_clock::now();
+        time = ns_since(start);
+    }
+    std::sort(clock.begin(), clock.end());
+
+    printf("%u rounds, blocks of %zu bytes, bursts of %u, %u threads; times in ns\n", rounds, sizeof(block_t), burst, threads);
+    printf("               pair burst p50      p99      max  %u threads\n", threads);
+    printf("%-10s %8s %8.1f %8.1f %8.1f\n", "clock", "", clock[clock.size() / 2U], clock[clock.size() * 99U / 100U], clock.back());
+    measure<pool_alloc>();
+    measure<cache_alloc>();
+    measure<malloc_alloc>();
+
+    // Everything came back to the pool
+    uint32_t free_blocks = 0U;
+    while (blk_pool.alloc() != nullptr)
+    {
+        free_blocks++;
+    }
+    if (free_blocks != blk_pool.capacity)
+    {
+        printf("Error: %u of %u blocks returned.\n", free_blocks, blk_pool.capacity);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,243 @@
+/// Host throughput of the zero-copy os::borrow_queue against the copying os::queue (src/os/queue.h).
+/// usage: queue_bench [messages]
+/// A producer thread builds frames of 16, 256 and 1536 bytes and a consumer thread checks them,
+/// through queues of 8 messages. The producer writes the whole frame and the consumer reads it
+/// all, as a driver and a protocol thread would; the copying queue adds a copy on put and on get.
+/// Prints messages and megabytes per second. Between threads the host context switches dominate,
+/// so each path also runs in a single thread that fills and empties the queue in turns: that
+/// shows the cost per message of the queue itself, including the copies.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "os.h"
+#include "thread.h"
+#include "queue.h"
+
+namespace
+{
+
+constexpr uint32_t depth = 8U;
+
+uint32_t messages = 200000U;
+
+template <uint32_t _size>
+struct frame_t
+{
+    uint32_t words[_size / sizeof(uint32_t)];
+
+    void fill(const uint32_t _seq)
+    {
+        for (uint32_t &word: words)
+        {
+            word = _seq;
+        }
+    }
+
+    bool check(const uint32_t _seq) const
+    {
+        uint32_t diff = 0U;
+        for (const uint32_t word: words)
+        {
+            diff |= word ^ _seq;
+        }
+        return diff == 0U;
+    }
+};
+
+/// Producer of the current measurement (one producer thread per measurement).
+void (*produce)(void);
+
+class producer: public os::thread<producer, 4096, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        produce();
+    }
+};
+
+producer producer_thread;
+
+template <uint32_t _size>
+struct copy_path
+{
+    static constexpr const char *name = "copy";
+    static inline os::queue<frame_t<_size>, depth> q;
+
+    static void produce(void)
+    {
+        frame_t<_size> frame;
+        for (uint32_t i = 0U; i < messages; i++)
+        {
+            frame.fill(i);
+            q.put(frame);
+        }
+    }
+
+    static bool consume(void)
+    {
+        frame_t<_size> frame;
+        bool ok = true;
+        for (uint32_t i = 0U; i < messages; i++)
+        {
+            ok = (q.get(frame) == os::sts_t::OK) && frame.check(i) && ok;
+        }
+        return ok;
+    }
+
+    static bool alone(void)
+    {
+        frame_t<_size> frame;
+        bool ok = true;
+        for (uint32_t i = 0U; i < messages; i += depth)
+        {
+            for (uint32_t j = i; j < i + depth; j++)
+            {
+                frame.fill(j);
+                ok = (q.put(frame, 0U) == os::sts_t::OK) && ok;
+            }
+            for (uint32_t j = i; j < i + depth; j++)
+            {
+                ok = (q.get(frame, 0U) == os::sts_t::OK) && frame.check(j) && ok;
+            }
+        }
+        return ok;
+    }
+};
+
+template <uint32_t _size>
+struct borrow_path
+{
+    static constexpr const char *name = "borrow";
+    static inline os::borrow_queue<frame_t<_size>, depth> q;
+
+    static void produce(void)
+    {
+        for (uint32_t i = 0U; i < messages; i++)
+        {
+            frame_t<_size> *frame = q.alloc(os::forever);
+            frame->fill(i);
+            q.send(frame);
+        }
+    }
+
+    static bool consume(void)
+    {
+        bool ok = true;
+        for (uint32_t i = 0U; i < messages; i++)
+        {
+            const auto frame = q.receive();
+            ok = frame && frame->check(i) && ok;
+        }
+        return ok;
+    }
+
+    static bool alone(void)
+    {
+        bool ok = true;
+        for (uint32_t i = 0U; i < messages; i += depth)
+        {
+            for (uint32_t j = i; j < i + depth; j++)
+            {
+                frame_t<_size> *frame = q.alloc(0U);
+                ok = (frame != nullptr) && ok;
+                if (frame != nullptr)
+                {
+                    frame->fill(j);
+                    q.send(frame);
+                }
+            }
+            for (uint32_t j = i; j < i + depth; j++)
+            {
+                const auto frame = q.receive(0U);
+                ok = frame && frame->check(j) && ok;
+            }
+        }
+        return ok;
+    }
+};
+
+/// \return false if the consumer saw a wrong frame.
+template <template <uint32_t> class _path, uint32_t _size>
+bool measure(void)
+{
+    using path = _path<_size>;
+    if (path::q.create(path::name) != os::sts_t::OK)
+    {
+        printf("Error: queue not created (%s).\n", path::name);
+        return false;
+    }
+    produce = path::produce;
+
+    auto start = std::chrono::steady_clock::now();
+    if (producer_thread.start("producer") != os::sts_t::OK)
+    {
+        printf("Error: producer not started (%s).\n", path::name);
+        return false;
+    }
+    bool ok = path::consume();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The producer is done once the consumer has everything; wait until it has ended
+    while (producer_thread.get_state() != os::tsts_t::err)
+    {
+        os::delay(1U);
+    }
+
+    start = std::chrono::steady_clock::now();
+    ok = path::alone() && ok;
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-6s %5u bytes %8.2f Mmsg/s %9.1f MB/s %10.1f ns\n", path::name, _size, messages / sec / 1e6,
+           messages * static_cast<double>(_size) / sec / 1e6, ns / messages);
+    if (!ok)
+    {
+        printf("Error: wrong frame (%s, %u bytes).\n", path::name, _size);
+    }
+    return ok;
+}
+
+template <uint32_t _size>
+bool compare(void)
+{
+    return measure<copy_path, _size>() && measure<borrow_path, _size>();
+}
+
+class main_thread: public os::thread<main_thread, 4096, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        messages = (messages + depth - 1U) / depth * depth;
+        printf("%u messages, queues of %u\n", messages, depth);
+        printf("                   two threads                one thread\n");
+        const bool ok = compare<16>() && compare<256>() && compare<1536>();
+        exit(ok ? 0 : 1);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        messages = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (messages == 0U)
+    {
+        fprintf(stderr, "usage: %s [messages]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,212 @@
+/// Host interrupt-to-thread wake-up latency of os::semaphore (src/os/sem.h) against osSemaphore.
+/// usage: sem_bench [rounds]
+/// An interrupt source (a host thread, so "interrupt context" for the backend) waits until the
+/// thread is blocked on the semaphore, then releases it; the latency runs from the release until
+/// the woken thread runs. Then the source releases and acquires with timeout 0 in turns while
+/// nobody waits, which is the path of an interrupt that only counts an event. On the host
+/// osSemaphoreRelease from an interrupt is a direct call; on RTX it also goes through the ISR
+/// FIFO and the PendSV handler, which os::semaphore skips when no thread waits.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "os.h"
+#include "thread.h"
+#include "sem.h"
+
+namespace
+{
+
+uint32_t rounds = 20000U;
+
+using host_clock = std::chrono::steady_clock;
+
+/// Time of the last release, read by the woken thread.
+std::atomic<host_clock::rep> released;
+
+/// Wake-ups seen by the waiter.
+std::atomic<uint32_t> woken;
+
+/// Wake-up latencies in ns, taken by the waiter.
+std::vector<double> latencies;
+
+struct semaphore_path
+{
+    static constexpr const char *name = "semaphore";
+    static inline os::semaphore<1U> sem;
+
+    static os::sts_t prepare(void)
+    {
+        return sem.create(name);
+    }
+
+    static bool release(void)
+    {
+        return sem.release() == os::sts_t::OK;
+    }
+
+    static bool acquire(const uint32_t _timeout)
+    {
+        return sem.acquire(_timeout) == os::sts_t::OK;
+    }
+};
+
+struct rtx_path
+{
+    static constexpr const char *name = "osSemaphore";
+    static inline osSemaphoreId_t sem;
+
+    static os::sts_t prepare(void)
+    {
+        sem = osSemaphoreNew(1U, 0U, nullptr);
+        return (sem != nullptr) ? os::sts_t::OK : os::sts_t::err;
+    }
+
+    static bool release(void)
+    {
+        return osSemaphoreRelease(sem) == osOK;
+    }
+
+    static bool acquire(const uint32_t _timeout)
+    {
+        return osSemaphoreAcquire(sem, _timeout) == osOK;
+    }
+};
+
+/// Acquire of the current measurement (the waiter thread runs it).
+bool (*acquire)(uint32_t);
+
+class waiter: public os::thread<waiter, 2048, os::priority::above_normal>
+{
+public:
+    void run(void)
+    {
+        for (uint32_t i = 0U; i < rounds; i++)
+        {
+            if (!acquire(os::forever))
+            {
+                return;
+            }
+            const host_clock::rep now = host_clock::now().time_since_epoch().count();
+            latencies.push_back(std::chrono::duration<double, std::nano>(host_clock::duration(now - released.load())).count());
+            woken.store(i + 1U);
+        }
+    }
+};
+
+waiter waiter_thread;
+
+/// Result of the interrupt source.
+struct irq_result_t
+{
+    uint32_t failed;
+    double   pair_ns;
+};
+
+template <class P>
+void *irq_source(void *_result)
+{
+    irq_result_t *result = static_cast<irq_result_t *>(_result);
+    result->failed = 0U;
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        while (osThreadGetState(waiter_thread.get_id()) != osThreadBlocked)
+        {
+            std::this_thread::yield();
+        }
+        released.store(host_clock::now().time_since_epoch().count());
+        result->failed += P::release() ? 0U : 1U;
+        while (woken.load() != i + 1U)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const auto start = host_clock::now();
+    for (uint32_t i = 0U; i < rounds; i++)
+    {
+        result->failed += (P::release() && P::acquire(0U)) ? 0U : 1U;
+    }
+    result->pair_ns = std::chrono::duration<double, std::nano>(host_clock::now() - start).count() / rounds;
+    return nullptr;
+}
+
+/// \return false if a call failed or a wake-up was lost.
+template <class P>
+bool measure(void)
+{
+    if (P::prepare() != os::sts_t::OK)
+    {
+        printf("Error: %s not created.\n", P::name);
+        return false;
+    }
+    latencies.clear();
+    latencies.reserve(rounds);
+    woken.store(0U);
+    acquire = P::acquire;
+    if (waiter_thread.start("waiter") != os::sts_t::OK)
+    {
+        printf("Error: waiter not started (%s).\n", P::name);
+        return false;
+    }
+
+    irq_result_t result;
+    pthread_t irq;
+    pthread_create(&irq, nullptr, irq_source<P>, &result);
+    pthread_join(irq, nullptr);
+    while (waiter_thread.get_state() != os::tsts_t::err)
+    {
+        os::delay(1U);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto pct = [](const double _p) { return latencies[static_cast<size_t>(_p * (latencies.size() - 1U))]; };
+    printf("%-11s %9.1f %9.1f %10.1f %9.1f\n", P::name, pct(0.5), pct(0.99), latencies.back(), result.pair_ns);
+    if (result.failed != 0U || latencies.size() != rounds)
+    {
+        printf("Error: %u calls failed, %zu of %u wake-ups (%s).\n", result.failed, latencies.size(), rounds, P::name);
+        return false;
+    }
+    return true;
+}
+
+class main_thread: public os::thread<main_thread, 4096, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        printf("%u wake-ups from interrupt context; times in ns\n", rounds);
+        printf("             wake p50       p99        max  release+acquire\n");
+        const bool ok = measure<semaphore_path>() && measure<rtx_path>();
+        exit(ok ? 0 : 1);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        rounds = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (rounds == 0U)
+    {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,181 @@
+/// Host throughput of the SPSC ring buffer (src/os/spsc_ring.h).
+/// usage: spsc_bench [items]
+/// A producer and a consumer host thread move 32-bit items through a ring of 1024 elements,
+/// one element per call and in spans of 32, and through the same ring guarded by a mutex as
+/// the locking baseline. Prints millions of items per second of each. With a single host core
+/// the two threads take turns, so the numbers mostly show the cost per operation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "spsc_ring.h"
+
+namespace
+{
+
+constexpr uint32_t batch = 32U;
+
+uint32_t items = 20000000U;
+
+os::spsc_ring<uint32_t, 1024> ring;
+
+/// The ring behind a mutex: what a lock-based queue costs at the same capacity.
+struct locked_ring
+{
+    std::mutex mtx;
+
+    bool push(const uint32_t _val)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return ring.push(_val);
+    }
+
+    bool pop(uint32_t &_val)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return ring.pop(_val);
+    }
+};
+
+locked_ring locked;
+
+/// \return false if the consumer saw a wrong sequence.
+template <class _producer, class _consumer>
+bool run(const char *_name, _producer &&_produce, _consumer &&_consume)
+{
+    bool ok = true;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer(_produce);
+    std::thread consumer([&] { ok = _consume(); });
+    producer.join();
+    consumer.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-14s %8.1f Mitems/s\n", _name, items / sec / 1e6);
+    if (!ok)
+    {
+        printf("Error: wrong sequence (%s).\n", _name);
+    }
+    return ok;
+}
+
+bool single(void)
+{
+    return run("single",
+        []
+        {
+            for (uint32_t i = 0U; i < items;)
+            {
+                i += ring.push(i) ? 1U : (std::this_thread::yield(), 0U);
+            }
+        },
+        []
+        {
+            uint32_t val;
+            for (uint32_t i = 0U; i < items;)
+            {
+                if (!ring.pop(val))
+                {
+                    std::this_thread::yield();
+                }
+                else if (val != i++)
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+}
+
+bool spans(void)
+{
+    return run("span of 32",
+        []
+        {
+            uint32_t buf[batch];
+            for (uint32_t i = 0U; i < items;)
+            {
+                const uint32_t n = (items - i < batch) ? items - i : batch;
+                for (uint32_t k = 0U; k < n; k++)
+                {
+                    buf[k] = i + k;
+                }
+                const uint32_t pushed = ring.push(std::span<const uint32_t>(buf, n));
+                i += pushed;
+                if (pushed == 0U)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        },
+        []
+        {
+            uint32_t buf[batch];
+            for (uint32_t i = 0U; i < items;)
+            {
+                const uint32_t n = ring.pop(std::span<uint32_t>(buf));
+                for (uint32_t k = 0U; k < n; k++)
+                {
+                    if (buf[k] != i++)
+                    {
+                        return false;
+                    }
+                }
+                if (n == 0U)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            return true;
+        });
+}
+
+bool mutex(void)
+{
+    return run("mutex",
+        []
+        {
+            for (uint32_t i = 0U; i < items;)
+            {
+                i += locked.push(i) ? 1U : (std::this_thread::yield(), 0U);
+            }
+        },
+        []
+        {
+            uint32_t val;
+            for (uint32_t i = 0U; i < items;)
+            {
+                if (!locked.pop(val))
+                {
+                    std::this_thread::yield();
+                }
+                else if (val != i++)
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        items = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (items == 0U)
+    {
+        fprintf(stderr, "usage: %s [items]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%u items, ring of %u\n", items, ring.capacity);
+    const bool ok = single() && spans() && mutex();
+    return ok ? 0 : 1;
+}
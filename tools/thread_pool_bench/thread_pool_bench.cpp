@@ -0,0 +1,155 @@
+/// Host scaling run of the work-stealing thread pool (src/os/thread_pool.h).
+/// usage: thread_pool_bench [blocks] [repeats]
+/// Computes the CRC-32 of every 1 KiB block of a buffer with parallel_for on pools of 1, 2, 4 and
+/// 8 workers and prints the time and speedup of each against the single worker. The workers are
+/// host threads in the real-time build, so the speedup follows the number of host cores; the
+/// simulator build runs one thread at a time and only checks the results.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+#include "os.h"
+#include "thread.h"
+#include "thread_pool.h"
+
+namespace
+{
+
+constexpr uint32_t block_size = 1024U;
+
+uint32_t blocks = 4096U;
+uint32_t repeats = 8U;
+
+uint8_t *data;
+uint32_t *crc;
+
+os::thread_pool<1, os::priority::normal, 1024> pool1;
+os::thread_pool<2, os::priority::normal, 1024> pool2;
+os::thread_pool<4, os::priority::normal, 1024> pool4;
+os::thread_pool<8, os::priority::normal, 1024> pool8;
+
+uint32_t crc32(const uint8_t *_data, const uint32_t _size)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    for (uint32_t i = 0U; i < _size; i++)
+    {
+        crc ^= _data[i];
+        for (uint32_t b = 0U; b < 8U; b++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+void crc_range(const uint32_t _begin, const uint32_t _end)
+{
+    for (uint32_t i = _begin; i < _end; i++)
+    {
+        crc[i] = crc32(data + i * block_size, block_size);
+    }
+}
+
+uint32_t combine(void)
+{
+    uint32_t sum = 0U;
+    for (uint32_t i = 0U; i < blocks; i++)
+    {
+        sum = sum * 31U + crc[i];
+    }
+    return sum;
+}
+
+/// \return false if a result is wrong.
+template <class _pool>
+bool measure(_pool &_p, const uint32_t _expected, uint32_t &_time)
+{
+    const uint32_t start = os::kernel::get_sys_timer_count();
+    for (uint32_t r = 0U; r < repeats; r++)
+    {
+        memset(crc, 0, blocks * sizeof(uint32_t));
+        _p.parallel_for(0U, blocks, [](const uint32_t _begin, const uint32_t _end) { crc_range(_begin, _end); });
+        if (combine() != _expected)
+        {
+            return false;
+        }
+    }
+    _time = os::kernel::get_sys_timer_count() - start;
+    return true;
+}
+
+template <class _pool>
+bool report(_pool &_p, const uint32_t _expected, uint32_t &_base)
+{
+    uint32_t time;
+    if (!measure(_p, _expected, time))
+    {
+        printf("Error: wrong result with %u workers.\n", _p.size);
+        return false;
+    }
+    if (_p.size == 1U)
+    {
+        _base = time;
+    }
+    const os::thread_pool_stats_t stats = _p.get_stats();
+    printf("%u workers: %8.2f ms, speedup %.2f, chunks %u, splits %u, steals %u, inlined %u\n", _p.size,
+           time * 1e3 / os::kernel::get_sys_timer_freq(), (time != 0U) ? static_cast<double>(_base) / time : 1.0,
+           stats.chunks, stats.splits, stats.steals, stats.inlined);
+    return true;
+}
+
+class bench: public os::thread<bench, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        crc_range(0U, blocks);
+        const uint32_t expected = combine();
+
+        printf("%u blocks of %u bytes, %u repeats\n", blocks, block_size, repeats);
+        uint32_t base = 0U;
+        const bool ok = report(pool1, expected, base) && report(pool2, expected, base) &&
+                        report(pool4, expected, base) && report(pool8, expected, base);
+        exit(ok ? 0 : 1);
+    }
+};
+
+bench bench_thread;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        blocks = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (argc > 2)
+    {
+        repeats = static_cast<uint32_t>(atoi(argv[2]));
+    }
+    if (blocks == 0U || repeats == 0U)
+    {
+        fprintf(stderr, "usage: %s [blocks] [repeats]\n", argv[0]);
+        return 2;
+    }
+
+    data = static_cast<uint8_t *>(malloc(blocks * block_size));
+    crc = static_cast<uint32_t *>(malloc(blocks * sizeof(uint32_t)));
+    for (uint32_t i = 0U; i < blocks * block_size; i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 2654435761U >> 24);
+    }
+
+    os::kernel::initialize();
+    pool1.start("pool1");
+    pool2.start("pool2");
+    pool4.start("pool4");
+    pool8.start("pool8");
+    bench_thread.start("bench");
+    os::kernel::start();
+
+    return 1;
+}
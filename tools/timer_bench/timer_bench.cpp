@@ -0,0 +1,172 @@
+/// Host benchmark of the timer wheel service (src/os/timer_wheel.h) against RTX timers (osTimerNew).
+/// usage: timer_bench [timers]
+/// Like the timeouts of a protocol stack, every timer is started with a random timeout of up to
+/// a minute, restarted once in random order (a retransmission) and stopped in random order (the
+/// answer came in). Prints the host time per start, restart and stop. A last round starts all
+/// timers with timeouts of up to 20 ticks and checks that every callback comes. The RTX timers
+/// are those of the host backend, which keeps the running timers in a sorted list as RTX does.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "os.h"
+#include "thread.h"
+#include "timer_wheel.h"
+
+namespace
+{
+
+uint32_t timers = 10000U;
+
+std::atomic<uint32_t> fired;
+
+void expired(void *)
+{
+    fired.fetch_add(1U, std::memory_order_relaxed);
+}
+
+/// Timer service under test: the wheel or RTX timers.
+struct wheel_timers
+{
+    static constexpr const char *name = "wheel";
+
+    os::wheel_timer_t *timer;
+
+    wheel_timers(): timer(static_cast<os::wheel_timer_t *>(malloc(timers * sizeof(os::wheel_timer_t))))
+    {
+        for (uint32_t i = 0U; i < timers; i++)
+        {
+            new (&timer[i]) os::wheel_timer_t(expired);
+        }
+    }
+
+    bool start(const uint32_t _idx, const uint32_t _ticks)
+    {
+        return os::timers::start(timer[_idx], _ticks) == os::sts_t::OK;
+    }
+
+    bool stop(const uint32_t _idx)
+    {
+        return os::timers::stop(timer[_idx]) == os::sts_t::OK;
+    }
+};
+
+struct rtx_timers
+{
+    static constexpr const char *name = "osTimer";
+
+    std::vector<osTimerId_t> timer;
+
+    rtx_timers(): timer(timers)
+    {
+        for (osTimerId_t &id: timer)
+        {
+            id = osTimerNew(expired, osTimerOnce, nullptr, nullptr);
+        }
+    }
+
+    bool start(const uint32_t _idx, const uint32_t _ticks)
+    {
+        return osTimerStart(timer[_idx], _ticks) == osOK;
+    }
+
+    bool stop(const uint32_t _idx)
+    {
+        return osTimerStop(timer[_idx]) == osOK;
+    }
+};
+
+/// \return host time per call in ns.
+template <class F>
+double measure(F &&_func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0U; i < timers; i++)
+    {
+        _func(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / timers;
+}
+
+/// \return false if a call failed or a callback is missing.
+template <class S>
+bool run(void)
+{
+    S service;
+    std::mt19937 rng(1U);
+    std::vector<uint32_t> order(timers);
+    for (uint32_t i = 0U; i < timers; i++)
+    {
+        order[i] = i;
+    }
+
+    uint32_t failed = 0U;
+    const double start = measure([&](const uint32_t _i) { failed += service.start(_i, 1000U + rng() % 60000U) ? 0U : 1U; });
+    std::shuffle(order.begin(), order.end(), rng);
+    const double restart = measure([&](const uint32_t _i) { failed += service.start(order[_i], 1000U + rng() % 60000U) ? 0U : 1U; });
+    std::shuffle(order.begin(), order.end(), rng);
+    const double stop = measure([&](const uint32_t _i) { failed += service.stop(order[_i]) ? 0U : 1U; });
+
+    // Expiry: all callbacks come within the longest timeout and a few ticks of latency
+    fired.store(0U);
+    const uint32_t begin = os::kernel::get_tick_count();
+    for (uint32_t i = 0U; i < timers; i++)
+    {
+        failed += service.start(i, 1U + i % 20U) ? 0U : 1U;
+    }
+    while (fired.load() != timers && os::kernel::get_tick_count() - begin < 2000U)
+    {
+        os::delay(1U);
+    }
+    const uint32_t ticks = os::kernel::get_tick_count() - begin;
+
+    printf("%-8s %9.1f %11.1f %8.1f %9u %6u\n", S::name, start, restart, stop, fired.load(), ticks);
+    if (failed != 0U || fired.load() != timers)
+    {
+        printf("Error: %u calls failed, %u of %u callbacks (%s).\n", failed, fired.load(), timers, S::name);
+        return false;
+    }
+    return true;
+}
+
+class main_thread: public os::thread<main_thread, 4096, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        printf("%u timers\n", timers);
+        printf("         start ns  restart ns  stop ns   expired  ticks\n");
+        const bool ok = ::run<wheel_timers>() && ::run<rtx_timers>();
+        exit(ok ? 0 : 1);
+    }
+};
+
+main_thread main_thread_obj;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        timers = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (timers == 0U)
+    {
+        fprintf(stderr, "usage: %s [timers]\n", argv[0]);
+        return 2;
+    }
+
+    os::kernel::initialize();
+    os::timers::start();
+    main_thread_obj.start("main");
+    os::kernel::start();
+
+    return 1;
+}
@@ -0,0 +1,262 @@
+/// Host fan-out run of the publish/subscribe topic (src/os/topic.h).
+/// usage: topic_sim [frames] [policy: block | oldest | newest]
+/// A publisher thread publishes 256-byte frames to 1, 2, 4, 8 and 16 subscribers, each received
+/// by its own thread. Every frame is copied once into a slot; the subscribers get references.
+/// The table shows frames and deliveries per second and the drops of the overflow policy (rates
+/// are in virtual time for the simulator build). Last, subscribers come and go while frames are
+/// published, and every slot must be free afterwards.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <tuple>
+#include <utility>
+
+#include "os.h"
+#include "thread.h"
+#include "topic.h"
+
+namespace
+{
+
+constexpr uint32_t subs_max = 16U;
+
+struct frame_t
+{
+    uint32_t seq;
+    uint32_t sum;
+    uint8_t  data[248];
+};
+
+uint32_t frames = 20000U;
+os::overflow policy = os::overflow::block;
+
+os::topic<frame_t, 32, subs_max, 8> sensor;
+decltype(sensor)::subscriber subs[subs_max];
+
+std::atomic<uint32_t> consumed;
+std::atomic<uint32_t> errors;
+
+template <uint32_t _idx>
+class consumer: public os::thread<consumer<_idx>, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        for (;;)
+        {
+            const auto msg = subs[_idx].receive();
+            if (!msg)
+            {
+                // Not subscribed yet
+                os::delay(1U);
+                continue;
+            }
+            uint32_t sum = 0U;
+            for (const uint8_t b: msg->data)
+            {
+                sum += b;
+            }
+            if (sum != msg->sum)
+            {
+                errors.fetch_add(1U, std::memory_order_relaxed);
+            }
+            consumed.fetch_add(1U, std::memory_order_release);
+        }
+    }
+};
+
+template <class>
+struct consumer_set;
+
+template <uint32_t... _idx>
+struct consumer_set<std::integer_sequence<uint32_t, _idx...>>
+{
+    std::tuple<consumer<_idx>...> threads;
+
+    void start(void)
+    {
+        (std::get<_idx>(threads).start("consumer"), ...);
+    }
+};
+
+consumer_set<std::make_integer_sequence<uint32_t, subs_max>> consumers;
+
+std::atomic<bool> flooding;
+
+/// Publishes with timeout 0 (as an interrupt would) while subscribers come and go.
+class flood: public os::thread<flood, 1024, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        while (flooding.load())
+        {
+            for (uint32_t i = 0U; i < 4U; i++)
+            {
+                frame_t *frame = sensor.loan();
+                if (frame != nullptr)
+                {
+                    frame->sum = 0U;
+                    memset(frame->data, 0, sizeof(frame->data));
+                    sensor.publish(frame, 0U);
+                }
+            }
+            os::delay(1U);
+        }
+    }
+};
+
+flood flood_thread;
+
+class publisher: public os::thread<publisher, 2048, os::priority::normal>
+{
+public:
+    void run(void)
+    {
+        printf("%u frames of %u bytes, policy %s\n", frames, static_cast<uint32_t>(sizeof(frame_t)),
+               (policy == os::overflow::block) ? "block" : (policy == os::overflow::drop_oldest) ? "drop oldest" : "drop newest");
+        printf("subs  frames/s     deliveries/s  dropped  exhausted\n");
+
+        uint32_t exhausted = 0U;
+        for (uint32_t n = 1U; n <= subs_max; n *= 2U)
+        {
+            uint32_t dropped = 0U;
+            for (uint32_t i = 0U; i < n; i++)
+            {
+                dropped -= subs[i].get_stats().dropped;
+                sensor.subscribe(subs[i], policy);
+            }
+            consumed.store(0U);
+
+            const uint32_t start = os::kernel::get_sys_timer_count();
+            uint32_t delivered = 0U;
+            for (uint32_t f = 0U; f < frames; f++)
+            {
+                frame_t *frame = sensor.loan();
+                while (frame == nullptr)
+                {
+                    os::delay(1U);
+                    frame = sensor.loan();
+                }
+                frame->seq = f;
+                frame->sum = 0U;
+                for (uint32_t i = 0U; i < sizeof(frame->data); i++)
+                {
+                    frame->data[i] = static_cast<uint8_t>(f + i);
+                    frame->sum += frame->data[i];
+                }
+                delivered += sensor.publish(frame);
+            }
+            // Evicted frames (drop oldest) are delivered but never consumed, so wait for the queues
+            for (uint32_t i = 0U; i < n; i++)
+            {
+                while (subs[i].get_count() != 0U)
+                {
+                    os::delay(1U);
+                }
+            }
+            while (policy == os::overflow::block && consumed.load(std::memory_order_acquire) < delivered)
+            {
+                os::delay(1U);
+            }
+            const uint32_t time = os::kernel::get_sys_timer_count() - start;
+
+            for (uint32_t i = 0U; i < n; i++)
+            {
+                sensor.unsubscribe(subs[i]);
+                dropped += subs[i].get_stats().dropped;
+            }
+
+            const os::topic_stats_t stats = sensor.get_stats();
+            const double sec = static_cast<double>(time) / os::kernel::get_sys_timer_freq();
+            printf("%4u  %-11.0f  %-12.0f  %-7u  %u\n", n, (sec > 0.0) ? frames / sec : 0.0,
+                   (sec > 0.0) ? delivered / sec : 0.0, dropped, stats.exhausted - exhausted);
+            exhausted = stats.exhausted;
+
+            if (policy == os::overflow::block && delivered != frames * n)
+            {
+                printf("Error: %u of %u frames delivered.\n", delivered, frames * n);
+                exit(1);
+            }
+        }
+
+        if (errors.load() != 0U)
+        {
+            printf("Error: %u corrupted frames.\n", errors.load());
+            exit(1);
+        }
+
+        // Subscribe and unsubscribe while another thread publishes: nothing may be queued to a
+        // subscriber after unsubscribe, or its slot would never be released
+        flooding.store(true);
+        flood_thread.start("flood");
+        for (uint32_t r = 0U; r < 1000U; r++)
+        {
+            sensor.subscribe(subs[r % subs_max], policy);
+            if ((r % 2U) != 0U)
+            {
+                os::delay(1U);
+            }
+            sensor.unsubscribe(subs[r % subs_max]);
+        }
+        flooding.store(false);
+        while (flood_thread.get_state() != os::tsts_t::err)
+        {
+            os::delay(1U);
+        }
+
+        // Every reference is dropped, so every slot must be free again
+        frame_t *loans[sensor.capacity];
+        for (frame_t *&frame: loans)
+        {
+            frame = sensor.loan();
+            if (frame == nullptr)
+            {
+                printf("Error: message slots leaked.\n");
+                exit(1);
+            }
+        }
+        for (frame_t *frame: loans)
+        {
+            sensor.discard(frame);
+        }
+        exit(0);
+    }
+};
+
+publisher publisher_thread;
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        frames = static_cast<uint32_t>(atoi(argv[1]));
+    }
+    if (argc > 2)
+    {
+        if (strcmp(argv[2], "oldest") == 0)
+        {
+            policy = os::overflow::drop_oldest;
+        }
+        else if (strcmp(argv[2], "newest") == 0)
+        {
+            policy = os::overflow::drop_newest;
+        }
+        else if (strcmp(argv[2], "block") != 0)
+        {
+            fprintf(stderr, "usage: %s [frames] [block | oldest | newest]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    os::kernel::initialize();
+    consumers.start();
+    publisher_thread.start("publisher");
+    os::kernel::start();
+
+    return 1;
+}